@@ -0,0 +1,38 @@
+# Run as a script: cmake -DSOURCES=<files> -DOUTPUT=<file> -P EmbedCorpus.cmake
+#
+# Writes OUTPUT, a C++ source defining pascal::grammar::warmup_corpus() with
+# the text of every file in SOURCES, in order. The file is only rewritten
+# when its contents change, so unchanged sources do not trigger a rebuild.
+
+set(delimiter "corpus")
+set(entries "")
+foreach(source IN LISTS SOURCES)
+  file(READ ${source} text)
+  string(FIND "${text}" ")${delimiter}\"" clash)
+  if(NOT clash EQUAL -1)
+    message(FATAL_ERROR "${source} contains the raw string delimiter")
+  endif()
+  get_filename_component(name ${source} NAME)
+  string(APPEND entries "      {\"${name}\", R\"${delimiter}(${text})${delimiter}\"},\n")
+endforeach()
+
+file(
+  WRITE ${OUTPUT}.tmp
+  "// Generated by cmake/EmbedCorpus.cmake. Do not edit.\n"
+  "#include <WarmupCorpus.hpp>\n"
+  "\n"
+  "namespace pascal::grammar {\n"
+  "\n"
+  "const std::vector<WarmupSource>& warmup_corpus() {\n"
+  "  static const std::vector<WarmupSource> corpus = {\n"
+  "${entries}"
+  "  };\n"
+  "  return corpus;\n"
+  "}\n"
+  "\n"
+  "}  // namespace pascal::grammar\n"
+)
+execute_process(
+  COMMAND ${CMAKE_COMMAND} -E copy_if_different ${OUTPUT}.tmp ${OUTPUT}
+)
+file(REMOVE ${OUTPUT}.tmp)
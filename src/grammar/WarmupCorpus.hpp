@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+namespace pascal::grammar {
+
+struct WarmupSource {
+  std::string_view name_;
+  std::string_view text_;
+};
+
+// Programs that between them take the parser through most of its decisions:
+// warmup.pas first, then the examples. Embedded at build time by
+// cmake/EmbedCorpus.cmake.
+const std::vector<WarmupSource>& warmup_corpus();
+
+}  // namespace pascal::grammar
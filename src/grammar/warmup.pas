@@ -0,0 +1,28 @@
+program warmup;
+const
+  n = 10;
+  greeting = 'hello';
+var
+  i, sum : integer;
+  ch : char;
+  text : string;
+  values : array[1..10] of integer;
+begin
+  i := 1;
+  sum := 0;
+  while (i <= n) do
+    begin
+    values[i] := (i * 2 + 1) mod 7 - i div 3;
+    sum += values[i];
+    i += 1;
+    end;
+  if (sum <> 0) then
+    writeln('sum: ', sum)
+  else
+    write(greeting);
+  ch := 'x';
+  text := greeting;
+  text += ch;
+  text[1] := ch;
+  readln(i);
+end.
@@ -0,0 +1,266 @@
+#include <libpas/allocations.hpp>
+#include <libpas/ast/Ast.hpp>
+#include <libpas/ast/FlatAst.hpp>
+#include <libpas/ast/SemanticAnalysier.hpp>
+#include <libpas/ast/detail/Builder.hpp>
+#include <libpas/descent_parser.hpp>
+#include <libpas/input_stream.hpp>
+
+#include <PascalLexer.h>
+#include <PascalParser.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace pascal::bench {
+
+namespace {
+
+// The layout ast::Program had before its arena: one heap object per node,
+// each owned by a unique_ptr.
+class HeapNodes {
+ public:
+  template <class T, class... Args>
+  T* create_node(Args&&... args) {
+    nodes_.push_back(std::make_unique<T>(std::forward<Args>(args)...));
+    return static_cast<T*>(nodes_.back().get());
+  }
+
+ private:
+  std::vector<std::unique_ptr<ast::Member>> nodes_;
+};
+
+// The symbols of the nodes `build` makes, which HeapNodes has nowhere to
+// keep.
+ast::Interner& symbols() {
+  static ast::Interner interner;
+  return interner;
+}
+
+// `statements` statements alternating between `x := a + b * 3` and
+// `writeln(x)`, 17 nodes per pair, in the order a parser creates them.
+template <class Nodes>
+ast::Block* build(Nodes& nodes, size_t statements) {
+  auto& interner = symbols();
+  const auto x = interner.intern("x");
+  const auto a = interner.intern("a");
+  const auto b = interner.intern("b");
+  const auto three = interner.intern("3");
+  const auto plus = ast::Interner::fixed("+");
+  const auto star = ast::Interner::fixed("*");
+  const auto assign = ast::Interner::fixed(":=");
+  const auto writeln = ast::Interner::fixed("writeln");
+
+  const auto atom = [&nodes](ast::Value* value) {
+    return nodes.template create_node<ast::Expression>(
+        nullptr,
+        nullptr,
+        nullptr,
+        ast::Expression::Signs{},
+        value,
+        false);
+  };
+  const auto binary =
+      [&nodes](ast::Expression* lhs, ast::SymbolId op, ast::Expression* rhs) {
+        return nodes.template create_node<ast::Expression>(
+            lhs,
+            nodes.template create_node<ast::Operation>(op),
+            rhs,
+            ast::Expression::Signs{},
+            nullptr,
+            false);
+      };
+
+  ast::Block::Components components;
+  components.reserve(statements);
+  for (size_t i = 0; i < statements; ++i) {
+    if (i % 2 == 0) {
+      auto* varname = nodes.template create_node<ast::Id>(x);
+      auto* modification =
+          nodes.template create_node<ast::Modification>(assign);
+      auto* a_atom = atom(nodes.template create_node<ast::Id>(a));
+      auto* b_atom = atom(nodes.template create_node<ast::Id>(b));
+      auto* three_atom = atom(nodes.template create_node<ast::Int>(three));
+      auto* value = binary(a_atom, plus, binary(b_atom, star, three_atom));
+      components.push_back(nodes.template create_node<ast::Assignment>(
+          nullptr, varname, modification, value));
+    } else {
+      auto* name = nodes.template create_node<ast::Functionname>(writeln);
+      auto* argument = atom(nodes.template create_node<ast::Id>(x));
+      components.push_back(nodes.template create_node<ast::Functioncall>(
+          name,
+          ast::Functioncall::Variables{},
+          ast::Functioncall::Arguments{argument}));
+    }
+  }
+  return nodes.template create_node<ast::Block>(std::move(components));
+}
+
+// The source of the statements `build` makes, with their variables
+// declared.
+std::string source(size_t statements) {
+  std::string text = "program p;\nvar x, a, b: integer;\nbegin\n";
+  for (size_t i = 0; i < statements; ++i) {
+    text += i % 2 == 0 ? "x := a + b * 3;\n" : "writeln(x);\n";
+  }
+  text += "end.\n";
+  return text;
+}
+
+size_t length(ast::SymbolId symbol) {
+  return symbols().text(symbol).size();
+}
+
+size_t walk(ast::Expression* expression) {
+  if (expression->atom() != nullptr) {
+    return length(expression->atom()->symbol());
+  }
+  return length(expression->operation()->symbol()) +
+      walk(expression->lhs()) + walk(expression->rhs());
+}
+
+// Reads every node, as a pass over the tree does.
+size_t walk(ast::Block* block) {
+  size_t size = 0;
+  const auto& components = block->components();
+  for (size_t i = 0; i < components.size(); ++i) {
+    if (i % 2 == 0) {
+      auto* assignment = static_cast<ast::Assignment*>(components[i]);
+      size += length(assignment->varname()->symbol()) +
+          length(assignment->modification()->symbol()) +
+          walk(assignment->expression());
+    } else {
+      auto* call = static_cast<ast::Functioncall*>(components[i]);
+      size += length(call->functionname()->symbol());
+      for (auto* argument : call->arguments()) {
+        size += walk(argument);
+      }
+    }
+  }
+  return size;
+}
+
+// Building includes tearing the tree down, which is where the arena saves
+// the most: its nodes go away a chunk at a time.
+template <class Nodes>
+void build_and_destroy(benchmark::State& state) {
+  const auto statements = static_cast<size_t>(state.range(0));
+  uint64_t allocations = 0;
+  for (auto _ : state) {
+    const auto before = allocation_count();
+    {
+      Nodes nodes;
+      benchmark::DoNotOptimize(build(nodes, statements));
+    }
+    allocations = allocation_count() - before;
+  }
+  state.counters["allocations"] = static_cast<double>(allocations);
+  state.SetItemsProcessed(
+      state.iterations() * static_cast<int64_t>(statements));
+}
+
+// The same statements built by ast::detail::Builder from PascalParser's
+// parse tree, which is made once. Beyond build_and_destroy<ast::Program>'s
+// allocations, the builder should add none per node.
+void build_from_parse_tree(benchmark::State& state) {
+  const auto statements = static_cast<size_t>(state.range(0));
+  const auto text = source(statements);
+  ByteStream input(text);
+  PascalLexer lexer(&input);
+  antlr4::CommonTokenStream tokens(&lexer);
+  PascalParser parser(&tokens);
+  auto* tree = parser.program();
+  uint64_t allocations = 0;
+  for (auto _ : state) {
+    const auto before = allocation_count();
+    {
+      ast::Program program;
+      ast::detail::Builder builder(program);
+      builder.build(tree);
+      benchmark::DoNotOptimize(program.get_block());
+    }
+    allocations = allocation_count() - before;
+  }
+  state.counters["allocations"] = static_cast<double>(allocations);
+  state.SetItemsProcessed(
+      state.iterations() * static_cast<int64_t>(statements));
+}
+
+template <class Nodes>
+void traverse(benchmark::State& state) {
+  const auto statements = static_cast<size_t>(state.range(0));
+  Nodes nodes;
+  auto* block = build(nodes, statements);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(walk(block));
+  }
+  state.SetItemsProcessed(
+      state.iterations() * static_cast<int64_t>(statements));
+}
+
+// SemanticAnalysier over the tree the statements parse into, then over its
+// FlatAst, whose arrays the pass reads front to back.
+void analyse_tree(benchmark::State& state) {
+  const auto text = source(static_cast<size_t>(state.range(0)));
+  auto program = DescentParser(text).parse();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ast::SemanticAnalysier::exec(*program));
+  }
+  state.SetItemsProcessed(
+      state.iterations() * static_cast<int64_t>(program->node_count()));
+}
+
+void analyse_flat(benchmark::State& state) {
+  const auto text = source(static_cast<size_t>(state.range(0)));
+  auto program = DescentParser(text).parse();
+  auto flat_ast = ast::FlatAst::flatten(*program);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ast::SemanticAnalysier::exec(flat_ast));
+  }
+  state.SetItemsProcessed(
+      state.iterations() * static_cast<int64_t>(flat_ast.size()));
+}
+
+void flatten(benchmark::State& state) {
+  const auto text = source(static_cast<size_t>(state.range(0)));
+  auto program = DescentParser(text).parse();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ast::FlatAst::flatten(*program));
+  }
+  state.SetItemsProcessed(
+      state.iterations() * static_cast<int64_t>(program->node_count()));
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(build_and_destroy, ast::Program)
+    ->RangeMultiplier(16)
+    ->Range(1 << 8, 1 << 20);
+BENCHMARK_TEMPLATE(build_and_destroy, HeapNodes)
+    ->RangeMultiplier(16)
+    ->Range(1 << 8, 1 << 20);
+BENCHMARK(build_from_parse_tree)
+    ->RangeMultiplier(16)
+    ->Range(1 << 8, 1 << 20);
+BENCHMARK_TEMPLATE(traverse, ast::Program)
+    ->RangeMultiplier(16)
+    ->Range(1 << 8, 1 << 20);
+BENCHMARK_TEMPLATE(traverse, HeapNodes)
+    ->RangeMultiplier(16)
+    ->Range(1 << 8, 1 << 20);
+BENCHMARK(analyse_tree)
+    ->RangeMultiplier(16)
+    ->Range(1 << 8, 1 << 20);
+BENCHMARK(analyse_flat)
+    ->RangeMultiplier(16)
+    ->Range(1 << 8, 1 << 20);
+BENCHMARK(flatten)
+    ->RangeMultiplier(16)
+    ->Range(1 << 8, 1 << 20);
+
+}  // namespace pascal::bench
@@ -0,0 +1,86 @@
+#include <libpas/compiler.hpp>
+#include <libpas/descent_parser.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <llvm/IR/LLVMContext.h>
+
+#include <cstdint>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace pascal::bench {
+
+namespace {
+
+// One assignment whose right-hand side has `terms` operands, mixing both
+// precedence levels so that grouping matters. The tree walks recurse once
+// per operation, which bounds `terms` by the stack size.
+std::string make_program(size_t terms) {
+  constexpr std::string_view operations[] = {
+      " + a * 3", " - a div 2", " + a mod 5", " - a"};
+  std::string program = "program bench;\nvar\n    a, b: integer;\nbegin\n";
+  program += "    a := 7;\n    b := a";
+  for (size_t i = 1; i < terms; ++i) {
+    program += operations[i % std::size(operations)];
+  }
+  program += ";\n    writeln(b);\nend.\n";
+  return program;
+}
+
+ast::Program parse_program(const std::string& text) {
+  DescentParser parser(text);
+  return std::move(parse(parser).program_);
+}
+
+void compile_expression(benchmark::State& state) {
+  const auto terms = static_cast<size_t>(state.range(0));
+  const auto text = make_program(terms);
+  for (auto _ : state) {
+    auto program = parse_program(text);
+    ast::SymbolTable symbol_table;
+    std::ostringstream errors;
+    if (!semantic_analyse(program, symbol_table, errors)) {
+      state.SkipWithError(errors.str().c_str());
+      return;
+    }
+    llvm::LLVMContext context;
+    benchmark::DoNotOptimize(
+        code_generate(program, symbol_table, context));
+  }
+  state.SetComplexityN(static_cast<int64_t>(terms));
+}
+
+void generate_expression(benchmark::State& state) {
+  const auto terms = static_cast<size_t>(state.range(0));
+  auto program = parse_program(make_program(terms));
+  ast::SymbolTable symbol_table;
+  std::ostringstream errors;
+  if (!semantic_analyse(program, symbol_table, errors)) {
+    state.SkipWithError(errors.str().c_str());
+    return;
+  }
+  for (auto _ : state) {
+    llvm::LLVMContext context;
+    benchmark::DoNotOptimize(
+        code_generate(program, symbol_table, context));
+  }
+  state.SetComplexityN(static_cast<int64_t>(terms));
+}
+
+}  // namespace
+
+BENCHMARK(compile_expression)
+    ->RangeMultiplier(4)
+    ->Range(1 << 8, 1 << 14)
+    ->Unit(benchmark::kMillisecond)
+    ->Complexity(benchmark::oN);
+BENCHMARK(generate_expression)
+    ->RangeMultiplier(4)
+    ->Range(1 << 8, 1 << 14)
+    ->Unit(benchmark::kMillisecond)
+    ->Complexity(benchmark::oN);
+
+}  // namespace pascal::bench
@@ -0,0 +1,142 @@
+#include <libpas/dfa_lexer.hpp>
+#include <libpas/dump_tokens.hpp>
+#include <libpas/scan.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include "null_buffer.hpp"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace pascal::bench {
+
+namespace {
+
+constexpr size_t input_size = 1 << 20;
+
+// Shaped like our generated programs: deeply indented, with a comment on
+// every few lines.
+std::string make_program(size_t size) {
+  constexpr std::string_view block =
+      "        (* accumulate the running sum of the sequence *)\n"
+      "        while i < n do\n"
+      "        begin\n"
+      "            { the next term, scaled }\n"
+      "            sum := sum + a[i] * 3 div 2;\n"
+      "            i := i + 1;\n"
+      "        end;\n";
+  std::string program = "program bench;\nbegin\n";
+  while (program.size() < size) {
+    program += block;
+  }
+  program += "end.\n";
+  return program;
+}
+
+bool skip_unsupported(benchmark::State& state, scan::Isa isa) {
+  if (!scan::is_supported(isa)) {
+    state.SkipWithError("instruction set not supported by this CPU");
+    return true;
+  }
+  return false;
+}
+
+void set_bytes(benchmark::State& state, size_t bytes) {
+  state.SetBytesProcessed(
+      state.iterations() * static_cast<int64_t>(bytes));
+}
+
+void lex(benchmark::State& state, scan::Isa isa) {
+  if (skip_unsupported(state, isa)) {
+    return;
+  }
+  const auto program = make_program(input_size);
+  for (auto _ : state) {
+    DfaLexer lexer(program, isa);
+    size_t tokens = 0;
+    for (auto token = lexer.next(); token.type() != antlr4::Token::EOF;
+         token = lexer.next()) {
+      ++tokens;
+    }
+    benchmark::DoNotOptimize(tokens);
+  }
+  set_bytes(state, program.size());
+}
+
+void dump(benchmark::State& state) {
+  const auto program = make_program(input_size);
+  NullBuffer buffer;
+  std::ostream out(&buffer);
+  for (auto _ : state) {
+    DfaLexer lexer(program);
+    dump_tokens(lexer, out);
+  }
+  set_bytes(state, program.size());
+}
+
+void skip_whitespace(benchmark::State& state, scan::Isa isa) {
+  if (skip_unsupported(state, isa)) {
+    return;
+  }
+  // Indentation runs of 8 to 40 bytes, each ended by a token byte.
+  std::string input;
+  while (input.size() < input_size) {
+    input += '\n';
+    input.append(8 + input.size() % 33, ' ');
+    input += 'x';
+  }
+  const auto& scanner = scan::scanner(isa);
+  for (auto _ : state) {
+    const auto* position = input.data();
+    const auto* const end = input.data() + input.size();
+    while (position != end) {
+      position = scanner.skip_whitespace_(position, end);
+      position += position != end ? 1 : 0;
+    }
+    benchmark::DoNotOptimize(position);
+  }
+  set_bytes(state, input.size());
+}
+
+void find_comment_end(benchmark::State& state, scan::Isa isa) {
+  if (skip_unsupported(state, isa)) {
+    return;
+  }
+  // Comments of about 60 bytes with stray '*' and ')' inside.
+  std::string input;
+  while (input.size() < input_size) {
+    input += "(* see the note above: 2 * (n - 1) items, sorted *) ";
+  }
+  const auto& scanner = scan::scanner(isa);
+  for (auto _ : state) {
+    const auto* position = input.data();
+    const auto* const end = input.data() + input.size();
+    while (position != end) {
+      position = scanner.find_comment_end_(position, end);
+      position += position != end ? 2 : 0;
+    }
+    benchmark::DoNotOptimize(position);
+  }
+  set_bytes(state, input.size());
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(lex, scalar, scan::Isa::Scalar);
+BENCHMARK_CAPTURE(lex, sse2, scan::Isa::Sse2);
+BENCHMARK_CAPTURE(lex, avx2, scan::Isa::Avx2);
+
+BENCHMARK(dump);
+
+BENCHMARK_CAPTURE(skip_whitespace, scalar, scan::Isa::Scalar);
+BENCHMARK_CAPTURE(skip_whitespace, sse2, scan::Isa::Sse2);
+BENCHMARK_CAPTURE(skip_whitespace, avx2, scan::Isa::Avx2);
+
+BENCHMARK_CAPTURE(find_comment_end, scalar, scan::Isa::Scalar);
+BENCHMARK_CAPTURE(find_comment_end, sse2, scan::Isa::Sse2);
+BENCHMARK_CAPTURE(find_comment_end, avx2, scan::Isa::Avx2);
+
+}  // namespace pascal::bench
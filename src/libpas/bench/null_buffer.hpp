@@ -0,0 +1,17 @@
+#pragma once
+
+#include <ios>
+#include <streambuf>
+
+namespace pascal::bench {
+
+// Discards what is written, so that only formatting is measured.
+class NullBuffer final : public std::streambuf {
+ protected:
+  int_type overflow(int_type ch) override { return ch; }
+  std::streamsize xsputn(const char*, std::streamsize count) override {
+    return count;
+  }
+};
+
+}  // namespace pascal::bench
@@ -0,0 +1,140 @@
+#include <libpas/compiler.hpp>
+#include <libpas/input_stream.hpp>
+
+#include <PascalLexer.h>
+
+#include <benchmark/benchmark.h>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <string_view>
+
+namespace pascal::bench {
+
+namespace {
+
+// Not in the warm-up corpus, so a preloaded parser has not seen it either.
+constexpr std::string_view program = R"(program startup;
+const
+    limit = 100;
+var
+    i, count: integer;
+    flags: array[1..100] of integer;
+begin
+    count := 0;
+    i := 2;
+    while i <= limit do
+    begin
+        if flags[i] = 0 then
+        begin
+            count := count + 1;
+            flags[i] := i * i mod limit;
+        end;
+        i := i + 1;
+    end;
+    writeln('primes: ', count);
+end.
+)";
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+double first_token() {
+  const auto start = Clock::now();
+  ByteStream input(program);
+  PascalLexer lexer(&input);
+  benchmark::DoNotOptimize(lexer.nextToken());
+  return seconds_since(start);
+}
+
+double first_ast() {
+  const auto start = Clock::now();
+  ByteStream input(program);
+  PascalLexer lexer(&input);
+  benchmark::DoNotOptimize(parse(lexer));
+  return seconds_since(start);
+}
+
+double preload() {
+  const auto start = Clock::now();
+  preload_parser();
+  return seconds_since(start);
+}
+
+// Each iteration forks, so that the child's lexer and parser start from
+// scratch like those of a new compiler process: the ATNs not deserialized
+// and the DFA caches empty. The child reports the time `measure` took.
+template <typename Measure>
+void in_new_process(benchmark::State& state, bool preloaded, Measure measure) {
+  if (parse_stats().parses_ != 0) {
+    state.SkipWithError("the parser has already run in this process");
+    return;
+  }
+  for (auto _ : state) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+      state.SkipWithError("pipe failed");
+      break;
+    }
+    const auto pid = fork();
+    if (pid == 0) {
+      close(fds[0]);
+      if (preloaded) {
+        preload_parser();
+      }
+      const double seconds = measure();
+      const auto written = write(fds[1], &seconds, sizeof(seconds));
+      _exit(written == sizeof(seconds) ? 0 : 1);
+    }
+    close(fds[1]);
+    double seconds = 0;
+    const auto read_bytes =
+        pid > 0 ? read(fds[0], &seconds, sizeof(seconds)) : -1;
+    close(fds[0]);
+    if (pid > 0) {
+      waitpid(pid, nullptr, 0);
+    }
+    if (read_bytes != sizeof(seconds)) {
+      state.SkipWithError("the measuring process failed");
+      break;
+    }
+    state.SetIterationTime(seconds);
+  }
+}
+
+void startup_first_token(benchmark::State& state, bool preloaded) {
+  in_new_process(state, preloaded, first_token);
+}
+
+void startup_first_ast(benchmark::State& state, bool preloaded) {
+  in_new_process(state, preloaded, first_ast);
+}
+
+void startup_preload(benchmark::State& state) {
+  in_new_process(state, false, preload);
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(startup_first_token, cold, false)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(startup_first_token, preloaded, true)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(startup_first_ast, cold, false)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(startup_first_ast, preloaded, true)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(startup_preload)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace pascal::bench
@@ -0,0 +1,231 @@
+#include <libpas/compiler.hpp>
+#include <libpas/descent_parser.hpp>
+#include <libpas/dfa_lexer.hpp>
+#include <libpas/dump_tokens.hpp>
+#include <libpas/input_stream.hpp>
+
+#include <PascalLexer.h>
+
+#include <benchmark/benchmark.h>
+
+#include "null_buffer.hpp"
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace pascal::bench {
+
+namespace {
+
+constexpr int64_t min_size = 1 << 10;
+constexpr int64_t max_size = 100 << 20;
+// ANTLR keeps every token and the whole parse tree in memory, which takes
+// gigabytes well before max_size.
+constexpr int64_t max_antlr_parse_size = 32 << 20;
+
+// The declarations of the examples, then their statements repeated until
+// the program is `size` bytes long. Every program is valid, so sizes can be
+// compared.
+std::string make_program(size_t size) {
+  constexpr std::string_view header =
+      "{Synthetic program built from the examples}\n"
+      "program Throughput;\n"
+      "const\n"
+      "    b = 42;\n"
+      "    ten = 10;\n"
+      "    greeting = 'hello';\n"
+      "var\n"
+      "    arr : array[1..100] of integer;\n"
+      "    i, j, buf, N, z, m, res : integer;\n"
+      "    s1 : string;\n"
+      "    ch : char;\n"
+      "begin\n";
+  constexpr std::string_view statements =
+      "    {one pass of the bubble sort}\n"
+      "    i := 1;\n"
+      "    while (i < N) do\n"
+      "        begin\n"
+      "        j := 1;\n"
+      "        while (j <= N - i) do\n"
+      "            begin\n"
+      "            if (arr[j] > arr[j + 1]) then\n"
+      "                begin\n"
+      "                buf := arr[j];\n"
+      "                arr[j] := arr[j + 1];\n"
+      "                arr[j + 1] := buf;\n"
+      "                end;\n"
+      "            j += 1;\n"
+      "            end;\n"
+      "        i += 1;\n"
+      "        end;\n"
+      "    res := b * ((i * 2) - b * ((3 + 4 * ten) div 5) mod 45);\n"
+      "    if i < j then\n"
+      "        m := i\n"
+      "    else\n"
+      "        m := j;\n"
+      "    if (res mod m = 0) then\n"
+      "        z := m;\n"
+      "    s1 := greeting;\n"
+      "    s1 += ' ';\n"
+      "    s1[1] := ch;\n"
+      "    writeln('Hash: ', res, ' ', s1);\n"
+      "    readln(N);\n";
+  constexpr std::string_view footer = "end.\n";
+
+  std::string program(header);
+  program.reserve(size + statements.size());
+  do {
+    program += statements;
+  } while (program.size() + footer.size() < size);
+  program += footer;
+  return program;
+}
+
+// Generating the largest programs takes longer than lexing them, so each
+// size is made once.
+const std::string& program_of_size(int64_t size) {
+  static std::map<int64_t, std::string> programs;
+  auto& program = programs[size];
+  if (program.empty()) {
+    program = make_program(static_cast<size_t>(size));
+  }
+  return program;
+}
+
+size_t count_tokens(const std::string& program) {
+  DfaLexer lexer(program);
+  size_t tokens = 0;
+  while (lexer.next().type() != antlr4::Token::EOF) {
+    ++tokens;
+  }
+  return tokens;
+}
+
+// Bytes per second, and `items` per iteration as a per-second rate.
+void set_rates(
+    benchmark::State& state,
+    const std::string& program,
+    const char* name,
+    size_t items) {
+  state.SetBytesProcessed(
+      state.iterations() * static_cast<int64_t>(program.size()));
+  state.counters[name] = benchmark::Counter(
+      static_cast<double>(items),
+      benchmark::Counter::kIsIterationInvariantRate);
+}
+
+void lex_antlr(benchmark::State& state) {
+  const auto& program = program_of_size(state.range(0));
+  size_t tokens = 0;
+  for (auto _ : state) {
+    ByteStream input(program);
+    PascalLexer lexer(&input);
+    tokens = 0;
+    while (lexer.nextToken()->getType() != antlr4::Token::EOF) {
+      ++tokens;
+    }
+  }
+  set_rates(state, program, "tokens", tokens);
+}
+
+void dump_tokens_antlr(benchmark::State& state) {
+  const auto& program = program_of_size(state.range(0));
+  NullBuffer buffer;
+  std::ostream out(&buffer);
+  for (auto _ : state) {
+    ByteStream input(program);
+    PascalLexer lexer(&input);
+    dump_tokens(lexer, out);
+  }
+  set_rates(state, program, "tokens", count_tokens(program));
+}
+
+void dump_tokens_dfa(benchmark::State& state) {
+  const auto& program = program_of_size(state.range(0));
+  NullBuffer buffer;
+  std::ostream out(&buffer);
+  for (auto _ : state) {
+    DfaLexer lexer(program);
+    dump_tokens(lexer, out);
+  }
+  set_rates(state, program, "tokens", count_tokens(program));
+}
+
+template <typename Parse>
+void parse_with(benchmark::State& state, Parse parse) {
+  const auto& program = program_of_size(state.range(0));
+  size_t nodes = 0;
+  for (auto _ : state) {
+    auto result = parse(program);
+    if (!result.errors_.empty()) {
+      state.SkipWithError("the synthetic program has syntax errors");
+      return;
+    }
+    nodes = result.program_.node_count();
+  }
+  set_rates(state, program, "nodes", nodes);
+}
+
+void parse_antlr(benchmark::State& state) {
+  parse_with(state, [](const std::string& program) {
+    ByteStream input(program);
+    PascalLexer lexer(&input);
+    return parse(lexer);
+  });
+}
+
+void parse_descent(benchmark::State& state) {
+  parse_with(state, [](const std::string& program) {
+    DescentParser parser(program);
+    return parse(parser);
+  });
+}
+
+// The program's binary AST, as --dump-ast=binary writes it, loaded back.
+// The bytes counted are the source's, so the rate compares with parse_*.
+void load_binary_ast(benchmark::State& state) {
+  DescentParser parser(program_of_size(state.range(0)));
+  auto parsed = parse(parser);
+  std::ostringstream bytes;
+  std::ostringstream errors;
+  dump_binary_ast(parsed.program_, nullptr, bytes, errors);
+  const auto binary_ast = bytes.str();
+  parse_with(state, [&binary_ast](const std::string&) {
+    return ParseResult::program(ast::BinaryAst(binary_ast).program());
+  });
+}
+
+}  // namespace
+
+// Programs of 1 KB, 32 KB, 1 MB, 32 MB and 100 MB. Compare runs saved with
+// --benchmark_out=<file>.json using tools/compare.py from Google Benchmark.
+BENCHMARK(lex_antlr)
+    ->RangeMultiplier(32)
+    ->Range(min_size, max_size)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(dump_tokens_antlr)
+    ->RangeMultiplier(32)
+    ->Range(min_size, max_size)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(dump_tokens_dfa)
+    ->RangeMultiplier(32)
+    ->Range(min_size, max_size)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(parse_antlr)
+    ->RangeMultiplier(32)
+    ->Range(min_size, max_antlr_parse_size)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(parse_descent)
+    ->RangeMultiplier(32)
+    ->Range(min_size, max_size)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(load_binary_ast)
+    ->RangeMultiplier(32)
+    ->Range(min_size, max_size)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace pascal::bench
@@ -0,0 +1,83 @@
+#include <libpas/allocations.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// Per thread, so that concurrent compilations (-j, the server) are counted
+// separately and no synchronization is needed.
+thread_local uint64_t allocations = 0;
+
+void* allocate(std::size_t size) {
+  ++allocations;
+  if (size == 0) {
+    size = 1;
+  }
+  while (true) {
+    if (void* pointer = std::malloc(size)) {
+      return pointer;
+    }
+    auto* handler = std::get_new_handler();
+    if (handler == nullptr) {
+      throw std::bad_alloc();
+    }
+    handler();
+  }
+}
+
+void* allocate(std::size_t size, std::align_val_t alignment) {
+  ++allocations;
+  const auto align = static_cast<std::size_t>(alignment);
+  // aligned_alloc requires the size to be a multiple of the alignment.
+  size = (std::max<std::size_t>(size, 1) + align - 1) / align * align;
+  while (true) {
+    if (void* pointer = std::aligned_alloc(align, size)) {
+      return pointer;
+    }
+    auto* handler = std::get_new_handler();
+    if (handler == nullptr) {
+      throw std::bad_alloc();
+    }
+    handler();
+  }
+}
+
+}  // namespace
+
+namespace pascal {
+
+uint64_t allocation_count() {
+  return allocations;
+}
+
+}  // namespace pascal
+
+// The array and nothrow forms forward to these in the standard library.
+void* operator new(std::size_t size) {
+  return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  return allocate(size, alignment);
+}
+
+void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t /*size*/) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t /*alignment*/) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(
+    void* pointer,
+    std::size_t /*size*/,
+    std::align_val_t /*alignment*/) noexcept {
+  std::free(pointer);
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+
+namespace pascal {
+
+// Number of calls to the global operator new made by the calling thread.
+// Only executables that link the pascal_allocations target count them, as
+// it replaces the global operator new and delete.
+uint64_t allocation_count();
+
+}  // namespace pascal
@@ -0,0 +1,41 @@
+#include <libpas/ast/Arena.hpp>
+
+#include <algorithm>
+#include <utility>
+
+namespace pascal::ast {
+
+Arena::Arena(Arena&& other) noexcept
+    : chunks_(std::move(other.chunks_)),
+      next_chunk_size_(
+          std::exchange(other.next_chunk_size_, first_chunk_size)),
+      current_(std::exchange(other.current_, nullptr)),
+      end_(std::exchange(other.end_, nullptr)) {
+  other.chunks_.clear();
+}
+
+Arena& Arena::operator=(Arena&& other) noexcept {
+  if (this != &other) {
+    chunks_ = std::move(other.chunks_);
+    other.chunks_.clear();
+    next_chunk_size_ = std::exchange(other.next_chunk_size_, first_chunk_size);
+    current_ = std::exchange(other.current_, nullptr);
+    end_ = std::exchange(other.end_, nullptr);
+  }
+  return *this;
+}
+
+void* Arena::allocate_chunk(size_t size, size_t /*alignment*/) {
+  // new[] aligns for any fundamental type, so the chunk start needs no
+  // padding. A request larger than the next chunk gets a chunk of its own.
+  // The memory is not zeroed: every node is constructed in place.
+  const auto chunk_size = std::max(next_chunk_size_, size);
+  next_chunk_size_ = std::min(next_chunk_size_ * 2, max_chunk_size);
+  chunks_.emplace_back(new std::byte[chunk_size]);
+  auto* chunk = chunks_.back().get();
+  current_ = chunk + size;
+  end_ = chunk + chunk_size;
+  return chunk;
+}
+
+}  // namespace pascal::ast
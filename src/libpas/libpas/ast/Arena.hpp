@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace pascal::ast {
+
+// Monotonic storage: allocations are carved one after another out of chunks
+// that double in size, and the chunks are only freed all at once when the
+// arena is destroyed. It never runs destructors.
+class Arena final {
+ public:
+  Arena() = default;
+  Arena(Arena&& other) noexcept;
+  Arena& operator=(Arena&& other) noexcept;
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+  ~Arena() = default;
+
+  // `alignment` must be a power of two no greater than that of
+  // std::max_align_t.
+  void* allocate(size_t size, size_t alignment) {
+    const auto position = reinterpret_cast<uintptr_t>(current_);
+    const auto aligned = (position + alignment - 1) & ~(alignment - 1);
+    if (current_ == nullptr ||
+        aligned + size > reinterpret_cast<uintptr_t>(end_)) {
+      return allocate_chunk(size, alignment);
+    }
+    current_ += aligned - position + size;
+    return reinterpret_cast<void*>(aligned);
+  }
+
+  size_t chunk_count() const { return chunks_.size(); }
+
+ private:
+  static constexpr size_t first_chunk_size = 4096;
+  static constexpr size_t max_chunk_size = 1 << 20;
+
+  void* allocate_chunk(size_t size, size_t alignment);
+
+  std::vector<std::unique_ptr<std::byte[]>> chunks_;
+  size_t next_chunk_size_ = first_chunk_size;
+  std::byte* current_ = nullptr;
+  std::byte* end_ = nullptr;
+};
+
+}  // namespace pascal::ast
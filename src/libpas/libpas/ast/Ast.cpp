@@ -2,8 +2,50 @@
 
 #include <libpas/ast/Visitor.hpp>
 
+#include <array>
+#include <utility>
+
 namespace pascal::ast {
 
+Program::Program(Program&& other) noexcept
+    : members_(std::move(other.members_)),
+      arena_(std::move(other.arena_)),
+      symbols_(std::move(other.symbols_)),
+      header_(std::exchange(other.header_, nullptr)),
+      constdecl_(std::exchange(other.constdecl_, nullptr)),
+      vardecl_(std::exchange(other.vardecl_, nullptr)),
+      block_(std::exchange(other.block_, nullptr)) {
+  other.members_.clear();
+}
+
+Program& Program::operator=(Program&& other) noexcept {
+  if (this != &other) {
+    destroy_nodes();
+    members_ = std::move(other.members_);
+    other.members_.clear();
+    arena_ = std::move(other.arena_);
+    symbols_ = std::move(other.symbols_);
+    header_ = std::exchange(other.header_, nullptr);
+    constdecl_ = std::exchange(other.constdecl_, nullptr);
+    vardecl_ = std::exchange(other.vardecl_, nullptr);
+    block_ = std::exchange(other.block_, nullptr);
+  }
+  return *this;
+}
+
+Program::~Program() {
+  destroy_nodes();
+}
+
+void Program::destroy_nodes() {
+  // The destructors free what the nodes own (texts, child lists), not the
+  // nodes themselves: their memory goes with the arena, chunk by chunk.
+  for (auto it = members_.rbegin(); it != members_.rend(); ++it) {
+    (*it)->~Member();
+  }
+  members_.clear();
+}
+
 void Operation::accept(Visitor& visitor) {
   visitor.visit(*this);
 }
@@ -100,4 +142,51 @@ void Branch::accept(Visitor& visitor) {
   visitor.visit(*this);
 }
 
+namespace {
+
+int precedence(const Operation& operation) {
+  static const auto star = Interner::fixed("*");
+  static const auto div = Interner::fixed("div");
+  static const auto mod = Interner::fixed("mod");
+  const auto symbol = operation.symbol();
+  return symbol == star || symbol == div || symbol == mod ? 2 : 1;
+}
+
+}  // namespace
+
+Expression* group_operations(
+    Program& program,
+    Expression* const* operands,
+    Operation* const* operations,
+    size_t count) {
+  // Operator precedence parsing: an operation waits on the stack until one
+  // of no higher precedence follows it. With two levels the stack never
+  // holds more than two operations, and three values.
+  std::array<Expression*, 3> values{operands[0]};
+  std::array<Operation*, 2> pending{};
+  size_t depth = 0;
+  const auto reduce = [&] {
+    --depth;
+    values[depth] = program.create_node<Expression>(
+        values[depth],
+        pending[depth],
+        values[depth + 1],
+        Expression::Signs{},
+        nullptr,
+        false);
+  };
+  for (size_t i = 0; i != count; ++i) {
+    while (depth != 0 &&
+           precedence(*pending[depth - 1]) >= precedence(*operations[i])) {
+      reduce();
+    }
+    pending[depth] = operations[i];
+    values[++depth] = operands[i + 1];
+  }
+  while (depth != 0) {
+    reduce();
+  }
+  return values[0];
+}
+
 }  // namespace pascal::ast
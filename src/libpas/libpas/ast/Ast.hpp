@@ -1,9 +1,16 @@
 #pragma once
 
+#include <libpas/ast/Arena.hpp>
+#include <libpas/ast/Interner.hpp>
 #include <libpas/ast/SymbolTable.hpp>
 
+#include <algorithm>
+#include <cstddef>
 #include <memory>
+#include <new>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace pascal::ast {
@@ -15,13 +22,66 @@ class Vardecl;
 class Block;
 class Visitor;
 
+// A view of node pointers kept in a program's arena (see
+// Program::copy_nodes), so that a node holding a list needs no heap
+// allocation of its own.
+template <class T>
+class NodeSpan final {
+ public:
+  NodeSpan() = default;
+  NodeSpan(T* const* data, size_t size) : data_(data), size_(size) {}
+  T* const* begin() const { return data_; }
+  T* const* end() const { return data_ + size_; }
+  T* operator[](size_t i) const { return data_[i]; }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+ private:
+  T* const* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+// A moved-from program has no nodes and no symbols, and may only be
+// assigned to or destroyed.
 class Program final {
  public:
+  Program() = default;
+  Program(Program&& other) noexcept;
+  Program& operator=(Program&& other) noexcept;
+  Program(const Program&) = delete;
+  Program& operator=(const Program&) = delete;
+  ~Program();
+
+  // Constructs the node in the program's arena. It lives, and its address
+  // stays valid, as long as the program.
   template <class T, class... Args>
   T* create_node(Args&&... args) {
     static_assert(std::is_base_of_v<Member, T>);
-    members_.emplace_back(std::make_unique<T>(std::forward<Args>(args)...));
-    return dynamic_cast<T*>(members_.back().get());
+    static_assert(alignof(T) <= alignof(std::max_align_t));
+    // The slot is added first, so that a node is never left unrecorded.
+    members_.push_back(nullptr);
+    try {
+      auto* node = new (arena_.allocate(sizeof(T), alignof(T)))
+          T(std::forward<Args>(args)...);
+      members_.back() = node;
+      return node;
+    } catch (...) {
+      members_.pop_back();
+      throw;
+    }
+  }
+
+  // Copies `count` pointers into the program's arena. Like a node, the copy
+  // lives as long as the program.
+  template <class T>
+  NodeSpan<T> copy_nodes(T* const* nodes, size_t count) {
+    if (count == 0) {
+      return {};
+    }
+    auto* copy =
+        static_cast<T**>(arena_.allocate(count * sizeof(T*), alignof(T*)));
+    std::copy(nodes, nodes + count, copy);
+    return {copy, count};
   }
 
   void set_header(Header* header) { header_ = header; }
@@ -33,8 +93,22 @@ class Program final {
   Vardecl* get_vardecl() { return vardecl_; }
   Block* get_block() { return block_; }
 
+  size_t node_count() const { return members_.size(); }
+  size_t chunk_count() const { return arena_.chunk_count(); }
+
+  // The strings of the nodes' symbols. It stays at its address when the
+  // program moves, so a FlatAst of the program can refer to it.
+  Interner& symbols() { return *symbols_; }
+  const Interner& symbols() const { return *symbols_; }
+
  private:
-  std::vector<std::unique_ptr<Member>> members_;
+  void destroy_nodes();
+
+  // Every node, in creation order, for the destructors. The memory itself
+  // goes with the arena, chunk by chunk.
+  std::vector<Member*> members_;
+  Arena arena_;
+  std::unique_ptr<Interner> symbols_ = std::make_unique<Interner>();
   Header* header_ = nullptr;
   Constdecl* constdecl_ = nullptr;
   Vardecl* vardecl_ = nullptr;
@@ -57,12 +131,15 @@ class Value : public Member {
  public:
   virtual ~Value() = default;
   virtual void accept(Visitor& visitor) = 0;
-  virtual const std::string& text() const = 0;
+  SymbolId symbol() const { return symbol_; }
   VarType type() const { return type_; }
   void set_type(VarType type) { type_ = type; }
 
  protected:
-  VarType type_;
+  explicit Value(SymbolId symbol) : symbol_(symbol) {}
+
+  SymbolId symbol_;
+  VarType type_ = VarType::NoType;
 };
 
 class Vartype : public Member {
@@ -78,75 +155,78 @@ class Vartype : public Member {
 
 class Operation final : public Member {
  public:
-  explicit Operation(std::string text) : text_(std::move(text)) {}
-  const std::string& text() const { return text_; }
+  explicit Operation(SymbolId symbol) : symbol_(symbol) {}
+  SymbolId symbol() const { return symbol_; }
   void accept(Visitor& visitor) override;
   Op type() const { return type_; }
   void set_type(Op type) { type_ = type; }
 
  private:
-  std::string text_;
-  Op type_;
+  SymbolId symbol_;
+  Op type_{};
 };
 
 class Booloperation final : public Member {
  public:
-  explicit Booloperation(std::string text) : text_(std::move(text)) {}
-  const std::string& text() const { return text_; }
+  explicit Booloperation(SymbolId symbol) : symbol_(symbol) {}
+  SymbolId symbol() const { return symbol_; }
   void accept(Visitor& visitor) override;
   BoolOp type() const { return type_; }
   void set_type(BoolOp type) { type_ = type; }
 
  private:
-  std::string text_;
-  BoolOp type_;
+  SymbolId symbol_;
+  BoolOp type_{};
 };
 
 class Modification final : public Member {
  public:
-  explicit Modification(std::string text) : text_(std::move(text)) {}
-  const std::string& text() const { return text_; }
+  explicit Modification(SymbolId symbol) : symbol_(symbol) {}
+  SymbolId symbol() const { return symbol_; }
   void accept(Visitor& visitor) override;
   ModType type() const { return type_; }
   void set_type(ModType type) { type_ = type; }
 
  private:
-  std::string text_;
-  ModType type_;
+  SymbolId symbol_;
+  ModType type_{};
 };
 
+// One of `lhs operation rhs`, `(lhs)` with brackets(), or `signs atom`.
 class Expression final : public Member {
  public:
-  using Operands = std::vector<ast::Expression*>;
-  using Signs = std::vector<ast::Operation*>;
+  using Signs = NodeSpan<Operation>;
   Expression(
-      Operands operands,
+      Expression* lhs,
       Operation* operation,
+      Expression* rhs,
       Signs signs,
       Value* atom,
       bool brackets)
-      : operands_(std::move(operands)),
-        operation_(std::move(operation)),
-        signs_(std::move(signs)),
-        atom_(std::move(atom)),
+      : lhs_(lhs),
+        operation_(operation),
+        rhs_(rhs),
+        signs_(signs),
+        atom_(atom),
         brackets_(brackets) {}
-  const Operands& operands() const { return operands_; }
+  Expression* lhs() { return lhs_; }
   Operation* operation() { return operation_; }
-  const Signs& signs() const { return signs_; }
+  Expression* rhs() { return rhs_; }
+  Signs signs() const { return signs_; }
   Value* atom() { return atom_; }
   bool brackets() const { return brackets_; }
   void accept(Visitor& visitor) override;
   VarType type() const { return type_; }
   void set_type(VarType type) { type_ = type; }
-  const std::string& text() const { return atom_->text(); }
 
  private:
-  Operands operands_;
+  Expression* lhs_;
   Operation* operation_;
+  Expression* rhs_;
   Signs signs_;
   Value* atom_;
   bool brackets_;
-  VarType type_;
+  VarType type_ = VarType::NoType;
 };
 
 class Boolexpr final : public Member {
@@ -169,17 +249,17 @@ class Boolexpr final : public Member {
   Expression* operand1_;
   Booloperation* booloperation_;
   Expression* operand2_;
-  VarType type_;
+  VarType type_ = VarType::NoType;
 };
 
 class Simpletype final : public Vartype {
  public:
-  explicit Simpletype(std::string text) : text_(std::move(text)) {}
-  const std::string& text() const { return text_; }
+  explicit Simpletype(SymbolId symbol) : symbol_(symbol) {}
+  SymbolId symbol() const { return symbol_; }
   void accept(Visitor& visitor) override;
 
  private:
-  std::string text_;
+  SymbolId symbol_;
 };
 
 class Interval final : public Member {
@@ -195,7 +275,7 @@ class Interval final : public Member {
  private:
   Value* lborder_;
   Value* rborder_;
-  VarType type_;
+  VarType type_ = VarType::NoType;
 };
 
 class Arraytype final : public Vartype {
@@ -213,34 +293,32 @@ class Arraytype final : public Vartype {
 
 class Functionname final : public Member {
  public:
-  explicit Functionname(std::string text) : text_(std::move(text)) {}
-  const std::string& text() const { return text_; }
+  explicit Functionname(SymbolId symbol) : symbol_(symbol) {}
+  SymbolId symbol() const { return symbol_; }
   void accept(Visitor& visitor) override;
   FuncName type() const { return type_; }
   void set_type(FuncName type) { type_ = type; }
 
  private:
-  std::string text_;
-  FuncName type_;
+  SymbolId symbol_;
+  FuncName type_{};
 };
 
 class Id final : public Value {
  public:
-  explicit Id(std::string text) : text_(std::move(text)) {}
-  virtual const std::string& text() const override { return text_; }
+  explicit Id(SymbolId symbol) : Value(symbol) {}
   void accept(Visitor& visitor) override;
-
- private:
-  std::string text_;
 };
 
 class Cell final : public Value {
  public:
+  // Its symbol is the array's.
   Cell(Id* varname, Expression* index)
-      : varname_(std::move(varname)), index_(std::move(index)) {}
+      : Value(varname->symbol()),
+        varname_(std::move(varname)),
+        index_(std::move(index)) {}
   Id* varname() { return varname_; }
   Expression* index() { return index_; }
-  virtual const std::string& text() const override { return varname_->text(); }
   void accept(Visitor& visitor) override;
 
  private:
@@ -278,32 +356,20 @@ class Declaration final : public Member {
 
 class Char final : public Value {
  public:
-  explicit Char(std::string text) : text_(std::move(text)) {}
-  virtual const std::string& text() const override { return text_; }
+  explicit Char(SymbolId symbol) : Value(symbol) {}
   void accept(Visitor& visitor) override;
-
- private:
-  std::string text_;
 };
 
 class Stringliteral final : public Value {
  public:
-  explicit Stringliteral(std::string text) : text_(std::move(text)) {}
-  virtual const std::string& text() const override { return text_; }
+  explicit Stringliteral(SymbolId symbol) : Value(symbol) {}
   void accept(Visitor& visitor) override;
-
- private:
-  std::string text_;
 };
 
 class Int final : public Value {
  public:
-  explicit Int(std::string text) : text_(std::move(text)) {}
-  virtual const std::string& text() const override { return text_; }
+  explicit Int(SymbolId symbol) : Value(symbol) {}
   void accept(Visitor& visitor) override;
-
- private:
-  std::string text_;
 };
 
 class Header final : public Member {
@@ -433,4 +499,14 @@ class Branch final : public Statement {
   Statement* alternative_;
 };
 
+// Groups `operands[0] operations[0] operands[1] ... operands[count]` into
+// binary Expressions: `*`, `div` and `mod` bind tighter than `+` and `-`,
+// and operations of the same level group to the left. Takes linear time, so
+// codegen can walk the result as is, and allocates only the new nodes.
+Expression* group_operations(
+    Program& program,
+    Expression* const* operands,
+    Operation* const* operations,
+    size_t count);
+
 }  // namespace pascal::ast
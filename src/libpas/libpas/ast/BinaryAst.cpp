@@ -0,0 +1,701 @@
+#include <libpas/ast/BinaryAst.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+namespace pascal::ast {
+
+namespace {
+
+constexpr char magic[8] = {'P', 'A', 'S', 'A', 'S', 'T', '\0', '\0'};
+// Reads back as another value on a host of the other byte order.
+constexpr uint32_t byte_order_mark = 0x01020304;
+constexpr uint32_t analysed_flag = 1;
+
+struct FileHeader {
+  char magic_[8];
+  uint32_t version_;
+  uint32_t byte_order_;
+  uint32_t flags_;
+  uint32_t node_count_;
+  uint32_t child_count_;
+  uint32_t string_count_;
+  uint32_t entry_count_;
+  uint32_t string_bytes_;
+};
+
+static_assert(sizeof(FileHeader) == 40);
+
+size_t padded(size_t size) {
+  return (size + 7) & ~size_t{7};
+}
+
+// The offsets of the sections, and the file size, that a header implies.
+struct Layout {
+  Layout(const FileHeader& header, size_t entry_size) {
+    kinds_ = sizeof(FileHeader);
+    types_ = kinds_ + padded(header.node_count_);
+    symbols_ = types_ + padded(header.node_count_);
+    first_child_ =
+        symbols_ + padded(sizeof(uint32_t) * header.node_count_);
+    children_ = first_child_ +
+        padded(sizeof(uint32_t) * (size_t{header.node_count_} + 1));
+    string_ends_ =
+        children_ + padded(sizeof(NodeId) * header.child_count_);
+    entries_ =
+        string_ends_ + padded(sizeof(uint32_t) * header.string_count_);
+    strings_ = entries_ + entry_size * header.entry_count_;
+    size_ = strings_ + padded(header.string_bytes_);
+  }
+
+  size_t kinds_;
+  size_t types_;
+  size_t symbols_;
+  size_t first_child_;
+  size_t children_;
+  size_t string_ends_;
+  size_t entries_;
+  size_t strings_;
+  size_t size_;
+};
+
+bool has_symbol(Kind kind) {
+  switch (kind) {
+    case Kind::Simpletype:
+    case Kind::Operation:
+    case Kind::Booloperation:
+    case Kind::Modification:
+    case Kind::Functionname:
+    case Kind::Id:
+    case Kind::Cell:
+    case Kind::Char:
+    case Kind::Stringliteral:
+    case Kind::Int:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void write_section(std::ostream& out, const void* data, size_t size) {
+  static constexpr char zeros[8] = {};
+  out.write(
+      static_cast<const char*>(data), static_cast<std::streamsize>(size));
+  out.write(zeros, static_cast<std::streamsize>(padded(size) - size));
+}
+
+// Whether nodes stored in pre-order, each the child of one node, nest more
+// than BinaryAst::max_depth levels deep. `children(node)` returns a node's
+// children.
+template <class Children>
+bool too_deep(size_t node_count, Children children) {
+  std::vector<uint32_t> depths(node_count);
+  for (NodeId node = 0; node < node_count; ++node) {
+    if (depths[node] > BinaryAst::max_depth) {
+      return true;
+    }
+    for (const auto child : children(node)) {
+      depths[child] = depths[node] + 1;
+    }
+  }
+  return false;
+}
+
+[[noreturn]] void invalid(const std::string& reason) {
+  throw BinaryAstError("Invalid binary AST: " + reason);
+}
+
+}  // namespace
+
+// Builds the program top down, checking each node's kind and children
+// against the layout FlatAst documents before it uses them.
+class BinaryAst::Loader final {
+ public:
+  Loader(const BinaryAst& ast, Program& program)
+      : ast_(ast), program_(program) {
+    symbols_.reserve(ast_.strings_.size());
+    for (const auto text : ast_.strings_) {
+      symbols_.push_back(program_.symbols().intern(text));
+    }
+  }
+
+  void load() {
+    const auto nodes = expect(0, Kind::Program, 2, 4);
+    size_t n = 0;
+    program_.set_header(header(nodes[n++]));
+    if (n + 1 < nodes.size() && kind(nodes[n]) == Kind::Constdecl) {
+      program_.set_constdecl(constdecl(nodes[n++]));
+    }
+    if (n + 1 < nodes.size() && kind(nodes[n]) == Kind::Vardecl) {
+      program_.set_vardecl(vardecl(nodes[n++]));
+    }
+    if (n + 1 != nodes.size()) {
+      fail(0);
+    }
+    program_.set_block(block(nodes[n]));
+  }
+
+ private:
+  static constexpr size_t any = std::numeric_limits<size_t>::max();
+
+  [[noreturn]] static void fail(NodeId node) {
+    invalid("unexpected node " + std::to_string(node));
+  }
+
+  Kind kind(NodeId node) const { return ast_.kinds_[node]; }
+
+  SymbolId symbol(NodeId node) const {
+    return symbols_[ast_.symbols_[node]];
+  }
+
+  // The symbol of a node that the parsers spell with one of `texts`.
+  // Semantic analysis looks these up without a fallback.
+  SymbolId symbol(
+      NodeId node,
+      std::initializer_list<std::string_view> texts) const {
+    const auto symbol = this->symbol(node);
+    for (const auto text : texts) {
+      if (symbol == Interner::fixed(text)) {
+        return symbol;
+      }
+    }
+    fail(node);
+  }
+
+  template <class Type>
+  Type type(NodeId node, Type last) const {
+    if (ast_.types_[node] > static_cast<uint8_t>(last)) {
+      fail(node);
+    }
+    return static_cast<Type>(ast_.types_[node]);
+  }
+
+  // The node's children, of which it must have from `min` to `max`.
+  FlatAst::Children expect(NodeId node, Kind kind, size_t min, size_t max) {
+    const FlatAst::Children children(
+        ast_.children_ + ast_.first_child_[node],
+        ast_.children_ + ast_.first_child_[node + 1]);
+    if (this->kind(node) != kind || children.size() < min ||
+        children.size() > max) {
+      fail(node);
+    }
+    return children;
+  }
+
+  FlatAst::Children expect(NodeId node, Kind kind, size_t count) {
+    return expect(node, kind, count, count);
+  }
+
+  Header* header(NodeId node) {
+    const auto children = expect(node, Kind::Header, 1);
+    return program_.create_node<Header>(id(children[0]));
+  }
+
+  Constdecl* constdecl(NodeId node) {
+    const auto children = expect(node, Kind::Constdecl, 0, any);
+    Constdecl::Constdeclarations constdeclarations;
+    constdeclarations.reserve(children.size());
+    for (const auto child : children) {
+      const auto parts = expect(child, Kind::Constdeclaration, 2);
+      constdeclarations.push_back(program_.create_node<Constdeclaration>(
+          id(parts[0]), expression(parts[1])));
+    }
+    return program_.create_node<Constdecl>(std::move(constdeclarations));
+  }
+
+  Vardecl* vardecl(NodeId node) {
+    const auto children = expect(node, Kind::Vardecl, 0, any);
+    Vardecl::Declarations declarations;
+    declarations.reserve(children.size());
+    for (const auto child : children) {
+      declarations.push_back(declaration(child));
+    }
+    return program_.create_node<Vardecl>(std::move(declarations));
+  }
+
+  Declaration* declaration(NodeId node) {
+    const auto children = expect(node, Kind::Declaration, 1, any);
+    Declaration::Varnames varnames;
+    varnames.reserve(children.size() - 1);
+    for (size_t i = 0; i + 1 < children.size(); ++i) {
+      varnames.push_back(id(children[i]));
+    }
+    const auto last = children.back();
+    Vartype* vartype = nullptr;
+    if (kind(last) == Kind::Arraytype) {
+      const auto parts = expect(last, Kind::Arraytype, 2);
+      const auto interval_parts = expect(parts[0], Kind::Interval, 2);
+      auto* interval = program_.create_node<Interval>(
+          integer(interval_parts[0]), integer(interval_parts[1]));
+      interval->set_type(type(parts[0], VarType::NoType));
+      vartype = program_.create_node<Arraytype>(
+          interval, simpletype(parts[1]));
+      set_vartype(*vartype, last, Form::Array);
+    } else {
+      vartype = simpletype(last);
+    }
+    return program_.create_node<Declaration>(std::move(varnames), vartype);
+  }
+
+  Simpletype* simpletype(NodeId node) {
+    expect(node, Kind::Simpletype, 0);
+    auto* simpletype = program_.create_node<Simpletype>(
+        symbol(node, {"integer", "char", "string"}));
+    set_vartype(*simpletype, node, Form::Variable);
+    return simpletype;
+  }
+
+  // Semantic analysis gives a vartype its form along with its type; a
+  // vartype without a type keeps the default Symbol.
+  void set_vartype(Vartype& vartype, NodeId node, Form form) {
+    const auto var_type = type(node, VarType::NoType);
+    if (var_type != VarType::NoType) {
+      auto symbol = Symbol(form, var_type);
+      vartype.set_type(symbol);
+    }
+  }
+
+  Block* block(NodeId node) {
+    const auto children = expect(node, Kind::Block, 0, any);
+    Block::Components components;
+    components.reserve(children.size());
+    for (const auto child : children) {
+      components.push_back(statement(child));
+    }
+    return program_.create_node<Block>(std::move(components));
+  }
+
+  Statement* statement(NodeId node) {
+    switch (kind(node)) {
+      case Kind::Block:
+        return block(node);
+      case Kind::Functioncall:
+        return functioncall(node);
+      case Kind::Assignment:
+        return assignment(node);
+      case Kind::While: {
+        const auto children = expect(node, Kind::While, 2);
+        auto* condition = boolexpr(children[0]);
+        return program_.create_node<While>(
+            condition, statement(children[1]));
+      }
+      case Kind::Branch: {
+        const auto children = expect(node, Kind::Branch, 2, 3);
+        auto* condition = boolexpr(children[0]);
+        auto* consequence = statement(children[1]);
+        auto* alternative =
+            children.size() == 3 ? statement(children[2]) : nullptr;
+        return program_.create_node<Branch>(
+            condition, consequence, alternative);
+      }
+      default:
+        fail(node);
+    }
+  }
+
+  Functioncall* functioncall(NodeId node) {
+    const auto children = expect(node, Kind::Functioncall, 1, any);
+    expect(children[0], Kind::Functionname, 0);
+    auto* name = program_.create_node<Functionname>(
+        symbol(children[0], {"readln", "write", "writeln"}));
+    name->set_type(type(children[0], FuncName::Writeln));
+    Functioncall::Variables variables;
+    Functioncall::Arguments arguments;
+    size_t i = 1;
+    for (; i < children.size() && !is_expression(kind(children[i])); ++i) {
+      if (kind(children[i]) != Kind::Id && kind(children[i]) != Kind::Cell) {
+        fail(children[i]);
+      }
+      variables.push_back(value(children[i]));
+    }
+    arguments.reserve(children.size() - i);
+    for (; i < children.size(); ++i) {
+      arguments.push_back(expression(children[i]));
+    }
+    return program_.create_node<Functioncall>(
+        name, std::move(variables), std::move(arguments));
+  }
+
+  Assignment* assignment(NodeId node) {
+    const auto children = expect(node, Kind::Assignment, 3);
+    Cell* cell = nullptr;
+    Id* varname = nullptr;
+    if (kind(children[0]) == Kind::Cell) {
+      cell = this->cell(children[0]);
+    } else {
+      varname = id(children[0]);
+    }
+    expect(children[1], Kind::Modification, 0);
+    auto* modification =
+        program_.create_node<Modification>(
+            symbol(children[1], {":=", "+=", "-=", "*="}));
+    modification->set_type(type(children[1], ModType::Multiply));
+    return program_.create_node<Assignment>(
+        cell, varname, modification, expression(children[2]));
+  }
+
+  Boolexpr* boolexpr(NodeId node) {
+    const auto children = expect(node, Kind::Boolexpr, 3);
+    auto* operand1 = expression(children[0]);
+    expect(children[1], Kind::Booloperation, 0);
+    auto* booloperation =
+        program_.create_node<Booloperation>(
+            symbol(children[1], {"", "=", ">", "<", "<>", "<=", ">="}));
+    booloperation->set_type(type(children[1], BoolOp::NotLess));
+    auto* boolexpr = program_.create_node<Boolexpr>(
+        operand1, booloperation, expression(children[2]));
+    boolexpr->set_type(type(node, VarType::NoType));
+    return boolexpr;
+  }
+
+  Expression* expression(NodeId node) {
+    Expression* expression = nullptr;
+    switch (kind(node)) {
+      case Kind::Atom: {
+        const auto children = expect(node, Kind::Atom, 1, any);
+        signs_.clear();
+        for (size_t i = 0; i + 1 < children.size(); ++i) {
+          signs_.push_back(operation(children[i]));
+        }
+        const auto signs = program_.copy_nodes(signs_.data(), signs_.size());
+        expression = program_.create_node<Expression>(
+            nullptr,
+            nullptr,
+            nullptr,
+            signs,
+            value(children.back()),
+            false);
+        break;
+      }
+      case Kind::Brackets: {
+        const auto children = expect(node, Kind::Brackets, 1);
+        expression = program_.create_node<Expression>(
+            this->expression(children[0]),
+            nullptr,
+            nullptr,
+            Expression::Signs{},
+            nullptr,
+            true);
+        break;
+      }
+      case Kind::Binary: {
+        const auto children = expect(node, Kind::Binary, 3);
+        auto* lhs = this->expression(children[0]);
+        auto* op = operation(children[1]);
+        expression = program_.create_node<Expression>(
+            lhs,
+            op,
+            this->expression(children[2]),
+            Expression::Signs{},
+            nullptr,
+            false);
+        break;
+      }
+      default:
+        fail(node);
+    }
+    expression->set_type(type(node, VarType::NoType));
+    return expression;
+  }
+
+  Operation* operation(NodeId node) {
+    expect(node, Kind::Operation, 0);
+    auto* operation = program_.create_node<Operation>(
+        symbol(node, {"+", "-", "*", "div", "mod"}));
+    operation->set_type(type(node, Op::Mod));
+    return operation;
+  }
+
+  Value* value(NodeId node) {
+    switch (kind(node)) {
+      case Kind::Id:
+        return id(node);
+      case Kind::Cell:
+        return cell(node);
+      case Kind::Char:
+        return leaf<Char>(node, Kind::Char);
+      case Kind::Stringliteral:
+        return leaf<Stringliteral>(node, Kind::Stringliteral);
+      case Kind::Int:
+        return integer(node);
+      default:
+        fail(node);
+    }
+  }
+
+  Id* id(NodeId node) {
+    return leaf<Id>(node, Kind::Id);
+  }
+
+  // Codegen reads its digits as a decimal number.
+  Int* integer(NodeId node) {
+    auto* value = leaf<Int>(node, Kind::Int);
+    const auto& text = program_.symbols().text(value->symbol());
+    if (text.empty() || !std::all_of(text.begin(), text.end(), [](char c) {
+          return c >= '0' && c <= '9';
+        })) {
+      fail(node);
+    }
+    return value;
+  }
+
+  template <class T>
+  T* leaf(NodeId node, Kind kind) {
+    expect(node, kind, 0);
+    auto* value = program_.create_node<T>(symbol(node));
+    value->set_type(type(node, VarType::NoType));
+    return value;
+  }
+
+  // Its symbol is its Id's.
+  Cell* cell(NodeId node) {
+    const auto children = expect(node, Kind::Cell, 2);
+    auto* varname = id(children[0]);
+    auto* cell =
+        program_.create_node<Cell>(varname, expression(children[1]));
+    cell->set_type(type(node, VarType::NoType));
+    return cell;
+  }
+
+  const BinaryAst& ast_;
+  Program& program_;
+  // The program's id of each string.
+  std::vector<SymbolId> symbols_;
+  // An atom's signs before they are copied into the program's arena.
+  std::vector<Operation*> signs_;
+};
+
+bool BinaryAst::is_binary_ast(std::string_view bytes) {
+  return bytes.substr(0, sizeof(magic)) ==
+      std::string_view(magic, sizeof(magic));
+}
+
+void BinaryAst::write(
+    Program& program,
+    const SymbolTable* symbol_table,
+    std::ostream& out) {
+  write(FlatAst::flatten(program), symbol_table, out);
+}
+
+void BinaryAst::write(
+    const FlatAst& ast,
+    const SymbolTable* symbol_table,
+    std::ostream& out) {
+  const auto children = [&ast](NodeId node) { return ast.children(node); };
+  if (too_deep(ast.size(), children)) {
+    throw BinaryAstError(
+        "Binary AST: the program is nested deeper than " +
+        std::to_string(max_depth) + " levels");
+  }
+  const auto& interner = ast.interner();
+  std::unordered_map<SymbolId, uint32_t> indexes;
+  std::vector<uint32_t> string_ends{0};
+  std::string string_bytes;
+  const auto index = [&](SymbolId symbol) {
+    const auto [it, inserted] = indexes.try_emplace(
+        symbol, static_cast<uint32_t>(string_ends.size()));
+    if (inserted) {
+      string_bytes += interner.text(symbol);
+      if (string_bytes.size() > std::numeric_limits<uint32_t>::max()) {
+        throw BinaryAstError("Binary AST: too many symbols");
+      }
+      string_ends.push_back(static_cast<uint32_t>(string_bytes.size()));
+    }
+    return it->second;
+  };
+
+  std::vector<uint32_t> symbols(ast.size());
+  for (NodeId node = 0; node < ast.size(); ++node) {
+    if (has_symbol(ast.kind(node))) {
+      symbols[node] = index(ast.symbol(node));
+    }
+  }
+  std::vector<Entry> entries;
+  if (symbol_table != nullptr) {
+    entries.reserve(symbol_table->size());
+    for (const auto& [name, symbol] : *symbol_table) {
+      entries.push_back(
+          {index(name),
+           static_cast<uint8_t>(symbol.get_form()),
+           static_cast<uint8_t>(symbol.get_type()),
+           0});
+    }
+    // The table's order depends on its hashing; the file's should not.
+    std::sort(
+        entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+          return a.string_ < b.string_;
+        });
+  }
+
+  FileHeader header{};
+  std::memcpy(header.magic_, magic, sizeof(magic));
+  header.version_ = version;
+  header.byte_order_ = byte_order_mark;
+  header.flags_ = symbol_table != nullptr ? analysed_flag : 0;
+  header.node_count_ = static_cast<uint32_t>(ast.size());
+  header.child_count_ = static_cast<uint32_t>(ast.children_.size());
+  header.string_count_ = static_cast<uint32_t>(string_ends.size());
+  header.entry_count_ = static_cast<uint32_t>(entries.size());
+  header.string_bytes_ = static_cast<uint32_t>(string_bytes.size());
+
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  write_section(out, ast.kinds_.data(), ast.size());
+  write_section(out, ast.types_.data(), ast.size());
+  write_section(out, symbols.data(), sizeof(uint32_t) * symbols.size());
+  write_section(
+      out,
+      ast.first_child_.data(),
+      sizeof(uint32_t) * ast.first_child_.size());
+  write_section(
+      out, ast.children_.data(), sizeof(NodeId) * ast.children_.size());
+  write_section(
+      out, string_ends.data(), sizeof(uint32_t) * string_ends.size());
+  write_section(out, entries.data(), sizeof(Entry) * entries.size());
+  write_section(out, string_bytes.data(), string_bytes.size());
+}
+
+BinaryAst::BinaryAst(std::string_view bytes) {
+  static_assert(sizeof(Entry) == 8);
+  if (!is_binary_ast(bytes) || bytes.size() < sizeof(FileHeader)) {
+    throw BinaryAstError("Not a binary AST");
+  }
+  if (reinterpret_cast<uintptr_t>(bytes.data()) % alignof(uint64_t) != 0) {
+    copy_.resize(padded(bytes.size()) / sizeof(uint64_t));
+    std::memcpy(copy_.data(), bytes.data(), bytes.size());
+    bytes = std::string_view(
+        reinterpret_cast<const char*>(copy_.data()), bytes.size());
+  }
+
+  FileHeader header;
+  std::memcpy(&header, bytes.data(), sizeof(header));
+  if (header.byte_order_ != byte_order_mark) {
+    throw BinaryAstError("Binary AST written with another byte order");
+  }
+  if (header.version_ != version) {
+    throw BinaryAstError(
+        "Binary AST version " + std::to_string(header.version_) +
+        " is not supported");
+  }
+  if ((header.flags_ & ~analysed_flag) != 0) {
+    invalid("unknown flags");
+  }
+  const Layout layout(header, sizeof(Entry));
+  if (layout.size_ != bytes.size()) {
+    invalid("its size does not match its header");
+  }
+  if (header.node_count_ == 0 || header.string_count_ == 0) {
+    invalid("no nodes");
+  }
+
+  const auto* data = bytes.data();
+  analysed_ = (header.flags_ & analysed_flag) != 0;
+  node_count_ = header.node_count_;
+  kinds_ = reinterpret_cast<const Kind*>(data + layout.kinds_);
+  types_ = reinterpret_cast<const uint8_t*>(data + layout.types_);
+  symbols_ = reinterpret_cast<const uint32_t*>(data + layout.symbols_);
+  first_child_ =
+      reinterpret_cast<const uint32_t*>(data + layout.first_child_);
+  children_ = reinterpret_cast<const NodeId*>(data + layout.children_);
+  const auto* string_ends =
+      reinterpret_cast<const uint32_t*>(data + layout.string_ends_);
+  entries_ = reinterpret_cast<const Entry*>(data + layout.entries_);
+  entry_count_ = header.entry_count_;
+
+  // After these checks, every index is in bounds and the nodes form one
+  // tree in pre-order, no deeper than max_depth, so the Loader's walk ends
+  // after building each node once.
+  if (first_child_[0] != 0 ||
+      first_child_[node_count_] != header.child_count_) {
+    invalid("bad child offsets");
+  }
+  for (NodeId node = 0; node < node_count_; ++node) {
+    if (static_cast<uint8_t>(kinds_[node]) > static_cast<uint8_t>(Kind::Int) ||
+        symbols_[node] >= header.string_count_ ||
+        first_child_[node] > first_child_[node + 1]) {
+      invalid("bad node " + std::to_string(node));
+    }
+    for (auto n = first_child_[node]; n < first_child_[node + 1]; ++n) {
+      if (children_[n] <= node || children_[n] >= node_count_) {
+        invalid("bad child of node " + std::to_string(node));
+      }
+    }
+  }
+  check_tree();
+  for (size_t i = 0; i < entry_count_; ++i) {
+    if (entries_[i].string_ >= header.string_count_ ||
+        entries_[i].form_ > static_cast<uint8_t>(Form::NoForm) ||
+        entries_[i].type_ > static_cast<uint8_t>(VarType::NoType)) {
+      invalid("bad symbol table entry " + std::to_string(i));
+    }
+  }
+
+  const auto* text = data + layout.strings_;
+  strings_.reserve(header.string_count_);
+  uint32_t begin = 0;
+  for (uint32_t i = 0; i < header.string_count_; ++i) {
+    const auto end = string_ends[i];
+    if (end < begin || end > header.string_bytes_) {
+      invalid("bad string " + std::to_string(i));
+    }
+    strings_.emplace_back(text + begin, end - begin);
+    begin = end;
+  }
+}
+
+void BinaryAst::check_tree() const {
+  // In pre-order, a node's subtree is the nodes from it up to some end:
+  // its first child is the next node, and each other child starts where
+  // the previous child's subtree ends. Children come after their parents,
+  // so going backwards finds each child's end before its parent needs it.
+  // If the root's subtree is every node, each node but the root is the
+  // child of exactly one node.
+  std::vector<NodeId> ends(node_count_);
+  for (auto node = static_cast<NodeId>(node_count_); node-- != 0;) {
+    auto end = node + 1;
+    for (auto n = first_child_[node]; n < first_child_[node + 1]; ++n) {
+      if (children_[n] != end) {
+        invalid("node " + std::to_string(node) + " is not in pre-order");
+      }
+      end = ends[children_[n]];
+    }
+    ends[node] = end;
+  }
+  if (ends[0] != node_count_) {
+    invalid("nodes outside the tree");
+  }
+
+  const auto children = [this](NodeId node) {
+    return FlatAst::Children(
+        children_ + first_child_[node], children_ + first_child_[node + 1]);
+  };
+  if (too_deep(node_count_, children)) {
+    invalid("nested deeper than " + std::to_string(max_depth));
+  }
+}
+
+Program BinaryAst::program() const {
+  Program program;
+  Loader(*this, program).load();
+  return program;
+}
+
+SymbolTable BinaryAst::symbol_table(Program& program) const {
+  SymbolTable symbol_table;
+  symbol_table.reserve(entry_count_);
+  for (size_t i = 0; i < entry_count_; ++i) {
+    const auto& entry = entries_[i];
+    symbol_table.emplace(
+        program.symbols().intern(strings_[entry.string_]),
+        Symbol(
+            static_cast<Form>(entry.form_),
+            static_cast<VarType>(entry.type_)));
+  }
+  return symbol_table;
+}
+
+}  // namespace pascal::ast
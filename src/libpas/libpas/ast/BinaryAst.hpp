@@ -0,0 +1,110 @@
+#pragma once
+
+#include <libpas/ast/Ast.hpp>
+#include <libpas/ast/FlatAst.hpp>
+#include <libpas/ast/SymbolTable.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace pascal::ast {
+
+class BinaryAstError final : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+// A program stored as FlatAst's arrays, so that it loads without lexing or
+// parsing. The file is a 40-byte header, then these sections, each padded
+// to 8 bytes, in the byte order of the host that wrote it:
+//   kinds          node_count uint8_t (Kind)
+//   types          node_count uint8_t (FlatAst::type)
+//   symbols        node_count uint32_t, indexes into the strings
+//   first_child    node_count + 1 uint32_t
+//   children       child_count uint32_t (NodeId)
+//   string ends    string_count uint32_t, offsets past each string's end
+//   symbol table   entry_count 8-byte entries: a string index, the Form and
+//                  the VarType
+//   string bytes   the strings, back to back
+// String 0 is empty and stands for nodes without a symbol. A program written
+// after semantic analysis carries its node types and symbol table; otherwise
+// the types are unset and there is no table. Loading checks the nodes'
+// layout and the symbols that analysis looks up, not the types, so a loaded
+// program is analysed again before codegen.
+//
+// Loading reads the arrays where they are, e.g. in a file mapped by
+// SourceFile, and interns each string once into the new program's symbols.
+class BinaryAst final {
+ public:
+  static constexpr uint32_t version = 1;
+  // How deeply nodes may nest. The Loader recurses once per level, so a
+  // crafted file must not nest without bound. A program from source nests
+  // this deeply only in an expression with about a thousand operations or
+  // parentheses; write refuses it rather than write a file that would not
+  // load.
+  static constexpr uint32_t max_depth = 1024;
+
+  // Whether `bytes` start with the format's magic number, which no Pascal
+  // source does.
+  static bool is_binary_ast(std::string_view bytes);
+
+  // Writes `program` with its node types, and the symbol table semantic
+  // analysis returned for it, unless it is null. Throws BinaryAstError if
+  // the program nests deeper than max_depth, or has too many symbols.
+  static void write(
+      Program& program,
+      const SymbolTable* symbol_table,
+      std::ostream& out);
+  static void write(
+      const FlatAst& ast,
+      const SymbolTable* symbol_table,
+      std::ostream& out);
+
+  // Checks the header, that every section and index is in bounds and that
+  // the nodes form one tree in pre-order, no deeper than max_depth; throws
+  // BinaryAstError otherwise. `bytes` must outlive the BinaryAst.
+  explicit BinaryAst(std::string_view bytes);
+
+  // Whether it was written with a symbol table.
+  bool analysed() const { return analysed_; }
+  size_t node_count() const { return node_count_; }
+
+  // Builds the program, with the node types it was written with. Throws
+  // BinaryAstError if the nodes do not have the layout FlatAst documents.
+  Program program() const;
+  // Empty unless analysed(). Its names are interned into `program`, which
+  // program() returned.
+  SymbolTable symbol_table(Program& program) const;
+
+ private:
+  class Loader;
+
+  void check_tree() const;
+
+  struct Entry {
+    uint32_t string_;
+    uint8_t form_;
+    uint8_t type_;
+    uint16_t padding_;
+  };
+
+  // Holds the bytes when they are not aligned for the uint32_t sections.
+  std::vector<uint64_t> copy_;
+  bool analysed_ = false;
+  size_t node_count_ = 0;
+  const Kind* kinds_ = nullptr;
+  const uint8_t* types_ = nullptr;
+  const uint32_t* symbols_ = nullptr;
+  const uint32_t* first_child_ = nullptr;
+  const NodeId* children_ = nullptr;
+  const Entry* entries_ = nullptr;
+  size_t entry_count_ = 0;
+  // Views of the string bytes.
+  std::vector<std::string_view> strings_;
+};
+
+}  // namespace pascal::ast
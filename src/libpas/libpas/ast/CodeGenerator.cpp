@@ -1,29 +1,60 @@
 #include <libpas/ast/CodeGenerator.hpp>
 
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/Function.h>
+
 #include <algorithm>
+#include <iterator>
 #include <string_view>
 
 namespace pascal::ast {
 
-static std::string_view type_to_string(VarType type) {
-  switch (type) {
-    case VarType::CharType:
-      return "i8";
-    case VarType::IntegerType:
-      return "i32";
-    case VarType::StringType:
-      return "[255 x i8]";
-    default: /* do nothing */
-      break;
+static constexpr size_t string_size = 255;
+
+static llvm::CmpInst::Predicate to_predicate(BoolOp operation) {
+  switch (operation) {
+    case BoolOp::Equal:
+      return llvm::CmpInst::ICMP_EQ;
+    case BoolOp::MoreThen:
+      return llvm::CmpInst::ICMP_SGT;
+    case BoolOp::LessThen:
+      return llvm::CmpInst::ICMP_SLT;
+    case BoolOp::NotEqual:
+      return llvm::CmpInst::ICMP_NE;
+    case BoolOp::NotMore:
+      return llvm::CmpInst::ICMP_SLE;
+    case BoolOp::NotLess:
+      return llvm::CmpInst::ICMP_SGE;
   }
-  return "";
+  return llvm::CmpInst::ICMP_EQ;
 }
 
-void CodeGenerator::exec(
+CodeGenerator::CodeGenerator(SymbolTable& symbol_table, llvm::Module& module)
+    : symbol_table_(symbol_table),
+      module_(module),
+      context_(module.getContext()),
+      builder_(context_) {
+  main_ = llvm::Function::Create(
+      llvm::FunctionType::get(builder_.getInt32Ty(), false),
+      llvm::Function::ExternalLinkage,
+      "main",
+      module_);
+  builder_.SetInsertPoint(llvm::BasicBlock::Create(context_, "start", main_));
+}
+
+std::unique_ptr<llvm::Module> CodeGenerator::exec(
     Program& program,
     SymbolTable& symbol_table,
-    std::ostream& out) {
-  CodeGenerator code_generator(symbol_table);
+    llvm::LLVMContext& context) {
+  const auto& symbols = program.symbols();
+  auto module = std::make_unique<llvm::Module>(
+      symbols.text(program.get_header()->progname()->symbol()), context);
+  module->setTargetTriple("x86_64-pc-linux-gnu");
+
+  CodeGenerator code_generator(symbol_table, *module);
+  code_generator.symbols_ = &symbols;
   auto* constdecl = program.get_constdecl();
   if (constdecl != nullptr) {
     constdecl->accept(code_generator);
@@ -33,300 +64,170 @@ void CodeGenerator::exec(
     vardecl->accept(code_generator);
   }
   program.get_block()->accept(code_generator);
-  code_generator.generate_file(out);
-}
-
-void CodeGenerator::generate_file(std::ostream& out) {
-  out << "target triple = \"x86_64-pc-linux-gnu\"\n"
-         "declare i32 @printf(i8* %format, ...)\n"
-         "declare i32 @__isoc99_scanf(i8*, ...)\n";
-
-  if (strings_) {
-    out << "declare i8* @strcpy(i8* %dst, i8* %src)\n"
-           "declare i8* @strcat(i8* %dst, i8* %src)\n\n"
-           "@.str.empty = constant [1 x i8] c\"\\00\"\n"
-           "define void @strinit([255 x i8]* %str) {\n"
-           "  %str.ptr = getelementptr [255 x i8], [255 x i8]* %str, i64 0, "
-           "i64 0\n"
-           "  call i8* @strcpy(i8* %str.ptr, i8* getelementptr ([1 x i8], [1 x "
-           "i8]* @.str.empty, i64 0, i64 0))\n"
-           "  ret void\n}\n\n";
-  } else {
-    out << "\n";
-  }
-
-  if (char_convert_) {
-    out << "@.str.c = constant [2 x i8] c\"*\\00\"\n"
-           "define i8* @tostr(i8 %c, [255 x i8]* %str) {\n"
-           "  %str.ptr = getelementptr [255 x i8], [255 x i8]* %str, i64 0, "
-           "i64 0\n"
-           "  call i8* @strcpy(i8* %str.ptr, i8* getelementptr ([2 x i8], [2 x "
-           "i8]* @.str.c, i64 0, i64 0))\n"
-           "  store i8 %c, i8* %str.ptr\n"
-           "  ret i8* %str.ptr\n}\n\n";
-  }
-
-  if (write_int_ || read_int_) {
-    out << "@.str.int = constant [3 x i8] c\"%d\\00\"\n";
-  }
-  if (write_char_ || read_char_) {
-    out << "@.str.char = constant [3 x i8] c\"%c\\00\"\n";
-  }
-  if (write_string_ || read_string_) {
-    out << "@.str.str = constant [3 x i8] c\"%s\\00\"\n";
-  }
-
-  out << "\n";
-
-  if (read_int_) {
-    out << "define void @read_int(i32* %x) {\n"
-           "  call i32 (i8*, ...) @__isoc99_scanf(i8* getelementptr  "
-           "([3 x i8], [3 x i8]* @.str.int, i64 0, i64 0), i32* %x)\n"
-           "  ret void\n"
-           "}\n\n";
-  }
-
-  if (read_char_) {
-    out << "define void @read_char(i8* %x) {\n"
-           "  call i32 (i8*, ...) @__isoc99_scanf(i8* getelementptr  "
-           "([3 x i8], [3 x i8]* @.str.char, i64 0, i64 0), i8* %x)\n"
-           "  ret void\n"
-           "}\n\n";
-  }
-
-  if (read_string_) {
-    out << "define void @read_string(i8* %x) {\n"
-           "  call i32 (i8*, ...) @__isoc99_scanf(i8* getelementptr  "
-           "([3 x i8], [3 x i8]* @.str.str, i64 0, i64 0), i8* %x)\n"
-           "  ret void\n"
-           "}\n\n";
-  }
-
-  if (write_int_) {
-    out << "define void @write_int(i32 %x) {\n"
-           "  call i32 (i8*, ...) @printf(i8* getelementptr ([3 x i8], [3 x "
-           "i8]* @.str.int, i64 0, i64 0), i32 %x)\n"
-           "  ret void\n"
-           "}\n\n";
-  }
+  code_generator.builder_.CreateRet(code_generator.builder_.getInt32(0));
+  return module;
+}
 
-  if (write_char_) {
-    out << "define void @write_char(i32 %x) {\n"
-           "  call i32 (i8*, ...) @printf(i8* getelementptr ([3 x i8], [3 x "
-           "i8]* @.str.char, i64 0, i64 0), i32 %x)\n"
-           "  ret void\n"
-           "}\n\n";
-  }
+std::unique_ptr<llvm::Module> CodeGenerator::exec(
+    const FlatAst& ast,
+    SymbolTable& symbol_table,
+    llvm::LLVMContext& context) {
+  const auto children = ast.children(0);
+  auto module = std::make_unique<llvm::Module>(
+      ast.text(ast.child(children[0], 0)), context);
+  module->setTargetTriple("x86_64-pc-linux-gnu");
 
-  if (write_string_) {
-    out << "define void @write_string(i8* %x) {\n"
-           "  call i32 (i8*, ...) @printf(i8* getelementptr ([3 x i8], [3 x "
-           "i8]* @.str.str, i64 0, i64 0), i8* %x)\n"
-           "  ret void\n"
-           "}\n\n";
+  CodeGenerator code_generator(symbol_table, *module);
+  code_generator.ast_ = &ast;
+  for (size_t i = 1; i < children.size(); ++i) {
+    code_generator.generate(children[i]);
   }
+  code_generator.builder_.CreateRet(code_generator.builder_.getInt32(0));
+  return module;
+}
 
-  if (writeln_int_) {
-    out << "@.str.intln = constant [4 x i8] c\"%d\\0A\\00\"\n"
-           "define void @writeln_int(i32 %x) {\n"
-           "  call i32 (i8*, ...) @printf(i8* getelementptr ([4 x i8], [4 x "
-           "i8]* @.str.intln, i64 0, i64 0), i32 %x)\n"
-           "  ret void\n"
-           "}\n\n";
+llvm::Type* CodeGenerator::get_type(VarType type) {
+  switch (type) {
+    case VarType::CharType:
+      return builder_.getInt8Ty();
+    case VarType::IntegerType:
+      return builder_.getInt32Ty();
+    case VarType::StringType:
+      return llvm::ArrayType::get(builder_.getInt8Ty(), string_size);
+    default: /* do nothing */
+      break;
   }
+  return nullptr;
+}
 
-  if (writeln_char_) {
-    out << "@.str.charln = constant [4 x i8] c\"%c\\0A\\00\"\n"
-           "define void @writeln_char(i32 %x) {\n"
-           "  call i32 (i8*, ...) @printf(i8* getelementptr ([4 x i8], [4 x "
-           "i8]* @.str.charln, i64 0, i64 0), i32 %x)\n"
-           "  ret void\n"
-           "}\n\n";
+llvm::FunctionCallee CodeGenerator::get_function(std::string_view name) {
+  auto* int8_ptr = builder_.getInt8PtrTy();
+  llvm::FunctionType* type = nullptr;
+  if (name == "printf" || name == "__isoc99_scanf") {
+    type = llvm::FunctionType::get(builder_.getInt32Ty(), {int8_ptr}, true);
+  } else if (name == "strcmp") {
+    type = llvm::FunctionType::get(
+        builder_.getInt32Ty(), {int8_ptr, int8_ptr}, false);
+  } else {
+    type = llvm::FunctionType::get(int8_ptr, {int8_ptr, int8_ptr}, false);
   }
+  return module_.getOrInsertFunction(name, type);
+}
 
-  if (writeln_string_) {
-    out << "@.str.strln = constant [4 x i8] c\"%s\\0A\\00\"\n"
-           "define void @writeln_string(i8* %x) {\n"
-           "  call i32 (i8*, ...) @printf(i8* getelementptr ([4 x i8], [4 x "
-           "i8]* @.str.strln, i64 0, i64 0), i8* %x)\n"
-           "  ret void\n"
-           "}\n\n";
+llvm::Constant* CodeGenerator::get_string(std::string_view text) {
+  auto it = strings_.find(std::string(text));
+  if (it == strings_.end()) {
+    it = strings_
+             .emplace(text, builder_.CreateGlobalStringPtr(text, ".str"))
+             .first;
   }
+  return it->second;
+}
 
-  const auto conststrings = conststrings_.str();
-  if (!conststrings.empty()) {
-    out << conststrings << "\n";
+llvm::AllocaInst* CodeGenerator::create_alloca(
+    llvm::Type* type,
+    const std::string& name) {
+  auto& entry = main_->getEntryBlock();
+  llvm::IRBuilder<> builder(&entry, entry.begin());
+  if (last_alloca_ != nullptr) {
+    builder.SetInsertPoint(&entry, std::next(last_alloca_->getIterator()));
   }
+  last_alloca_ = builder.CreateAlloca(type, nullptr, name);
+  return last_alloca_;
+}
 
-  out << "define i32 @main() {\n"
-         "start:\n"
-      << ss_.str() << "  ret i32 0\n}\n";
+llvm::Value* CodeGenerator::get_string_ptr(SymbolId name) {
+  auto* address = addresses_.at(name);
+  return builder_.CreateConstGEP2_64(
+      address->getAllocatedType(), address, 0, 0);
 }
 
-void CodeGenerator::write_function(VarType type) {
-  switch (type) {
-    case VarType::IntegerType:
-      write_int_ = true;
-      ss_ << "  call void @write_int(i32 %." << vars_ << ")\n";
-      break;
-    case VarType::CharType:
-      write_char_ = true;
-      ++vars_;
-      ss_ << "  %." << vars_ << " = sext i8 %." << vars_ - 1
-          << " to i32\n"
-             "  call void @write_char(i32 %."
-          << vars_ << ")\n";
-      break;
-    case VarType::StringType:
-      write_string_ = true;
-      ss_ << "  call void @write_string(i8* %." << vars_ << ")\n";
-      break;
-    default: /* do nothing */
-      return;
-  }
+llvm::Value* CodeGenerator::to_string(llvm::Value* ch) {
+  auto* type = llvm::ArrayType::get(builder_.getInt8Ty(), 2);
+  auto* str = create_alloca(type, "chr");
+  auto* str_ptr = builder_.CreateConstGEP2_64(type, str, 0, 0);
+  builder_.CreateStore(ch, str_ptr);
+  builder_.CreateStore(
+      builder_.getInt8(0), builder_.CreateConstGEP2_64(type, str, 0, 1));
+  return str_ptr;
 }
 
-void CodeGenerator::writeln_function(VarType type) {
+void CodeGenerator::write_function(VarType type, bool newline) {
+  auto* value = value_;
+  std::string format;
   switch (type) {
     case VarType::IntegerType:
-      writeln_int_ = true;
-      ss_ << "  call void @writeln_int(i32 %." << vars_ << ")\n";
+      format = "%d";
       break;
     case VarType::CharType:
-      writeln_char_ = true;
-      ++vars_;
-      ss_ << "  %." << vars_ << " = sext i8 %." << vars_ - 1
-          << " to i32\n"
-             "  call void @writeln_char(i32 %."
-          << vars_ << ")\n";
+      format = "%c";
+      value = builder_.CreateSExt(value, builder_.getInt32Ty());
       break;
     case VarType::StringType:
-      writeln_string_ = true;
-      ss_ << "  call void @writeln_string(i8* %." << vars_ << ")\n";
+      format = "%s";
       break;
     default: /* do nothing */
       return;
   }
+  if (newline) {
+    format += "\n";
+  }
+  builder_.CreateCall(get_function("printf"), {get_string(format), value});
 }
 
-void CodeGenerator::read_function(VarType type, size_t var) {
+void CodeGenerator::read_function(VarType type, llvm::Value* ptr) {
+  std::string_view format;
   switch (type) {
     case VarType::IntegerType:
-      read_int_ = true;
-      ss_ << "  call void @read_int(i32* %." << var << ")\n";
+      format = "%d";
       break;
     case VarType::CharType:
-      read_char_ = true;
-      ss_ << "  call void @read_char(i8* %." << var << ")\n";
+      format = "%c";
       break;
     case VarType::StringType:
-      read_string_ = true;
-      ss_ << "  call void @read_string(i8* %." << var << ")\n";
+      format = "%s";
       break;
     default: /* do nothing */
       return;
   }
+  builder_.CreateCall(
+      get_function("__isoc99_scanf"), {get_string(format), ptr});
 }
 
-void CodeGenerator::load_variable(VarType type) {
-  const auto string_type = type_to_string(type);
-  ++vars_;
-  ss_ << "  %." << vars_ << " = load " << string_type << ", " << string_type
-      << "* %." << vars_ - 1 << "\n";
-}
-
-void CodeGenerator::add_op(Expr& expr, size_t i, std::string_view operation) {
-  const auto op1 = expr.operands[i];
-  const auto op2 = expr.operands[i + 1];
-  ++vars_;
-  ss_ << "  %." << vars_ << " = " << operation << " i32 %." << op1 << ", %."
-      << op2 << "\n";
-  expr.operands[i] = vars_;
-  expr.operands.erase(expr.operands.begin() + i + 1);
-  expr.operations.erase(expr.operations.begin() + i);
-}
-
-void CodeGenerator::parse_stacks(Expr& expr) {
-  size_t i = 0;
-  while (i < expr.operations.size()) {
-    if (expr.operations[i] == Op::Star) {
-      add_op(expr, i, "mul");
-    } else if (expr.operations[i] == Op::Div) {
-      add_op(expr, i, "sdiv");
-    } else if (expr.operations[i] == Op::Mod) {
-      add_op(expr, i, "srem");
-    } else {
-      ++i;
-    }
-  }
-  while (!expr.operations.empty()) {
-    if (expr.operations[0] == Op::Plus) {
-      add_op(expr, 0, "add");
-    } else {
-      add_op(expr, 0, "sub");
-    }
+llvm::Value* CodeGenerator::create_operation(
+    Op operation,
+    llvm::Value* lhs,
+    llvm::Value* rhs) {
+  switch (operation) {
+    case Op::Plus:
+      return builder_.CreateAdd(lhs, rhs);
+    case Op::Minus:
+      return builder_.CreateSub(lhs, rhs);
+    case Op::Star:
+      return builder_.CreateMul(lhs, rhs);
+    case Op::Div:
+      return builder_.CreateSDiv(lhs, rhs);
+    case Op::Mod:
+      return builder_.CreateSRem(lhs, rhs);
   }
+  return nullptr;
 }
 
-void CodeGenerator::parse_expression(Expression& expression, Expr& expr) {
-  auto* atom = expression.atom();
-  if (atom != nullptr) {
-    atom->accept(*this);
-    const auto& signs = expression.signs();
-    if (!signs.empty()) {
-      auto minus = static_cast<bool>(
-          std::count_if(
-              signs.begin(),
-              signs.end(),
-              [](auto* sign) { return sign->type() == Op::Minus; }) %
-          2);
-      if (minus) {
-        ++vars_;
-        ss_ << "  %." << vars_ << " = sub i32 0, %." << vars_ - 1 << "\n";
-      }
-    }
-    expr.operands.push_back(vars_);
-    return;
-  }
-
-  if (expression.brackets()) {
-    Expr subexpr;
-    parse_expression(*(expression.operands()[0]), subexpr);
-    parse_stacks(subexpr);
-    expr.operands.push_back(vars_);
-    return;
-  }
-  parse_expression(*(expression.operands()[0]), expr);
-  expr.operations.push_back(expression.operation()->type());
-  parse_expression(*(expression.operands()[1]), expr);
-}
-
-VarType CodeGenerator::get_ptr(Cell& value) {
+llvm::Value* CodeGenerator::get_ptr(Cell& value) {
   value.index()->accept(*this);
-  const auto it = symbol_table_.find(value.text())->second;
+  auto* index = value_;
+  const auto& it = symbol_table_.find(value.symbol())->second;
 
   if (it.get_type() == VarType::StringType) {
-    vars_ += 3;
-    ss_ << "  %." << vars_ - 2 << " = sub nsw i32 %." << vars_ - 3 << ", 1\n"
-        << "  %." << vars_ - 1 << " = sext i32 %." << vars_ - 2
-        << " to i64\n  %." << vars_
-        << " = getelementptr [255 x i8], [255 x i8]* %." << it.get_addr()
-        << ", i64 0, i64 %." << vars_ - 1 << "\n";
-    return VarType::CharType;
+    index = builder_.CreateNSWSub(index, builder_.getInt32(1));
+  } else if (it.get_min_index() != 0) {
+    index = builder_.CreateSub(index, builder_.getInt32(it.get_min_index()));
   }
+  index = builder_.CreateSExt(index, builder_.getInt64Ty());
 
-  const auto type = type_to_string(it.get_type());
-  if (it.get_min_index() != 0) {
-    ++vars_;
-    ss_ << "  %." << vars_ << " = sub i32 %." << vars_ - 1 << ", "
-        << it.get_min_index() << "\n";
-  }
-  vars_ += 2;
-  ss_ << "  %." << vars_ - 1 << " = sext i32 %." << vars_ - 2 << " to i64\n  %."
-      << vars_ << " = getelementptr [" << it.get_size() << " x " << type
-      << "], [" << it.get_size() << " x " << type << "]* %." << it.get_addr()
-      << ", i64 0, i64 %." << vars_ - 1 << "\n";
-  return it.get_type();
+  auto* address = addresses_.at(value.symbol());
+  return builder_.CreateGEP(
+      address->getAllocatedType(), address, {builder_.getInt64(0), index});
 }
 
 void CodeGenerator::visit(Header& member) {
@@ -342,92 +243,86 @@ void CodeGenerator::visit(Constdecl& member) {
 
 void CodeGenerator::visit(Constdeclaration& member) {
   member.expression()->accept(*this);
-  auto& it = symbol_table_.find(member.constname()->text())->second;
-  const auto type = type_to_string(it.get_type());
-  ++vars_;
-  ss_ << "  %." << vars_ << " = alloca " << type << "\n";
-  it.set_addr(vars_);
+  const auto name = member.constname()->symbol();
+  const auto& it = symbol_table_.find(name)->second;
+  addresses_[name] =
+      create_alloca(get_type(it.get_type()), text(*member.constname()));
   if (it.get_type() == VarType::StringType) {
-    strings_ = true;
-    ss_ << "  call void @strinit([255 x i8]* %." << vars_ << ")\n";
+    builder_.CreateCall(
+        get_function("strcpy"), {get_string_ptr(name), value_});
   } else {
-    ss_ << "  store " << type << " %." << vars_ - 1 << ", " << type << "* %."
-        << vars_ << "\n";
+    builder_.CreateStore(value_, addresses_[name]);
   }
 }
 
 void CodeGenerator::visit(Expression& member) {
-  if (member.type() == VarType::StringType) {
-    member.atom()->accept(*this);
+  // The parsers group operations by precedence, so the tree is evaluated
+  // as it stands.
+  auto* atom = member.atom();
+  if (atom != nullptr) {
+    atom->accept(*this);
+    const auto signs = member.signs();
+    const auto minus = std::count_if(
+                           signs.begin(),
+                           signs.end(),
+                           [](auto* sign) {
+                             return sign->type() == Op::Minus;
+                           }) %
+        2;
+    if (minus != 0) {
+      value_ = builder_.CreateNeg(value_);
+    }
     return;
   }
-  Expr expr;
-  parse_expression(member, expr);
-  if (!expr.operations.empty()) {
-    parse_stacks(expr);
+
+  member.lhs()->accept(*this);
+  if (member.brackets()) {
+    return;
   }
+  auto* lhs = value_;
+  member.rhs()->accept(*this);
+  value_ = create_operation(member.operation()->type(), lhs, value_);
 }
 
 void CodeGenerator::visit(Boolexpr& member) {
   member.operand1()->accept(*this);
-  const auto op1 = vars_;
+  auto* op1 = value_;
   member.operand2()->accept(*this);
-  const auto op2 = vars_;
-  const auto type = type_to_string(member.type());
-  std::string operation;
+  auto* op2 = value_;
 
-  switch (member.booloperation()->type()) {
-    case BoolOp::Equal:
-      operation = "eq";
-      break;
-    case BoolOp::MoreThen:
-      operation = "sgt";
-      break;
-    case BoolOp::LessThen:
-      operation = "slt";
-      break;
-    case BoolOp::NotEqual:
-      operation = "ne";
-      break;
-    case BoolOp::NotMore:
-      operation = "sle";
-      break;
-    case BoolOp::NotLess:
-      operation = "sge";
-      break;
+  if (member.type() == VarType::StringType) {
+    op1 = builder_.CreateCall(get_function("strcmp"), {op1, op2});
+    op2 = builder_.getInt32(0);
   }
-  ++vars_;
-  ss_ << "  %." << vars_ << " = icmp " << operation << " " << type << "%."
-      << op1 << ", %." << op2 << "\n";
+
+  value_ = builder_.CreateICmp(
+      to_predicate(member.booloperation()->type()), op1, op2);
 }
 
 void CodeGenerator::visit(Vardecl& member) {
   for (const auto& variable : member.declarations()) {
     variable->accept(*this);
   }
-  ss_ << "\n";
 }
 
 void CodeGenerator::visit(Declaration& member) {
   for (const auto& varname : member.varnames()) {
-    ++vars_;
-    ss_ << "  %." << vars_ << " = alloca ";
-    auto& it = symbol_table_.find(varname->text())->second;
-    const auto type = type_to_string(it.get_type());
-    it.set_addr(vars_);
+    const auto name = varname->symbol();
+    auto& it = symbol_table_.find(name)->second;
+    auto* type = get_type(it.get_type());
     if (it.get_form() == Form::Variable) {
-      ss_ << type << "\n";
+      addresses_[name] = create_alloca(type, text(*varname));
       if (it.get_type() == VarType::StringType) {
-        strings_ = true;
-        ss_ << "  call void @strinit([255 x i8]* %." << vars_ << ")\n";
+        builder_.CreateStore(builder_.getInt8(0), get_string_ptr(name));
       }
     } else {
       auto* array_node = dynamic_cast<Arraytype*>(member.vartype());
       const auto min_index =
-          std::stoi(array_node->interval()->lborder()->text());
+          std::stoi(text(*array_node->interval()->lborder()));
       const auto size =
-          std::stoi(array_node->interval()->rborder()->text()) - min_index;
-      ss_ << "[" << size << " x " << type << "]\n";
+          std::stoi(text(*array_node->interval()->rborder())) - min_index + 1;
+      addresses_[name] =
+          create_alloca(llvm::ArrayType::get(type, size), text(*varname));
       it.set_array_data(std::make_pair(min_index, size));
     }
   }
@@ -455,171 +350,126 @@ void CodeGenerator::visit(Block& statement) {
 }
 
 void CodeGenerator::visit(Functioncall& statement) {
-  if (statement.functionname()->type() == FuncName::Write) {
-    for (const auto& variable : statement.variables()) {
-      variable->accept(*this);
-      write_function(variable->type());
-    }
-    for (const auto& argument : statement.arguments()) {
-      argument->accept(*this);
-      write_function(argument->type());
-    }
-    ss_ << "\n";
-  } else if (statement.functionname()->type() == FuncName::Writeln) {
-    auto variable = statement.variables().begin();
-    while (variable != statement.variables().end() &&
-           variable + 1 != statement.variables().end()) {
-      (*variable)->accept(*this);
-      write_function((*variable)->type());
-      ++variable;
-    }
-    if (variable != statement.variables().end()) {
-      (*variable)->accept(*this);
-      writeln_function((*variable)->type());
-    }
-    auto argument = statement.arguments().begin();
-    while (argument != statement.arguments().end() &&
-           argument + 1 != statement.arguments().end()) {
-      (*argument)->accept(*this);
-      write_function((*argument)->type());
-      ++argument;
-    }
-    if (argument != statement.arguments().end()) {
-      (*argument)->accept(*this);
-      writeln_function((*argument)->type());
-    }
-    ss_ << "\n";
-  } else if (statement.functionname()->type() == FuncName::Readln) {
+  const auto function = statement.functionname()->type();
+  if (function == FuncName::Readln) {
     for (const auto& variable : statement.variables()) {
-      const auto& it = symbol_table_.find(variable->text())->second;
+      const auto& it = symbol_table_.find(variable->symbol())->second;
       if (variable->type() == VarType::StringType) {
         variable->accept(*this);
-        read_function(variable->type(), vars_);
+        read_function(variable->type(), value_);
       } else if (
           it.get_form() == Form::Array ||
           it.get_type() == VarType::StringType) {
-        const auto type = get_ptr(*(dynamic_cast<Cell*>(variable)));
-        read_function(type, vars_);
+        auto* ptr = get_ptr(*(dynamic_cast<Cell*>(variable)));
+        read_function(variable->type(), ptr);
       } else {
-        read_function(it.get_type(), it.get_addr());
+        read_function(it.get_type(), addresses_.at(variable->symbol()));
       }
     }
-    ss_ << "\n";
+    return;
+  }
+
+  const auto newline = function == FuncName::Writeln;
+  const auto& variables = statement.variables();
+  for (size_t i = 0; i < variables.size(); ++i) {
+    variables[i]->accept(*this);
+    write_function(
+        variables[i]->type(), newline && i + 1 == variables.size());
+  }
+  const auto& arguments = statement.arguments();
+  for (size_t i = 0; i < arguments.size(); ++i) {
+    arguments[i]->accept(*this);
+    write_function(
+        arguments[i]->type(), newline && i + 1 == arguments.size());
   }
 }
 
 void CodeGenerator::visit(Assignment& statement) {
   statement.expression()->accept(*this);
+  auto* rvalue = value_;
   auto* cell = statement.cell();
   auto* varname = statement.varname();
+  const auto modification = statement.modification()->type();
+
   if (cell == nullptr && varname->type() == VarType::StringType) {
     if (statement.expression()->type() == VarType::CharType) {
-      char_convert_ = true;
-      vars_ += 2;
-      ss_ << "  %." << vars_ - 1
-          << " = alloca [255 x i8]\n"
-             "  %."
-          << vars_ << " = call i8* @tostr(i8 %." << vars_ - 2
-          << ", [255 x i8]* %." << vars_ - 1 << ")\n\n";
-    }
-    const auto& it = symbol_table_.find(varname->text())->second;
-    ++vars_;
-    ss_ << "  %." << vars_ << " = getelementptr [255 x i8], [255 x i8]* %."
-        << it.get_addr() << ", i64 0, i64 0\n";
-    if (statement.modification()->type() == ModType::Assignment) {
-      ss_ << "  call i8* @strcpy(i8* %." << vars_ << ", i8* %." << vars_ - 1
-          << ")\n";
-    } else {
-      ss_ << "  call i8* @strcat(i8* %." << vars_ << ", i8* %." << vars_ - 1
-          << ")\n";
+      rvalue = to_string(rvalue);
     }
+    const auto* function =
+        modification == ModType::Assignment ? "strcpy" : "strcat";
+    builder_.CreateCall(
+        get_function(function), {get_string_ptr(varname->symbol()), rvalue});
     return;
   }
-  const auto rvalue = vars_;
-  if (statement.modification()->type() != ModType::Assignment) {
-    if (cell != nullptr) {
-      cell->accept(*this);
-    } else {
-      varname->accept(*this);
-    }
-    std::string operation;
-    switch (statement.modification()->type()) {
+
+  auto* ptr =
+      cell != nullptr ? get_ptr(*cell) : addresses_.at(varname->symbol());
+  if (modification != ModType::Assignment) {
+    auto* type = get_type(cell != nullptr ? cell->type() : varname->type());
+    auto* lvalue = builder_.CreateLoad(type, ptr);
+    switch (modification) {
       case ModType::Add:
-        operation = "add";
+        rvalue = builder_.CreateAdd(lvalue, rvalue);
         break;
       case ModType::Reduce:
-        operation = "sub";
+        rvalue = builder_.CreateSub(lvalue, rvalue);
         break;
       case ModType::Multiply:
-        operation = "mul";
+        rvalue = builder_.CreateMul(lvalue, rvalue);
         break;
       default: /* do nothing */
         break;
     }
-    ++vars_;
-    ss_ << "  %." << vars_ << " = " << operation << " i32 %." << vars_ - 1
-        << ", %." << rvalue << "\n";
-  }
-  if (cell == nullptr) {
-    const auto& it = symbol_table_.find(varname->text())->second;
-    const auto type = type_to_string(it.get_type());
-    ss_ << "  store " << type << " %." << vars_ << ", " << type << "* %."
-        << it.get_addr() << "\n";
-  } else {
-    const auto& it = symbol_table_.find(cell->varname()->text())->second;
-    std::string type;
-    if (it.get_type() == VarType::StringType) {
-      type = "i8";
-    } else {
-      type = type_to_string(it.get_type());
-    }
-    if (statement.modification()->type() == ModType::Assignment) {
-      get_ptr(*cell);
-      ss_ << "  store " << type << " %." << rvalue << ", " << type << "* %."
-          << vars_ << "\n";
-    } else {
-      ss_ << "  store " << type << " %." << vars_ << ", " << type << "* %."
-          << vars_ - 2 << "\n";
-    }
   }
+  builder_.CreateStore(rvalue, ptr);
 }
 
 void CodeGenerator::visit(While& statement) {
-  ++vars_;
-  const auto condition_branch = vars_;
-  ss_ << "  br label %." << condition_branch << "\n\n." << condition_branch
-      << ":\n";
+  auto* condition_branch = llvm::BasicBlock::Create(context_, "while.cond");
+  auto* body_branch = llvm::BasicBlock::Create(context_, "while.body");
+  auto* end_branch = llvm::BasicBlock::Create(context_, "while.end");
+
+  builder_.CreateBr(condition_branch);
+  condition_branch->insertInto(main_);
+  builder_.SetInsertPoint(condition_branch);
   statement.boolexpr()->accept(*this);
-  const auto branch1 = vars_ + 1;
-  const auto branch2 = vars_ + 2;
-  ss_ << "  br i1 %." << vars_ << ", label %." << branch1 << ", label %."
-      << branch2 << "\n\n." << branch1 << ":\n";
-  vars_ += 2;
+  builder_.CreateCondBr(value_, body_branch, end_branch);
+
+  body_branch->insertInto(main_);
+  builder_.SetInsertPoint(body_branch);
   statement.statement()->accept(*this);
-  ss_ << "  br label %." << condition_branch << "\n\n." << branch2 << ":\n";
+  builder_.CreateBr(condition_branch);
+
+  end_branch->insertInto(main_);
+  builder_.SetInsertPoint(end_branch);
 }
 
 void CodeGenerator::visit(Branch& statement) {
+  auto* alternative = statement.alternative();
+  auto* then_branch = llvm::BasicBlock::Create(context_, "if.then");
+  auto* else_branch = alternative != nullptr
+      ? llvm::BasicBlock::Create(context_, "if.else")
+      : nullptr;
+  auto* end_branch = llvm::BasicBlock::Create(context_, "if.end");
+
   statement.boolexpr()->accept(*this);
-  const auto branch1 = vars_ + 1;
-  const auto branch2 = vars_ + 2;
-  ss_ << "  br i1 %." << vars_ << ", label %." << branch1 << ", label %."
-      << branch2 << "\n\n." << branch1 << ":\n";
+  builder_.CreateCondBr(
+      value_, then_branch, else_branch != nullptr ? else_branch : end_branch);
 
-  auto* alternative = statement.alternative();
-  if (alternative != nullptr) {
-    vars_ += 3;
-    const auto branch3 = vars_;
-    statement.statement()->accept(*this);
-    ss_ << "  br label %." << branch3 << "\n\n." << branch2 << ":\n";
+  then_branch->insertInto(main_);
+  builder_.SetInsertPoint(then_branch);
+  statement.statement()->accept(*this);
+  builder_.CreateBr(end_branch);
+
+  if (else_branch != nullptr) {
+    else_branch->insertInto(main_);
+    builder_.SetInsertPoint(else_branch);
     alternative->accept(*this);
-    ss_ << "  br label %." << branch3 << "\n\n." << branch3 << ":\n";
-    return;
+    builder_.CreateBr(end_branch);
   }
 
-  vars_ += 2;
-  statement.statement()->accept(*this);
-  ss_ << "  br label %." << branch2 << "\n\n." << branch2 << ":\n";
+  end_branch->insertInto(main_);
+  builder_.SetInsertPoint(end_branch);
 }
 
 void CodeGenerator::visit(Operation& value) {
@@ -643,46 +493,328 @@ void CodeGenerator::visit(Functionname& value) {
 }
 
 void CodeGenerator::visit(Id& value) {
-  auto it = symbol_table_.find(value.text())->second;
-  ++vars_;
   if (value.type() == VarType::StringType) {
-    ss_ << "  %." << vars_ << " = getelementptr [255 x i8], [255 x i8]* %."
-        << it.get_addr() << ", i64 0, i64 0\n\n";
+    value_ = get_string_ptr(value.symbol());
     return;
   }
-  const auto type = type_to_string(it.get_type());
-  ss_ << "  %." << vars_ << " = load " << type << ", " << type << "* %."
-      << it.get_addr() << "\n\n";
+  const auto& it = symbol_table_.find(value.symbol())->second;
+  value_ = builder_.CreateLoad(
+      get_type(it.get_type()), addresses_.at(value.symbol()), text(value));
 }
 
 void CodeGenerator::visit(Cell& value) {
-  load_variable(get_ptr(value));
+  auto* ptr = get_ptr(value);
+  value_ = builder_.CreateLoad(get_type(value.type()), ptr);
 }
 
 void CodeGenerator::visit(Char& value) {
-  ++vars_;
-  ss_ << "  %." << vars_ << " = alloca i8\n"
-      << "  store i8 " << static_cast<int>(value.text()[0]) << ", i8* %."
-      << vars_ << "\n";
-  load_variable(value.type());
-  ss_ << "\n";
+  value_ = builder_.getInt8(static_cast<uint8_t>(text(value)[0]));
 }
 
 void CodeGenerator::visit(Stringliteral& value) {
-  const auto size = value.text().size() + 1;
-  vars_ += 2;
-  conststrings_ << "@.str." << vars_ - 1 << " = constant [" << size
-                << " x i8] c\"" << value.text() << "\\00\"\n";
-  ss_ << "  %." << vars_ << " = getelementptr [" << size << " x i8], [" << size
-      << " x i8]* @.str." << vars_ - 1 << ", i64 0, i64 0\n";
+  value_ = get_string(text(value));
 }
 
 void CodeGenerator::visit(Int& value) {
-  ++vars_;
-  ss_ << "  %." << vars_ << " = alloca i32\n"
-      << "  store i32 " << value.text() << ", i32* %." << vars_ << "\n";
-  load_variable(value.type());
-  ss_ << "\n";
+  value_ = llvm::ConstantInt::get(builder_.getInt32Ty(), text(value), 10);
+}
+
+void CodeGenerator::generate(NodeId node) {
+  const auto& ast = *ast_;
+  switch (ast.kind(node)) {
+    case Kind::Constdecl:
+    case Kind::Vardecl:
+    case Kind::Block:
+      for (const auto child : ast.children(node)) {
+        generate(child);
+      }
+      break;
+    case Kind::Constdeclaration:
+      generate_constdeclaration(node);
+      break;
+    case Kind::Declaration:
+      generate_declaration(node);
+      break;
+    case Kind::Functioncall:
+      generate_functioncall(node);
+      break;
+    case Kind::Assignment:
+      generate_assignment(node);
+      break;
+    case Kind::While:
+      generate_while(node);
+      break;
+    case Kind::Branch:
+      generate_branch(node);
+      break;
+    case Kind::Atom:
+      generate_atom(node);
+      break;
+    case Kind::Brackets:
+      generate(ast.child(node, 0));
+      break;
+    case Kind::Binary: {
+      generate(ast.child(node, 0));
+      auto* lhs = value_;
+      generate(ast.child(node, 2));
+      value_ = create_operation(
+          ast.type<Op>(ast.child(node, 1)), lhs, value_);
+      break;
+    }
+    case Kind::Boolexpr:
+      generate_boolexpr(node);
+      break;
+    case Kind::Id:
+      generate_id(node);
+      break;
+    case Kind::Cell: {
+      auto* ptr = get_ptr(node);
+      value_ = builder_.CreateLoad(get_type(ast.type(node)), ptr);
+      break;
+    }
+    case Kind::Char:
+      value_ = builder_.getInt8(static_cast<uint8_t>(ast.text(node)[0]));
+      break;
+    case Kind::Stringliteral:
+      value_ = get_string(ast.text(node));
+      break;
+    case Kind::Int:
+      value_ =
+          llvm::ConstantInt::get(builder_.getInt32Ty(), ast.text(node), 10);
+      break;
+    default: /* do nothing */
+      break;
+  }
+}
+
+void CodeGenerator::generate_constdeclaration(NodeId node) {
+  const auto& ast = *ast_;
+  const auto constname = ast.child(node, 0);
+  generate(ast.child(node, 1));
+  const auto name = ast.symbol(constname);
+  const auto& it = symbol_table_.find(name)->second;
+  addresses_[name] =
+      create_alloca(get_type(it.get_type()), ast.text(constname));
+  if (it.get_type() == VarType::StringType) {
+    builder_.CreateCall(
+        get_function("strcpy"), {get_string_ptr(name), value_});
+  } else {
+    builder_.CreateStore(value_, addresses_[name]);
+  }
+}
+
+void CodeGenerator::generate_declaration(NodeId node) {
+  const auto& ast = *ast_;
+  const auto children = ast.children(node);
+  const auto vartype = children.back();
+  for (size_t i = 0; i + 1 < children.size(); ++i) {
+    const auto varname = children[i];
+    const auto name = ast.symbol(varname);
+    auto& it = symbol_table_.find(name)->second;
+    auto* type = get_type(it.get_type());
+    if (it.get_form() == Form::Variable) {
+      addresses_[name] = create_alloca(type, ast.text(varname));
+      if (it.get_type() == VarType::StringType) {
+        builder_.CreateStore(builder_.getInt8(0), get_string_ptr(name));
+      }
+    } else {
+      const auto interval = ast.child(vartype, 0);
+      const auto min_index = std::stoi(ast.text(ast.child(interval, 0)));
+      const auto size =
+          std::stoi(ast.text(ast.child(interval, 1))) - min_index + 1;
+      addresses_[name] =
+          create_alloca(llvm::ArrayType::get(type, size), ast.text(varname));
+      it.set_array_data(std::make_pair(min_index, size));
+    }
+  }
+}
+
+void CodeGenerator::generate_functioncall(NodeId node) {
+  const auto& ast = *ast_;
+  const auto children = ast.children(node);
+  const auto function = ast.type<FuncName>(children[0]);
+  if (function == FuncName::Readln) {
+    for (size_t i = 1; i < children.size(); ++i) {
+      const auto variable = children[i];
+      const auto type = ast.type(variable);
+      const auto& it = symbol_table_.find(ast.symbol(variable))->second;
+      if (type == VarType::StringType) {
+        generate(variable);
+        read_function(type, value_);
+      } else if (
+          it.get_form() == Form::Array ||
+          it.get_type() == VarType::StringType) {
+        read_function(type, get_ptr(variable));
+      } else {
+        read_function(
+            it.get_type(), addresses_.at(ast.symbol(variable)));
+      }
+    }
+    return;
+  }
+
+  // The variables, then the arguments; each list ends with the newline.
+  const auto newline = function == FuncName::Writeln;
+  for (size_t i = 1; i < children.size(); ++i) {
+    const auto child = children[i];
+    const auto last = i + 1 == children.size() ||
+        is_expression(ast.kind(children[i + 1])) !=
+            is_expression(ast.kind(child));
+    generate(child);
+    write_function(ast.type(child), newline && last);
+  }
+}
+
+void CodeGenerator::generate_assignment(NodeId node) {
+  const auto& ast = *ast_;
+  const auto variable = ast.child(node, 0);
+  const auto expression = ast.child(node, 2);
+  generate(expression);
+  auto* rvalue = value_;
+  const auto is_cell = ast.kind(variable) == Kind::Cell;
+  const auto modification = ast.type<ModType>(ast.child(node, 1));
+
+  if (!is_cell && ast.type(variable) == VarType::StringType) {
+    if (ast.type(expression) == VarType::CharType) {
+      rvalue = to_string(rvalue);
+    }
+    const auto* function =
+        modification == ModType::Assignment ? "strcpy" : "strcat";
+    builder_.CreateCall(
+        get_function(function),
+        {get_string_ptr(ast.symbol(variable)), rvalue});
+    return;
+  }
+
+  auto* ptr =
+      is_cell ? get_ptr(variable) : addresses_.at(ast.symbol(variable));
+  if (modification != ModType::Assignment) {
+    auto* lvalue = builder_.CreateLoad(get_type(ast.type(variable)), ptr);
+    switch (modification) {
+      case ModType::Add:
+        rvalue = builder_.CreateAdd(lvalue, rvalue);
+        break;
+      case ModType::Reduce:
+        rvalue = builder_.CreateSub(lvalue, rvalue);
+        break;
+      case ModType::Multiply:
+        rvalue = builder_.CreateMul(lvalue, rvalue);
+        break;
+      default: /* do nothing */
+        break;
+    }
+  }
+  builder_.CreateStore(rvalue, ptr);
+}
+
+void CodeGenerator::generate_while(NodeId node) {
+  auto* condition_branch = llvm::BasicBlock::Create(context_, "while.cond");
+  auto* body_branch = llvm::BasicBlock::Create(context_, "while.body");
+  auto* end_branch = llvm::BasicBlock::Create(context_, "while.end");
+
+  builder_.CreateBr(condition_branch);
+  condition_branch->insertInto(main_);
+  builder_.SetInsertPoint(condition_branch);
+  generate(ast_->child(node, 0));
+  builder_.CreateCondBr(value_, body_branch, end_branch);
+
+  body_branch->insertInto(main_);
+  builder_.SetInsertPoint(body_branch);
+  generate(ast_->child(node, 1));
+  builder_.CreateBr(condition_branch);
+
+  end_branch->insertInto(main_);
+  builder_.SetInsertPoint(end_branch);
+}
+
+void CodeGenerator::generate_branch(NodeId node) {
+  const auto children = ast_->children(node);
+  const auto has_alternative = children.size() == 3;
+  auto* then_branch = llvm::BasicBlock::Create(context_, "if.then");
+  auto* else_branch = has_alternative
+      ? llvm::BasicBlock::Create(context_, "if.else")
+      : nullptr;
+  auto* end_branch = llvm::BasicBlock::Create(context_, "if.end");
+
+  generate(children[0]);
+  builder_.CreateCondBr(
+      value_, then_branch, else_branch != nullptr ? else_branch : end_branch);
+
+  then_branch->insertInto(main_);
+  builder_.SetInsertPoint(then_branch);
+  generate(children[1]);
+  builder_.CreateBr(end_branch);
+
+  if (else_branch != nullptr) {
+    else_branch->insertInto(main_);
+    builder_.SetInsertPoint(else_branch);
+    generate(children[2]);
+    builder_.CreateBr(end_branch);
+  }
+
+  end_branch->insertInto(main_);
+  builder_.SetInsertPoint(end_branch);
+}
+
+void CodeGenerator::generate_atom(NodeId node) {
+  const auto& ast = *ast_;
+  const auto children = ast.children(node);
+  generate(children.back());
+  const auto minus = std::count_if(
+                         children.begin(),
+                         children.end() - 1,
+                         [&ast](NodeId sign) {
+                           return ast.type<Op>(sign) == Op::Minus;
+                         }) %
+      2;
+  if (minus != 0) {
+    value_ = builder_.CreateNeg(value_);
+  }
+}
+
+void CodeGenerator::generate_boolexpr(NodeId node) {
+  const auto& ast = *ast_;
+  generate(ast.child(node, 0));
+  auto* op1 = value_;
+  generate(ast.child(node, 2));
+  auto* op2 = value_;
+
+  if (ast.type(node) == VarType::StringType) {
+    op1 = builder_.CreateCall(get_function("strcmp"), {op1, op2});
+    op2 = builder_.getInt32(0);
+  }
+  value_ = builder_.CreateICmp(
+      to_predicate(ast.type<BoolOp>(ast.child(node, 1))), op1, op2);
+}
+
+void CodeGenerator::generate_id(NodeId node) {
+  const auto& ast = *ast_;
+  const auto name = ast.symbol(node);
+  if (ast.type(node) == VarType::StringType) {
+    value_ = get_string_ptr(name);
+    return;
+  }
+  const auto& it = symbol_table_.find(name)->second;
+  value_ = builder_.CreateLoad(
+      get_type(it.get_type()), addresses_.at(name), ast.text(node));
+}
+
+llvm::Value* CodeGenerator::get_ptr(NodeId cell) {
+  generate(ast_->child(cell, 1));
+  auto* index = value_;
+  const auto name = ast_->symbol(cell);
+  const auto& it = symbol_table_.find(name)->second;
+
+  if (it.get_type() == VarType::StringType) {
+    index = builder_.CreateNSWSub(index, builder_.getInt32(1));
+  } else if (it.get_min_index() != 0) {
+    index = builder_.CreateSub(index, builder_.getInt32(it.get_min_index()));
+  }
+  index = builder_.CreateSExt(index, builder_.getInt64Ty());
+
+  auto* address = addresses_.at(name);
+  return builder_.CreateGEP(
+      address->getAllocatedType(), address, {builder_.getInt64(0), index});
 }
 
 }  // namespace pascal::ast
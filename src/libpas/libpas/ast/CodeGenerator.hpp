@@ -1,19 +1,31 @@
 #pragma once
 
 #include <libpas/ast/Ast.hpp>
+#include <libpas/ast/FlatAst.hpp>
 #include <libpas/ast/SymbolTable.hpp>
 #include <libpas/ast/Visitor.hpp>
 
-#include <ostream>
-#include <sstream>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 
 namespace pascal::ast {
 
 class CodeGenerator final : public Visitor {
  public:
-  CodeGenerator(SymbolTable& symbol_table) : symbol_table_(symbol_table) {}
-  static void
-  exec(Program& program, SymbolTable& symbol_table, std::ostream& out);
+  CodeGenerator(SymbolTable& symbol_table, llvm::Module& module);
+  static std::unique_ptr<llvm::Module>
+  exec(Program& program, SymbolTable& symbol_table, llvm::LLVMContext& context);
+  // The same module from a FlatAst that SemanticAnalysier has annotated.
+  static std::unique_ptr<llvm::Module> exec(
+      const FlatAst& ast,
+      SymbolTable& symbol_table,
+      llvm::LLVMContext& context);
 
   void visit(Header& member) override;
   void visit(Constdecl& member) override;
@@ -41,37 +53,46 @@ class CodeGenerator final : public Visitor {
   void visit(Int& value) override;
 
  private:
-  struct Expr {
-    std::vector<size_t> operands;
-    std::vector<Op> operations;
-  };
-  void generate_file(std::ostream& out);
-  void write_function(VarType type);
-  void writeln_function(VarType type);
-  void read_function(VarType type, size_t var);
-  void load_variable(VarType type);
-  void store_variable(VarType type);
-  void add_op(Expr& expr, size_t i, std::string_view operation);
-  void parse_stacks(Expr& expr);
-  void parse_expression(Expression& expression, Expr& expr);
-  VarType get_ptr(Cell& value);
-  void convert_to_string();
+  void generate(NodeId node);
+  void generate_constdeclaration(NodeId node);
+  void generate_declaration(NodeId node);
+  void generate_functioncall(NodeId node);
+  void generate_assignment(NodeId node);
+  void generate_while(NodeId node);
+  void generate_branch(NodeId node);
+  void generate_atom(NodeId node);
+  void generate_boolexpr(NodeId node);
+  void generate_id(NodeId node);
+  llvm::Value* get_ptr(NodeId cell);
+
+  void write_function(VarType type, bool newline);
+  void read_function(VarType type, llvm::Value* ptr);
+  llvm::Value* create_operation(
+      Op operation,
+      llvm::Value* lhs,
+      llvm::Value* rhs);
+  llvm::Value* get_ptr(Cell& value);
+  llvm::Value* get_string_ptr(SymbolId name);
+  llvm::Value* to_string(llvm::Value* ch);
+  llvm::AllocaInst* create_alloca(llvm::Type* type, const std::string& name);
+  llvm::Constant* get_string(std::string_view text);
+  llvm::FunctionCallee get_function(std::string_view name);
+  llvm::Type* get_type(VarType type);
+  const std::string& text(const Value& value) const {
+    return symbols_->text(value.symbol());
+  }
 
   SymbolTable& symbol_table_;
-  std::stringstream ss_;
-  std::stringstream conststrings_;
-  bool strings_ = false;
-  bool char_convert_ = false;
-  bool read_int_ = false;
-  bool read_char_ = false;
-  bool read_string_ = false;
-  bool write_int_ = false;
-  bool writeln_int_ = false;
-  bool write_char_ = false;
-  bool writeln_char_ = false;
-  bool write_string_ = false;
-  bool writeln_string_ = false;
-  size_t vars_ = 0;
+  llvm::Module& module_;
+  llvm::LLVMContext& context_;
+  llvm::IRBuilder<> builder_;
+  llvm::Function* main_ = nullptr;
+  std::unordered_map<SymbolId, llvm::AllocaInst*> addresses_;
+  std::unordered_map<std::string, llvm::Constant*> strings_;
+  llvm::AllocaInst* last_alloca_ = nullptr;
+  llvm::Value* value_ = nullptr;
+  const FlatAst* ast_ = nullptr;
+  const Interner* symbols_ = nullptr;
 };
 
 }  // namespace pascal::ast
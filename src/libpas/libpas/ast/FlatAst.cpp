@@ -0,0 +1,274 @@
+#include <libpas/ast/Ast.hpp>
+#include <libpas/ast/FlatAst.hpp>
+#include <libpas/ast/Visitor.hpp>
+
+#include <limits>
+#include <stdexcept>
+
+namespace pascal::ast {
+
+namespace {
+
+// Each visit adds its node, then its children's, and leaves the node's id
+// in node_ for the parent. Nodes keep the types semantic analysis gave
+// them, if it ran.
+class Flattener final : public Visitor {
+ public:
+  explicit Flattener(FlatAst& ast) : ast_(ast) {}
+
+  NodeId add(Member& member) {
+    member.accept(*this);
+    return node_;
+  }
+
+  void visit(Header& member) override {
+    const auto node = ast_.add_node(Kind::Header, 0, 1);
+    ast_.set_child(node, 0, add(*member.progname()));
+    node_ = node;
+  }
+
+  void visit(Constdecl& member) override {
+    add_list(Kind::Constdecl, member.constdeclarations());
+  }
+
+  void visit(Constdeclaration& member) override {
+    const auto node = ast_.add_node(Kind::Constdeclaration, 0, 2);
+    ast_.set_child(node, 0, add(*member.constname()));
+    ast_.set_child(node, 1, add(*member.expression()));
+    node_ = node;
+  }
+
+  void visit(Expression& member) override {
+    NodeId node = 0;
+    if (member.atom() != nullptr) {
+      const auto signs = member.signs();
+      const auto count = static_cast<uint32_t>(signs.size());
+      node = ast_.add_node(Kind::Atom, 0, count + 1);
+      for (uint32_t i = 0; i < count; ++i) {
+        ast_.set_child(node, i, add(*signs[i]));
+      }
+      ast_.set_child(node, count, add(*member.atom()));
+    } else if (member.operation() == nullptr) {
+      node = ast_.add_node(Kind::Brackets, 0, 1);
+      ast_.set_child(node, 0, add(*member.lhs()));
+    } else {
+      node = ast_.add_node(Kind::Binary, 0, 3);
+      ast_.set_child(node, 0, add(*member.lhs()));
+      ast_.set_child(node, 1, add(*member.operation()));
+      ast_.set_child(node, 2, add(*member.rhs()));
+    }
+    ast_.set_type(node, member.type());
+    node_ = node;
+  }
+
+  void visit(Boolexpr& member) override {
+    const auto node = ast_.add_node(Kind::Boolexpr, 0, 3);
+    ast_.set_child(node, 0, add(*member.operand1()));
+    ast_.set_child(node, 1, add(*member.booloperation()));
+    ast_.set_child(node, 2, add(*member.operand2()));
+    ast_.set_type(node, member.type());
+    node_ = node;
+  }
+
+  void visit(Vardecl& member) override {
+    add_list(Kind::Vardecl, member.declarations());
+  }
+
+  void visit(Declaration& member) override {
+    const auto& varnames = member.varnames();
+    const auto count = static_cast<uint32_t>(varnames.size());
+    const auto node = ast_.add_node(Kind::Declaration, 0, count + 1);
+    for (uint32_t i = 0; i < count; ++i) {
+      ast_.set_child(node, i, add(*varnames[i]));
+    }
+    ast_.set_child(node, count, add(*member.vartype()));
+    node_ = node;
+  }
+
+  void visit(Simpletype& vartype) override {
+    node_ = ast_.add_node(Kind::Simpletype, vartype.symbol(), 0);
+    ast_.set_type(node_, vartype.type().get_type());
+  }
+
+  void visit(Interval& member) override {
+    const auto node = ast_.add_node(Kind::Interval, 0, 2);
+    ast_.set_child(node, 0, add(*member.lborder()));
+    ast_.set_child(node, 1, add(*member.rborder()));
+    ast_.set_type(node, member.type());
+    node_ = node;
+  }
+
+  void visit(Arraytype& vartype) override {
+    const auto node = ast_.add_node(Kind::Arraytype, 0, 2);
+    ast_.set_child(node, 0, add(*vartype.interval()));
+    ast_.set_child(node, 1, add(*vartype.simpletype()));
+    ast_.set_type(node, vartype.type().get_type());
+    node_ = node;
+  }
+
+  void visit(Block& statement) override {
+    add_list(Kind::Block, statement.components());
+  }
+
+  void visit(Functioncall& statement) override {
+    const auto& variables = statement.variables();
+    const auto& arguments = statement.arguments();
+    const auto count = static_cast<uint32_t>(variables.size());
+    const auto node = ast_.add_node(
+        Kind::Functioncall,
+        0,
+        static_cast<uint32_t>(1 + variables.size() + arguments.size()));
+    ast_.set_child(node, 0, add(*statement.functionname()));
+    for (uint32_t i = 0; i < count; ++i) {
+      ast_.set_child(node, 1 + i, add(*variables[i]));
+    }
+    for (uint32_t i = 0; i < arguments.size(); ++i) {
+      ast_.set_child(node, 1 + count + i, add(*arguments[i]));
+    }
+    node_ = node;
+  }
+
+  void visit(Assignment& statement) override {
+    const auto node = ast_.add_node(Kind::Assignment, 0, 3);
+    auto* cell = statement.cell();
+    ast_.set_child(
+        node,
+        0,
+        cell != nullptr ? add(*cell) : add(*statement.varname()));
+    ast_.set_child(node, 1, add(*statement.modification()));
+    ast_.set_child(node, 2, add(*statement.expression()));
+    node_ = node;
+  }
+
+  void visit(While& statement) override {
+    const auto node = ast_.add_node(Kind::While, 0, 2);
+    ast_.set_child(node, 0, add(*statement.boolexpr()));
+    ast_.set_child(node, 1, add(*statement.statement()));
+    node_ = node;
+  }
+
+  void visit(Branch& statement) override {
+    auto* alternative = statement.alternative();
+    const auto node =
+        ast_.add_node(Kind::Branch, 0, alternative != nullptr ? 3 : 2);
+    ast_.set_child(node, 0, add(*statement.boolexpr()));
+    ast_.set_child(node, 1, add(*statement.statement()));
+    if (alternative != nullptr) {
+      ast_.set_child(node, 2, add(*alternative));
+    }
+    node_ = node;
+  }
+
+  void visit(Operation& value) override {
+    node_ = ast_.add_node(Kind::Operation, value.symbol(), 0);
+    ast_.set_type(node_, value.type());
+  }
+
+  void visit(Booloperation& value) override {
+    node_ = ast_.add_node(Kind::Booloperation, value.symbol(), 0);
+    ast_.set_type(node_, value.type());
+  }
+
+  void visit(Modification& value) override {
+    node_ = ast_.add_node(Kind::Modification, value.symbol(), 0);
+    ast_.set_type(node_, value.type());
+  }
+
+  void visit(Functionname& value) override {
+    node_ = ast_.add_node(Kind::Functionname, value.symbol(), 0);
+    ast_.set_type(node_, value.type());
+  }
+
+  void visit(Id& value) override {
+    node_ = ast_.add_node(Kind::Id, value.symbol(), 0);
+    ast_.set_type(node_, value.type());
+  }
+
+  void visit(Cell& value) override {
+    const auto node = ast_.add_node(Kind::Cell, value.symbol(), 2);
+    ast_.set_child(node, 0, add(*value.varname()));
+    ast_.set_child(node, 1, add(*value.index()));
+    ast_.set_type(node, value.type());
+    node_ = node;
+  }
+
+  void visit(Char& value) override {
+    node_ = ast_.add_node(Kind::Char, value.symbol(), 0);
+    ast_.set_type(node_, value.type());
+  }
+
+  void visit(Stringliteral& value) override {
+    node_ = ast_.add_node(Kind::Stringliteral, value.symbol(), 0);
+    ast_.set_type(node_, value.type());
+  }
+
+  void visit(Int& value) override {
+    node_ = ast_.add_node(Kind::Int, value.symbol(), 0);
+    ast_.set_type(node_, value.type());
+  }
+
+ private:
+  template <class Nodes>
+  void add_list(Kind kind, const Nodes& nodes) {
+    const auto node =
+        ast_.add_node(kind, 0, static_cast<uint32_t>(nodes.size()));
+    for (uint32_t i = 0; i < nodes.size(); ++i) {
+      ast_.set_child(node, i, add(*nodes[i]));
+    }
+    node_ = node;
+  }
+
+  FlatAst& ast_;
+  NodeId node_ = 0;
+};
+
+}  // namespace
+
+FlatAst FlatAst::flatten(Program& program) {
+  FlatAst ast(program.symbols());
+  // Every node but the root has one slot in its parent, and an Expression
+  // becomes one node, whatever its form.
+  ast.reserve(program.node_count() + 1, program.node_count());
+  Flattener flattener(ast);
+  auto* constdecl = program.get_constdecl();
+  auto* vardecl = program.get_vardecl();
+  const auto root = ast.add_node(
+      Kind::Program,
+      0,
+      2 + (constdecl != nullptr ? 1 : 0) + (vardecl != nullptr ? 1 : 0));
+  uint32_t n = 0;
+  ast.set_child(root, n++, flattener.add(*program.get_header()));
+  if (constdecl != nullptr) {
+    ast.set_child(root, n++, flattener.add(*constdecl));
+  }
+  if (vardecl != nullptr) {
+    ast.set_child(root, n++, flattener.add(*vardecl));
+  }
+  ast.set_child(root, n, flattener.add(*program.get_block()));
+  return ast;
+}
+
+void FlatAst::reserve(size_t nodes, size_t children) {
+  kinds_.reserve(nodes);
+  symbols_.reserve(nodes);
+  types_.reserve(nodes);
+  first_child_.reserve(nodes + 1);
+  children_.reserve(children);
+}
+
+NodeId FlatAst::add_node(Kind kind, SymbolId symbol, uint32_t child_count) {
+  if (kinds_.size() == std::numeric_limits<NodeId>::max() ||
+      children_.size() >
+          std::numeric_limits<uint32_t>::max() - child_count) {
+    throw std::length_error("FlatAst: too many nodes");
+  }
+  const auto node = static_cast<NodeId>(kinds_.size());
+  kinds_.push_back(kind);
+  symbols_.push_back(symbol);
+  types_.push_back(static_cast<uint8_t>(VarType::NoType));
+  children_.resize(children_.size() + child_count);
+  first_child_.push_back(static_cast<uint32_t>(children_.size()));
+  return node;
+}
+
+}  // namespace pascal::ast
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <libpas/ast/Interner.hpp>
+#include <libpas/ast/SymbolTable.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace pascal::ast {
+
+class Program;
+
+using NodeId = uint32_t;
+
+// The classes of Ast.hpp, with Expression split into its three forms. The
+// children of each kind, in order:
+//   Program           Header, Constdecl?, Vardecl?, Block
+//   Header            Id
+//   Constdecl         Constdeclaration...
+//   Constdeclaration  Id, expression
+//   Vardecl           Declaration...
+//   Declaration       Id..., Simpletype or Arraytype
+//   Arraytype         Interval, Simpletype
+//   Interval          Int, Int
+//   Block             statement...
+//   Functioncall      Functionname, Id or Cell..., expression...
+//   Assignment        Id or Cell, Modification, expression
+//   While             Boolexpr, statement
+//   Branch            Boolexpr, statement, statement?
+//   Atom              Operation... (the signs), Id, Cell, Char,
+//                     Stringliteral or Int
+//   Brackets          expression
+//   Binary            expression, Operation, expression
+//   Boolexpr          expression, Booloperation, expression
+//   Cell              Id, expression
+// The other kinds are leaves. An expression is an Atom, Brackets or Binary
+// node. Operation, Booloperation, Modification, Functionname, Simpletype
+// and the values (Id, Cell, Char, Stringliteral, Int) have a symbol; a
+// Cell's is its array's.
+enum class Kind : uint8_t {
+  Program,
+  Header,
+  Constdecl,
+  Constdeclaration,
+  Vardecl,
+  Declaration,
+  Simpletype,
+  Arraytype,
+  Interval,
+  Block,
+  Functioncall,
+  Assignment,
+  While,
+  Branch,
+  Atom,
+  Brackets,
+  Binary,
+  Boolexpr,
+  Operation,
+  Booloperation,
+  Modification,
+  Functionname,
+  Id,
+  Cell,
+  Char,
+  Stringliteral,
+  Int
+};
+
+inline bool is_expression(Kind kind) {
+  return kind == Kind::Atom || kind == Kind::Brackets || kind == Kind::Binary;
+}
+
+// The AST as parallel arrays indexed by node id: 14 bytes per node, where
+// the Ast.hpp classes take from 16 (Id) to 80 bytes (Expression) plus the
+// vectors' buffers. Nodes are stored in pre-order, so the root is node 0 and
+// a depth-first pass, as SemanticAnalysier and CodeGenerator make, reads the
+// arrays front to back.
+class FlatAst final {
+ public:
+  class Children {
+   public:
+    Children(const NodeId* begin, const NodeId* end)
+        : begin_(begin), end_(end) {}
+    const NodeId* begin() const { return begin_; }
+    const NodeId* end() const { return end_; }
+    size_t size() const { return static_cast<size_t>(end_ - begin_); }
+    NodeId operator[](size_t n) const { return begin_[n]; }
+    NodeId back() const { return end_[-1]; }
+
+   private:
+    const NodeId* begin_;
+    const NodeId* end_;
+  };
+
+  // An empty AST whose symbols are in `interner`, which must outlive it.
+  explicit FlatAst(const Interner& interner) : interner_(&interner) {}
+
+  // Its symbols are the program's, so it must not outlive the program.
+  static FlatAst flatten(Program& program);
+
+  void reserve(size_t nodes, size_t children);
+  // Appends a node with `child_count` children, which set_child fills in.
+  // Nodes are added in pre-order: a node before its children.
+  NodeId add_node(Kind kind, SymbolId symbol, uint32_t child_count);
+  void set_child(NodeId node, uint32_t n, NodeId child) {
+    children_[first_child_[node] + n] = child;
+  }
+
+  size_t size() const { return kinds_.size(); }
+  Kind kind(NodeId node) const { return kinds_[node]; }
+  SymbolId symbol(NodeId node) const { return symbols_[node]; }
+  const Interner& interner() const { return *interner_; }
+  const std::string& text(NodeId node) const {
+    return interner_->text(symbols_[node]);
+  }
+  Children children(NodeId node) const {
+    return Children(
+        children_.data() + first_child_[node],
+        children_.data() + first_child_[node + 1]);
+  }
+  NodeId child(NodeId node, uint32_t n) const {
+    return children_[first_child_[node] + n];
+  }
+
+  // Set by SemanticAnalysier, or by flatten from an analysed program: an Op
+  // for Operation, a BoolOp for Booloperation, a ModType for Modification,
+  // a FuncName for Functionname and a VarType for the values, expressions,
+  // Boolexpr, Interval, Simpletype and Arraytype.
+  template <class Type = VarType>
+  Type type(NodeId node) const {
+    static_assert(std::is_enum_v<Type>);
+    return static_cast<Type>(types_[node]);
+  }
+  template <class Type>
+  void set_type(NodeId node, Type type) {
+    static_assert(std::is_enum_v<Type>);
+    types_[node] = static_cast<uint8_t>(type);
+  }
+
+ private:
+  const Interner* interner_;
+  std::vector<Kind> kinds_;
+  std::vector<SymbolId> symbols_;
+  std::vector<uint8_t> types_;
+  // The children of node i are children_[first_child_[i]] up to
+  // children_[first_child_[i + 1]].
+  std::vector<uint32_t> first_child_{0};
+  std::vector<NodeId> children_;
+
+  // Writes the arrays as they are.
+  friend class BinaryAst;
+};
+
+}  // namespace pascal::ast
@@ -0,0 +1,74 @@
+#include <libpas/ast/Interner.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <stdexcept>
+
+namespace pascal::ast {
+
+namespace {
+
+// In the order they get their ids. "" is the empty Booloperation's.
+constexpr std::string_view fixed_symbols[] = {
+    "",
+    "+", "-", "*", "div", "mod",
+    "=", ">", "<", "<>", "<=", ">=",
+    ":=", "+=", "-=", "*=",
+    "integer", "char", "string",
+    "readln", "write", "writeln"};
+
+}  // namespace
+
+Interner::Interner() {
+  for (const auto text : fixed_symbols) {
+    insert(text);
+  }
+}
+
+const Interner& Interner::global() {
+  static const Interner interner;
+  return interner;
+}
+
+SymbolId Interner::fixed(std::string_view text) {
+  const auto& ids = global().ids_;
+  if (const auto it = ids.find(text); it != ids.end()) {
+    return it->second;
+  }
+  throw std::logic_error("'" + std::string(text) + "' is not a fixed symbol");
+}
+
+SymbolId Interner::intern(std::string_view text) {
+  return insert(text);
+}
+
+SymbolId Interner::intern_lowercase(std::string_view text) {
+  lowercase_.assign(text);
+  std::transform(
+      lowercase_.begin(), lowercase_.end(), lowercase_.begin(), [](char c) {
+        return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+      });
+  return insert(lowercase_);
+}
+
+SymbolId Interner::insert(std::string_view text) {
+  if (const auto it = ids_.find(text); it != ids_.end()) {
+    return it->second;
+  }
+  if (size_ > std::numeric_limits<SymbolId>::max()) {
+    throw std::length_error("too many distinct symbols");
+  }
+  const auto id = static_cast<SymbolId>(size_);
+  const auto [chunk, offset] = locate(id);
+  if (chunks_[chunk] == nullptr) {
+    chunks_[chunk] = std::make_unique<std::string[]>(first_chunk_size << chunk);
+  }
+  auto& stored = chunks_[chunk][offset];
+  stored.assign(text);
+  ids_.emplace(stored, id);
+  ++size_;
+  return id;
+}
+
+}  // namespace pascal::ast
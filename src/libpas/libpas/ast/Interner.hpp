@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace pascal::ast {
+
+// An interned string: equal ids are equal strings.
+using SymbolId = uint32_t;
+
+// Stores every distinct identifier, literal and operator of a program once,
+// so that nodes carry a SymbolId and symbol tables compare integers. Each
+// ast::Program owns one, so a compilation's symbols go away with it. Every
+// interner starts with the fixed symbols: the keywords, operators and type
+// names the passes look for, at the same ids in all of them. The strings
+// never move, but interning is not synchronized: an interner belongs to
+// one compilation at a time.
+class Interner final {
+ public:
+  Interner();
+  Interner(const Interner&) = delete;
+  Interner& operator=(const Interner&) = delete;
+
+  // Holds the fixed symbols and nothing else. It never changes, so any
+  // thread may read it.
+  static const Interner& global();
+  // The id of a fixed symbol in every interner. Throws std::logic_error
+  // for other strings.
+  static SymbolId fixed(std::string_view text);
+
+  SymbolId intern(std::string_view text);
+  // Identifiers and keywords are case-insensitive: this interns `text` in
+  // lower case. The lower-case text is built in a buffer reused across
+  // calls, so a symbol seen before allocates nothing once the buffer has
+  // grown to its length.
+  SymbolId intern_lowercase(std::string_view text);
+
+  const std::string& text(SymbolId id) const {
+    const auto [chunk, offset] = locate(id);
+    return chunks_[chunk][offset];
+  }
+
+  size_t size() const { return size_; }
+
+ private:
+  // Chunk `k` holds first_chunk_size << k strings, enough for every id in
+  // max_chunks chunks.
+  static constexpr size_t first_chunk_bits = 10;
+  static constexpr size_t first_chunk_size = size_t{1} << first_chunk_bits;
+  static constexpr size_t max_chunks = 33 - first_chunk_bits;
+
+  static std::pair<size_t, size_t> locate(SymbolId id) {
+    const uint64_t position = uint64_t{id} + first_chunk_size;
+    const size_t chunk = 63 - __builtin_clzll(position) - first_chunk_bits;
+    return {chunk, position - (first_chunk_size << chunk)};
+  }
+
+  SymbolId insert(std::string_view text);
+
+  // Keys are views of the stored strings.
+  std::unordered_map<std::string_view, SymbolId> ids_;
+  std::array<std::unique_ptr<std::string[]>, max_chunks> chunks_;
+  uint64_t size_ = 0;
+  // intern_lowercase's lower-case copy, reused.
+  std::string lowercase_;
+};
+
+}  // namespace pascal::ast
@@ -1,26 +1,64 @@
 #include <libpas/ast/SemanticAnalysier.hpp>
 #include <libpas/ast/SymbolTable.hpp>
 
-#include <string_view>
 #include <unordered_map>
 
 namespace pascal::ast {
 
 namespace {
 
-VarType to_var_type(std::string_view text) {
-  static const std::unordered_map<std::string_view, VarType> text_to_kind = {
-      {"integer", VarType::IntegerType},
-      {"char", VarType::CharType},
-      {"string", VarType::StringType}};
+VarType to_var_type(SymbolId symbol) {
+  static const std::unordered_map<SymbolId, VarType> symbol_to_kind = {
+      {Interner::fixed("integer"), VarType::IntegerType},
+      {Interner::fixed("char"), VarType::CharType},
+      {Interner::fixed("string"), VarType::StringType}};
 
-  return text_to_kind.find(text)->second;
+  return symbol_to_kind.find(symbol)->second;
+}
+
+Op to_op(SymbolId symbol) {
+  static const std::unordered_map<SymbolId, Op> symbol_to_kind = {
+      {Interner::fixed("+"), Op::Plus},
+      {Interner::fixed("-"), Op::Minus},
+      {Interner::fixed("*"), Op::Star},
+      {Interner::fixed("div"), Op::Div},
+      {Interner::fixed("mod"), Op::Mod}};
+  return symbol_to_kind.find(symbol)->second;
+}
+
+BoolOp to_bool_op(SymbolId symbol) {
+  static const std::unordered_map<SymbolId, BoolOp> symbol_to_kind = {
+      {Interner::fixed("="), BoolOp::Equal},
+      {Interner::fixed(">"), BoolOp::MoreThen},
+      {Interner::fixed("<"), BoolOp::LessThen},
+      {Interner::fixed("<>"), BoolOp::NotEqual},
+      {Interner::fixed("<="), BoolOp::NotMore},
+      {Interner::fixed(">="), BoolOp::NotLess}};
+  return symbol_to_kind.find(symbol)->second;
+}
+
+ModType to_mod_type(SymbolId symbol) {
+  static const std::unordered_map<SymbolId, ModType> symbol_to_kind = {
+      {Interner::fixed(":="), ModType::Assignment},
+      {Interner::fixed("+="), ModType::Add},
+      {Interner::fixed("-="), ModType::Reduce},
+      {Interner::fixed("*="), ModType::Multiply}};
+  return symbol_to_kind.find(symbol)->second;
+}
+
+FuncName to_func_name(SymbolId symbol) {
+  static const std::unordered_map<SymbolId, FuncName> symbol_to_kind = {
+      {Interner::fixed("readln"), FuncName::Readln},
+      {Interner::fixed("write"), FuncName::Write},
+      {Interner::fixed("writeln"), FuncName::Writeln}};
+  return symbol_to_kind.find(symbol)->second;
 }
 
 }  // namespace
 
 SymbolTable SemanticAnalysier::exec(Program& program) {
   SemanticAnalysier semantic_analysier;
+  semantic_analysier.symbols_ = &program.symbols();
   program.get_header()->accept(semantic_analysier);
   auto* vardecl = program.get_vardecl();
   auto* constdecl = program.get_constdecl();
@@ -36,7 +74,7 @@ SymbolTable SemanticAnalysier::exec(Program& program) {
 
 void SemanticAnalysier::visit(Header& member) {
   symbol_table_.insert(std::make_pair(
-      member.progname()->text(), Symbol(Form::ProgName, VarType::NoType)));
+      member.progname()->symbol(), Symbol(Form::ProgName, VarType::NoType)));
 }
 
 void SemanticAnalysier::visit(Constdecl& member) {
@@ -46,10 +84,11 @@ void SemanticAnalysier::visit(Constdecl& member) {
 }
 
 void SemanticAnalysier::visit(Constdeclaration& member) {
-  const auto constname = member.constname()->text();
+  const auto constname = member.constname()->symbol();
   if (symbol_table_.find(constname) != symbol_table_.end()) {
     throw SemanticError(
-        "Repeat declaration of const identifier '" + constname + "'");
+        "Repeat declaration of const identifier '" +
+        text(*member.constname()) + "'");
   }
   member.expression()->accept(*this);
   const auto consttype = member.expression()->type();
@@ -72,9 +111,10 @@ void SemanticAnalysier::visit(Declaration& member) {
     throw SemanticError("Incompatible array type of array");
   }
   for (const auto& var : member.varnames()) {
-    const auto varname = var->text();
+    const auto varname = var->symbol();
     if (symbol_table_.find(varname) != symbol_table_.end()) {
-      throw SemanticError("Repeat declaration of identifier '" + varname + "'");
+      throw SemanticError(
+          "Repeat declaration of identifier '" + text(*var) + "'");
     }
     var->set_type(symbol.get_type());
     symbol_table_.insert(std::make_pair(varname, symbol));
@@ -93,12 +133,12 @@ void SemanticAnalysier::visit(Assignment& statement) {
     statement.cell()->accept(*this);
     vartype = statement.cell()->type();
   } else {
-    const auto it = symbol_table_.find(statement.varname()->text());
+    const auto it = symbol_table_.find(statement.varname()->symbol());
     statement.varname()->accept(*this);
     if (it->second.get_form() == Form::Constant) {
       throw SemanticError(
           "Cannot assign new value to constant '" +
-          statement.varname()->text() + "'");
+          text(*statement.varname()) + "'");
     }
     vartype = statement.varname()->type();
   }
@@ -136,45 +176,19 @@ void SemanticAnalysier::visit(Branch& statement) {
 }
 
 void SemanticAnalysier::visit(Operation& value) {
-  const std::string_view text = value.text();
-  static const std::unordered_map<std::string_view, Op> text_to_kind = {
-      {"+", Op::Plus},
-      {"-", Op::Minus},
-      {"*", Op::Star},
-      {"div", Op::Div},
-      {"mod", Op::Mod}};
-  value.set_type(text_to_kind.find(text)->second);
+  value.set_type(to_op(value.symbol()));
 }
 
 void SemanticAnalysier::visit(Booloperation& value) {
-  const std::string_view text = value.text();
-  static const std::unordered_map<std::string_view, BoolOp> text_to_kind = {
-      {"=", BoolOp::Equal},
-      {">", BoolOp::MoreThen},
-      {"<", BoolOp::LessThen},
-      {"<>", BoolOp::NotEqual},
-      {"<=", BoolOp::NotMore},
-      {">=", BoolOp::NotLess}};
-  value.set_type(text_to_kind.find(text)->second);
+  value.set_type(to_bool_op(value.symbol()));
 }
 
 void SemanticAnalysier::visit(Modification& value) {
-  const std::string_view text = value.text();
-  static const std::unordered_map<std::string_view, ModType> text_to_kind = {
-      {":=", ModType::Assignment},
-      {"+=", ModType::Add},
-      {"-=", ModType::Reduce},
-      {"*=", ModType::Multiply}};
-  value.set_type(text_to_kind.find(text)->second);
+  value.set_type(to_mod_type(value.symbol()));
 }
 
 void SemanticAnalysier::visit(Functionname& value) {
-  const std::string_view text = value.text();
-  static const std::unordered_map<std::string_view, FuncName> text_to_kind = {
-      {"readln", FuncName::Readln},
-      {"write", FuncName::Write},
-      {"writeln", FuncName::Writeln}};
-  value.set_type(text_to_kind.find(text)->second);
+  value.set_type(to_func_name(value.symbol()));
 }
 
 void SemanticAnalysier::visit(Functioncall& statement) {
@@ -188,10 +202,10 @@ void SemanticAnalysier::visit(Functioncall& statement) {
     }
     for (const auto& variable : statement.variables()) {
       variable->accept(*this);
-      const auto it = symbol_table_.find(variable->text());
+      const auto it = symbol_table_.find(variable->symbol());
       if (it->second.get_form() == Form::Constant) {
         throw SemanticError(
-            "Cannot assign new value to constant '" + variable->text() + "'");
+            "Cannot assign new value to constant '" + text(*variable) + "'");
       }
     }
     return;
@@ -206,7 +220,7 @@ void SemanticAnalysier::visit(Functioncall& statement) {
 
 void SemanticAnalysier::visit(Expression& member) {
   if (member.atom() != nullptr) {
-    for (const auto& sign : member.signs()) {
+    for (auto* sign : member.signs()) {
       sign->accept(*this);
     }
     member.atom()->accept(*this);
@@ -217,30 +231,20 @@ void SemanticAnalysier::visit(Expression& member) {
     member.set_type(type);
     return;
   }
-  const auto& operands = member.operands();
+  member.lhs()->accept(*this);
+  const auto operand1_type = member.lhs()->type();
   auto* operation = member.operation();
-
-  auto operand1_type = VarType::NoType;
-  auto operand2_type = VarType::NoType;
-
-  for (const auto& operand : operands) {
-    operand->accept(*this);
-    if (operand1_type == VarType::NoType) {
-      operand1_type = operand->type();
-    } else {
-      operand2_type = operand->type();
-    }
-  }
-  if (operation != nullptr) {
-    if (operand1_type == VarType::CharType ||
-        operand1_type == VarType::StringType) {
-      throw SemanticError("Incompatible operands types for expression");
-    }
-    operation->accept(*this);
-  } else {
+  if (operation == nullptr) {
     member.set_type(operand1_type);
     return;
   }
+  member.rhs()->accept(*this);
+  const auto operand2_type = member.rhs()->type();
+  if (operand1_type == VarType::CharType ||
+      operand1_type == VarType::StringType) {
+    throw SemanticError("Incompatible operands types for expression");
+  }
+  operation->accept(*this);
   if (operand1_type != operand2_type) {
     throw SemanticError("Incompatible operands types for expression");
   }
@@ -262,20 +266,20 @@ void SemanticAnalysier::visit(Boolexpr& member) {
 }
 
 void SemanticAnalysier::visit(Cell& value) {
-  const auto it = symbol_table_.find(value.varname()->text());
+  const auto it = symbol_table_.find(value.varname()->symbol());
   if (it == symbol_table_.end()) {
     throw SemanticError(
-        "Unknown identifier '" + value.text() + "' in array name");
+        "Unknown identifier '" + text(value) + "' in array name");
   }
   if (!(it->second.get_form() == Form::Array ||
         it->second.get_type() == VarType::StringType)) {
     throw SemanticError(
-        "Identifier '" + value.text() + "' is not an array or string name");
+        "Identifier '" + text(value) + "' is not an array or string name");
   }
   value.varname()->set_type(it->second.get_type());
   value.index()->accept(*this);
   if (value.index()->type() != VarType::IntegerType) {
-    throw SemanticError("Invalid index type of '" + value.text() + "'");
+    throw SemanticError("Invalid index type of '" + text(value) + "'");
   }
   const auto type = value.varname()->type();
   if (type == VarType::StringType) {
@@ -286,15 +290,15 @@ void SemanticAnalysier::visit(Cell& value) {
 }
 
 void SemanticAnalysier::visit(Id& value) {
-  const auto it = symbol_table_.find(value.text());
+  const auto it = symbol_table_.find(value.symbol());
   if (it == symbol_table_.end()) {
-    throw SemanticError("Unknown identifier '" + value.text() + "'");
+    throw SemanticError("Unknown identifier '" + text(value) + "'");
   }
   if (it->second.get_form() == Form::Array) {
-    throw SemanticError("Identifier '" + value.text() + "' is an array name");
+    throw SemanticError("Identifier '" + text(value) + "' is an array name");
   }
   if (it->second.get_form() == Form::ProgName) {
-    throw SemanticError("Identifier '" + value.text() + "' is a program name");
+    throw SemanticError("Identifier '" + text(value) + "' is a program name");
   }
   value.set_type(it->second.get_type());
 }
@@ -318,16 +322,297 @@ void SemanticAnalysier::visit(Interval& member) {
 }
 
 void SemanticAnalysier::visit(Simpletype& vartype) {
-  const auto type = to_var_type(vartype.text());
+  const auto type = to_var_type(vartype.symbol());
   auto symbol = Symbol(Form::Variable, type);
   vartype.set_type(symbol);
 }
 
 void SemanticAnalysier::visit(Arraytype& vartype) {
   vartype.interval()->accept(*this);
-  const auto type = to_var_type(vartype.simpletype()->text());
+  const auto type = to_var_type(vartype.simpletype()->symbol());
   auto symbol = Symbol(Form::Array, type);
   vartype.set_type(symbol);
 }
 
+SymbolTable SemanticAnalysier::exec(FlatAst& ast) {
+  SemanticAnalysier semantic_analysier;
+  semantic_analysier.ast_ = &ast;
+  // Header, constdecl, vardecl and block, in the order exec(Program&) takes
+  // them.
+  for (const auto child : ast.children(0)) {
+    semantic_analysier.analyse(child);
+  }
+  return semantic_analysier.get_symbol_table();
+}
+
+void SemanticAnalysier::analyse(NodeId node) {
+  auto& ast = *ast_;
+  switch (ast.kind(node)) {
+    case Kind::Header:
+      symbol_table_.insert(std::make_pair(
+          ast.symbol(ast.child(node, 0)),
+          Symbol(Form::ProgName, VarType::NoType)));
+      break;
+    case Kind::Constdecl:
+    case Kind::Vardecl:
+    case Kind::Block:
+    case Kind::While:
+    case Kind::Branch:
+      for (const auto child : ast.children(node)) {
+        analyse(child);
+      }
+      break;
+    case Kind::Constdeclaration:
+      analyse_constdeclaration(node);
+      break;
+    case Kind::Declaration:
+      analyse_declaration(node);
+      break;
+    case Kind::Simpletype:
+      ast.set_type(node, to_var_type(ast.symbol(node)));
+      break;
+    case Kind::Interval:
+      analyse(ast.child(node, 0));
+      analyse(ast.child(node, 1));
+      ast.set_type(node, VarType::IntegerType);
+      break;
+    case Kind::Arraytype:
+      analyse(ast.child(node, 0));
+      ast.set_type(node, to_var_type(ast.symbol(ast.child(node, 1))));
+      break;
+    case Kind::Assignment:
+      analyse_assignment(node);
+      break;
+    case Kind::Functioncall:
+      analyse_functioncall(node);
+      break;
+    case Kind::Atom:
+      analyse_atom(node);
+      break;
+    case Kind::Brackets:
+      analyse(ast.child(node, 0));
+      ast.set_type(node, ast.type(ast.child(node, 0)));
+      break;
+    case Kind::Binary:
+      analyse_binary(node);
+      break;
+    case Kind::Boolexpr:
+      analyse_boolexpr(node);
+      break;
+    case Kind::Operation:
+      ast.set_type(node, to_op(ast.symbol(node)));
+      break;
+    case Kind::Booloperation:
+      ast.set_type(node, to_bool_op(ast.symbol(node)));
+      break;
+    case Kind::Modification:
+      ast.set_type(node, to_mod_type(ast.symbol(node)));
+      break;
+    case Kind::Functionname:
+      ast.set_type(node, to_func_name(ast.symbol(node)));
+      break;
+    case Kind::Id:
+      analyse_id(node);
+      break;
+    case Kind::Cell:
+      analyse_cell(node);
+      break;
+    case Kind::Char:
+      ast.set_type(node, VarType::CharType);
+      break;
+    case Kind::Stringliteral:
+      ast.set_type(node, VarType::StringType);
+      break;
+    case Kind::Int:
+      ast.set_type(node, VarType::IntegerType);
+      break;
+    case Kind::Program:
+      break;
+  }
+}
+
+void SemanticAnalysier::analyse_constdeclaration(NodeId node) {
+  auto& ast = *ast_;
+  const auto constname = ast.child(node, 0);
+  const auto expression = ast.child(node, 1);
+  if (symbol_table_.find(ast.symbol(constname)) != symbol_table_.end()) {
+    throw SemanticError(
+        "Repeat declaration of const identifier '" + ast.text(constname) +
+        "'");
+  }
+  analyse(expression);
+  const auto consttype = ast.type(expression);
+  ast.set_type(constname, consttype);
+  symbol_table_.insert(std::make_pair(
+      ast.symbol(constname), Symbol(Form::Constant, consttype)));
+}
+
+void SemanticAnalysier::analyse_declaration(NodeId node) {
+  auto& ast = *ast_;
+  const auto children = ast.children(node);
+  const auto vartype = children.back();
+  analyse(vartype);
+  const auto form =
+      ast.kind(vartype) == Kind::Arraytype ? Form::Array : Form::Variable;
+  const auto type = ast.type(vartype);
+  if (form == Form::Array && type == VarType::StringType) {
+    throw SemanticError("Incompatible array type of array");
+  }
+  for (size_t i = 0; i + 1 < children.size(); ++i) {
+    const auto var = children[i];
+    if (symbol_table_.find(ast.symbol(var)) != symbol_table_.end()) {
+      throw SemanticError(
+          "Repeat declaration of identifier '" + ast.text(var) + "'");
+    }
+    ast.set_type(var, type);
+    symbol_table_.insert(std::make_pair(ast.symbol(var), Symbol(form, type)));
+  }
+}
+
+void SemanticAnalysier::analyse_assignment(NodeId node) {
+  auto& ast = *ast_;
+  const auto variable = ast.child(node, 0);
+  const auto modification_node = ast.child(node, 1);
+  const auto expression = ast.child(node, 2);
+  if (ast.kind(variable) == Kind::Cell) {
+    analyse(variable);
+  } else {
+    const auto it = symbol_table_.find(ast.symbol(variable));
+    analyse(variable);
+    if (it->second.get_form() == Form::Constant) {
+      throw SemanticError(
+          "Cannot assign new value to constant '" + ast.text(variable) + "'");
+    }
+  }
+  const auto vartype = ast.type(variable);
+  analyse(modification_node);
+  const auto modification = ast.type<ModType>(modification_node);
+  if (modification != ModType::Assignment) {
+    if (vartype == VarType::StringType && modification != ModType::Add) {
+      throw SemanticError("Incompatible operation for string expression");
+    }
+    if (vartype == VarType::CharType) {
+      throw SemanticError("Incompatible operation for char expression");
+    }
+  }
+  analyse(expression);
+  if (ast.type(expression) != vartype &&
+      !(vartype == VarType::StringType &&
+        ast.type(expression) == VarType::CharType)) {
+    throw SemanticError("Incompatible operands types for assignment");
+  }
+}
+
+void SemanticAnalysier::analyse_functioncall(NodeId node) {
+  auto& ast = *ast_;
+  const auto children = ast.children(node);
+  analyse(children[0]);
+  if (ast.type<FuncName>(children[0]) != FuncName::Readln) {
+    for (size_t i = 1; i < children.size(); ++i) {
+      analyse(children[i]);
+    }
+    return;
+  }
+  for (size_t i = 1; i < children.size(); ++i) {
+    if (is_expression(ast.kind(children[i]))) {
+      throw SemanticError(
+          "Only identifiers or array cells expected in read function "
+          "arguments");
+    }
+  }
+  for (size_t i = 1; i < children.size(); ++i) {
+    const auto variable = children[i];
+    analyse(variable);
+    const auto it = symbol_table_.find(ast.symbol(variable));
+    if (it->second.get_form() == Form::Constant) {
+      throw SemanticError(
+          "Cannot assign new value to constant '" + ast.text(variable) + "'");
+    }
+  }
+}
+
+void SemanticAnalysier::analyse_atom(NodeId node) {
+  auto& ast = *ast_;
+  const auto children = ast.children(node);
+  for (const auto child : children) {
+    analyse(child);
+  }
+  const auto type = ast.type(children.back());
+  if (children.size() > 1 && type != VarType::IntegerType) {
+    throw SemanticError("Only integer expression can be signed");
+  }
+  ast.set_type(node, type);
+}
+
+void SemanticAnalysier::analyse_binary(NodeId node) {
+  auto& ast = *ast_;
+  const auto lhs = ast.child(node, 0);
+  const auto rhs = ast.child(node, 2);
+  analyse(lhs);
+  analyse(rhs);
+  const auto operand1_type = ast.type(lhs);
+  if (operand1_type == VarType::CharType ||
+      operand1_type == VarType::StringType) {
+    throw SemanticError("Incompatible operands types for expression");
+  }
+  analyse(ast.child(node, 1));
+  if (operand1_type != ast.type(rhs)) {
+    throw SemanticError("Incompatible operands types for expression");
+  }
+  ast.set_type(node, operand1_type);
+}
+
+void SemanticAnalysier::analyse_boolexpr(NodeId node) {
+  auto& ast = *ast_;
+  const auto operand1 = ast.child(node, 0);
+  const auto operand2 = ast.child(node, 2);
+  analyse(operand1);
+  analyse(operand2);
+  analyse(ast.child(node, 1));
+  if (ast.type(operand1) != ast.type(operand2)) {
+    throw SemanticError("Different types of boolean expression operands");
+  }
+  ast.set_type(node, ast.type(operand1));
+}
+
+void SemanticAnalysier::analyse_cell(NodeId node) {
+  auto& ast = *ast_;
+  const auto varname = ast.child(node, 0);
+  const auto index = ast.child(node, 1);
+  const auto it = symbol_table_.find(ast.symbol(varname));
+  if (it == symbol_table_.end()) {
+    throw SemanticError(
+        "Unknown identifier '" + ast.text(node) + "' in array name");
+  }
+  if (!(it->second.get_form() == Form::Array ||
+        it->second.get_type() == VarType::StringType)) {
+    throw SemanticError(
+        "Identifier '" + ast.text(node) + "' is not an array or string name");
+  }
+  const auto type = it->second.get_type();
+  ast.set_type(varname, type);
+  analyse(index);
+  if (ast.type(index) != VarType::IntegerType) {
+    throw SemanticError("Invalid index type of '" + ast.text(node) + "'");
+  }
+  ast.set_type(
+      node, type == VarType::StringType ? VarType::CharType : type);
+}
+
+void SemanticAnalysier::analyse_id(NodeId node) {
+  auto& ast = *ast_;
+  const auto it = symbol_table_.find(ast.symbol(node));
+  if (it == symbol_table_.end()) {
+    throw SemanticError("Unknown identifier '" + ast.text(node) + "'");
+  }
+  if (it->second.get_form() == Form::Array) {
+    throw SemanticError("Identifier '" + ast.text(node) + "' is an array name");
+  }
+  if (it->second.get_form() == Form::ProgName) {
+    throw SemanticError(
+        "Identifier '" + ast.text(node) + "' is a program name");
+  }
+  ast.set_type(node, it->second.get_type());
+}
+
 }  // namespace pascal::ast
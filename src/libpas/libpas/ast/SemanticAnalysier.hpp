@@ -1,10 +1,12 @@
 #pragma once
 
 #include <libpas/ast/Ast.hpp>
+#include <libpas/ast/FlatAst.hpp>
 #include <libpas/ast/SymbolTable.hpp>
 #include <libpas/ast/Visitor.hpp>
 
 #include <stdexcept>
+#include <string>
 
 namespace pascal::ast {
 
@@ -16,6 +18,9 @@ class SemanticError final : public std::runtime_error {
 class SemanticAnalysier final : public Visitor {
  public:
   static SymbolTable exec(Program& program);
+  // The same checks over a FlatAst, with the same errors in the same order.
+  // Annotates the nodes with their types.
+  static SymbolTable exec(FlatAst& ast);
 
   void visit(Header& member) override;
   void visit(Constdecl& member) override;
@@ -45,7 +50,25 @@ class SemanticAnalysier final : public Visitor {
   SymbolTable get_symbol_table() { return symbol_table_; }
 
  private:
+  void analyse(NodeId node);
+  void analyse_constdeclaration(NodeId node);
+  void analyse_declaration(NodeId node);
+  void analyse_assignment(NodeId node);
+  void analyse_functioncall(NodeId node);
+  void analyse_atom(NodeId node);
+  void analyse_binary(NodeId node);
+  void analyse_boolexpr(NodeId node);
+  void analyse_cell(NodeId node);
+  void analyse_id(NodeId node);
+
+  // For error messages.
+  const std::string& text(const Value& value) const {
+    return symbols_->text(value.symbol());
+  }
+
   SymbolTable symbol_table_;
+  const Interner* symbols_ = nullptr;
+  FlatAst* ast_ = nullptr;
 };
 
 }  // namespace pascal::ast
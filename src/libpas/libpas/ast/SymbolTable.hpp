@@ -1,7 +1,8 @@
 #pragma once
 
+#include <libpas/ast/Interner.hpp>
+
 #include <optional>
-#include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -26,24 +27,21 @@ class Symbol {
   Symbol(
       Form form = Form::NoForm,
       VarType type = VarType::NoType,
-      size_t addr = 0,
       ArrayData array_data = {})
-      : form_(form), type_(type), addr_(addr), array_data_(array_data) {}
+      : form_(form), type_(type), array_data_(array_data) {}
   Form get_form() const { return form_; }
   VarType get_type() const { return type_; }
-  size_t get_addr() const { return addr_; }
   size_t get_min_index() const { return array_data_->first; }
   size_t get_size() const { return array_data_->second; }
-  void set_addr(size_t addr) { addr_ = addr; }
   void set_array_data(ArrayData array_data) { array_data_ = array_data; }
 
  private:
   Form form_;
   VarType type_;
-  size_t addr_;
   ArrayData array_data_;
 };
 
-using SymbolTable = std::unordered_map<std::string, Symbol>;
+// Keyed by the interned name, so a lookup hashes and compares an integer.
+using SymbolTable = std::unordered_map<SymbolId, Symbol>;
 
 }  // namespace pascal::ast
@@ -6,6 +6,7 @@ namespace pascal::ast {
 
 void XmlSerializer::exec(Program& program, std::ostream& out) {
   XmlSerializer xml_serializer;
+  xml_serializer.symbols_ = &program.symbols();
   xml_serializer.nodes_.push(xml_serializer.doc_.append_child("pascal"));
   program.get_header()->accept(xml_serializer);
   auto* vardecl = program.get_vardecl();
@@ -58,18 +59,15 @@ void XmlSerializer::visit(Expression& member) {
     auto braces = append_child("braces");
     nodes_.push(braces);
   }
-  bool op_visited = false;
 
   if (member.atom() == nullptr) {
-    for (const auto& operand : member.operands()) {
-      operand->accept(*this);
-      if (!op_visited && member.operation() != nullptr) {
-        op_visited = true;
-        member.operation()->accept(*this);
-      }
+    member.lhs()->accept(*this);
+    if (member.operation() != nullptr) {
+      member.operation()->accept(*this);
+      member.rhs()->accept(*this);
     }
   } else {
-    for (const auto& sign : member.signs()) {
+    for (auto* sign : member.signs()) {
       sign->accept(*this);
     }
     member.atom()->accept(*this);
@@ -116,7 +114,7 @@ void XmlSerializer::visit(Declaration& member) {
 void XmlSerializer::visit(Simpletype& vartype) {
   auto header = append_child("vartype");
   nodes_.push(header);
-  append_text(vartype.text().c_str());
+  append_text(vartype.symbol());
   nodes_.pop();
 }
 
@@ -234,35 +232,35 @@ void XmlSerializer::visit(Branch& statement) {
 void XmlSerializer::visit(Operation& value) {
   auto header = append_child("operation");
   nodes_.push(header);
-  append_text(value.text().c_str());
+  append_text(value.symbol());
   nodes_.pop();
 }
 
 void XmlSerializer::visit(Booloperation& value) {
   auto header = append_child("booloperation");
   nodes_.push(header);
-  append_text(value.text().c_str());
+  append_text(value.symbol());
   nodes_.pop();
 }
 
 void XmlSerializer::visit(Modification& value) {
   auto header = append_child("modification");
   nodes_.push(header);
-  append_text(value.text().c_str());
+  append_text(value.symbol());
   nodes_.pop();
 }
 
 void XmlSerializer::visit(Functionname& value) {
   auto header = append_child("functionname");
   nodes_.push(header);
-  append_text(value.text().c_str());
+  append_text(value.symbol());
   nodes_.pop();
 }
 
 void XmlSerializer::visit(Id& value) {
   auto header = append_child("id");
   nodes_.push(header);
-  append_text(value.text().c_str());
+  append_text(value.symbol());
   nodes_.pop();
 }
 
@@ -282,21 +280,21 @@ void XmlSerializer::visit(Cell& value) {
 void XmlSerializer::visit(Char& value) {
   auto header = append_child("char");
   nodes_.push(header);
-  append_text(value.text().c_str());
+  append_text(value.symbol());
   nodes_.pop();
 }
 
 void XmlSerializer::visit(Stringliteral& value) {
   auto header = append_child("string");
   nodes_.push(header);
-  append_text(value.text().c_str());
+  append_text(value.symbol());
   nodes_.pop();
 }
 
 void XmlSerializer::visit(Int& value) {
   auto header = append_child("integer");
   nodes_.push(header);
-  append_text(value.text().c_str());
+  append_text(value.symbol());
   nodes_.pop();
 }
 
@@ -304,9 +302,9 @@ pugi::xml_node XmlSerializer::append_child(const char* name) {
   return nodes_.top().append_child(name);
 }
 
-void XmlSerializer::append_text(const char* text) {
+void XmlSerializer::append_text(SymbolId symbol) {
   auto text_node = nodes_.top().append_child(pugi::node_pcdata);
-  text_node.set_value(text);
+  text_node.set_value(symbols_->text(symbol).c_str());
 }
 
 }  // namespace pascal::ast
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <libpas/ast/Interner.hpp>
 #include <libpas/ast/Visitor.hpp>
 
 #include <pugixml.hpp>
@@ -40,8 +41,9 @@ class XmlSerializer final : public Visitor {
 
  private:
   pugi::xml_node append_child(const char* name);
-  void append_text(const char* text);
+  void append_text(SymbolId symbol);
 
+  const Interner* symbols_ = nullptr;
   pugi::xml_document doc_;
   std::stack<pugi::xml_node> nodes_;
 };
@@ -1,270 +1,413 @@
 #include <libpas/ast/detail/Builder.hpp>
 
 #include <algorithm>
+#include <cassert>
+#include <string_view>
+#include <vector>
 
 namespace pascal::ast::detail {
 
-std::any Builder::visitProgram(PascalParser::ProgramContext* context) {
-  auto* header = dynamic_cast<Header*>(
-      std::any_cast<Member*>(context->header()->accept(this)));
-  program_.set_header(header);
+namespace {
 
-  if (context->vardecl() != nullptr) {
-    auto* vardecl = dynamic_cast<Vardecl*>(
-        std::any_cast<Member*>(context->vardecl()->accept(this)));
-    program_.set_vardecl(vardecl);
-  }
+// What rule_of returns for a token.
+constexpr size_t token = static_cast<size_t>(-1);
 
-  if (context->constdecl() != nullptr) {
-    auto* constdecl = dynamic_cast<Constdecl*>(
-        std::any_cast<Member*>(context->constdecl()->accept(this)));
-    program_.set_constdecl(constdecl);
-  }
+size_t rule_of(antlr4::tree::ParseTree* child) {
+  return child->getTreeType() == antlr4::tree::ParseTreeType::RULE
+      ? static_cast<antlr4::RuleContext*>(child)->getRuleIndex()
+      : token;
+}
+
+// The child as the context of the rule the caller has checked, or that the
+// grammar puts there.
+template <class Context>
+Context* as(antlr4::tree::ParseTree* child) {
+  assert(rule_of(child) != token);
+  return static_cast<Context*>(child);
+}
 
-  auto* block = dynamic_cast<Block*>(
-      std::any_cast<Member*>(context->block()->accept(this)));
-  program_.set_block(block);
-  return header;
+// The `n`-th child of `context` that is a rule, or null if there are fewer.
+template <class Context>
+Context* rule(antlr4::ParserRuleContext* context, size_t n = 0) {
+  for (auto* child : context->children) {
+    if (rule_of(child) != token && n-- == 0) {
+      return as<Context>(child);
+    }
+  }
+  return nullptr;
 }
 
-static std::string trim_quotes(const std::string& str) {
+// A character or string literal, without its quotes.
+SymbolId intern_unquoted(Interner& symbols, std::string_view text) {
   // NOLINTNEXTLINE
-  assert(str[0] == '\'' && str[str.size() - 1] == '\'');
-  return str.substr(1, str.size() - 2);
+  assert(text[0] == '\'' && text[text.size() - 1] == '\'');
+  return symbols.intern(text.substr(1, text.size() - 2));
 }
 
-static std::string normalize_register(const std::string& str) {
-  auto text = str;
-  std::transform(text.begin(), text.end(), text.begin(), tolower);
-  return text;
+}  // namespace
+
+void Builder::build(PascalParser::ProgramContext* context) {
+  for (auto* child : context->children) {
+    switch (rule_of(child)) {
+      case PascalParser::RuleHeader:
+        program_.set_header(
+            build_header(as<PascalParser::HeaderContext>(child)));
+        break;
+      case PascalParser::RuleConstdecl:
+        program_.set_constdecl(
+            build_constdecl(as<PascalParser::ConstdeclContext>(child)));
+        break;
+      case PascalParser::RuleVardecl:
+        program_.set_vardecl(
+            build_vardecl(as<PascalParser::VardeclContext>(child)));
+        break;
+      case PascalParser::RuleBlock:
+        program_.set_block(build_block(as<PascalParser::BlockContext>(child)));
+        break;
+      default:
+        break;
+    }
+  }
 }
 
-std::any Builder::visitHeader(PascalParser::HeaderContext* context) {
-  auto* progname =
-      dynamic_cast<Id*>(std::any_cast<Member*>(visit(context->progname())));
-  return static_cast<Member*>(program_.create_node<Header>(progname));
+Header* Builder::build_header(PascalParser::HeaderContext* context) {
+  auto* progname = build_id(rule<PascalParser::IdContext>(
+      rule<PascalParser::PrognameContext>(context)));
+  return program_.create_node<Header>(progname);
 }
 
-std::any Builder::visitConstdecl(PascalParser::ConstdeclContext* context) {
+Constdecl* Builder::build_constdecl(PascalParser::ConstdeclContext* context) {
   Constdecl::Constdeclarations constdeclarations;
-  for (const auto& constdeclaration : context->constdeclaration()) {
-    constdeclarations.push_back(dynamic_cast<Constdeclaration*>(
-        std::any_cast<Member*>(visit(constdeclaration))));
+  for (auto* child : context->children) {
+    if (rule_of(child) == PascalParser::RuleConstdeclaration) {
+      constdeclarations.push_back(build_constdeclaration(
+          as<PascalParser::ConstdeclarationContext>(child)));
+    }
   }
-  return static_cast<Member*>(
-      program_.create_node<Constdecl>(constdeclarations));
+  return program_.create_node<Constdecl>(std::move(constdeclarations));
 }
 
-std::any Builder::visitConstdeclaration(
+Constdeclaration* Builder::build_constdeclaration(
     PascalParser::ConstdeclarationContext* context) {
-  auto* constname =
-      dynamic_cast<Id*>(std::any_cast<Member*>(visit(context->constname())));
-  auto* expression = dynamic_cast<Expression*>(
-      std::any_cast<Member*>(visit(context->expression())));
-  return static_cast<Member*>(
-      program_.create_node<Constdeclaration>(constname, expression));
-}
-
-std::any Builder::visitExpression(PascalParser::ExpressionContext* context) {
-  Expression::Operands operands;
-  Operation* operation = nullptr;
-  Expression::Signs signs;
-  Value* atom = nullptr;
-  bool brackets = context->LPAREN() != nullptr;
-
-  if (context->atom() == nullptr) {
-    if (!brackets) {
-      operation = dynamic_cast<Operation*>(
-          std::any_cast<Member*>(visit(context->operation())));
-    }
-    for (const auto& operand : context->expression()) {
-      operands.push_back(
-          dynamic_cast<Expression*>(std::any_cast<Member*>(visit(operand))));
-    }
-  } else {
-    for (const auto& sign : context->sign()) {
-      signs.push_back(
-          dynamic_cast<Operation*>(std::any_cast<Member*>(static_cast<Member*>(
-              program_.create_node<Operation>(sign->getText())))));
+  auto* constname = build_id(rule<PascalParser::IdContext>(
+      rule<PascalParser::ConstnameContext>(context, 0)));
+  auto* expression =
+      build_expression(rule<PascalParser::ExpressionContext>(context, 1));
+  return program_.create_node<Constdeclaration>(constname, expression);
+}
+
+Expression* Builder::build_expression(
+    PascalParser::ExpressionContext* context) {
+  // Of the three alternatives, only `expression operation expression`
+  // starts with an expression and only `LPAREN expression RPAREN` with a
+  // token.
+  const auto first = rule_of(context->children.front());
+  if (first == PascalParser::RuleExpression) {
+    return build_operations(context);
+  }
+
+  if (first == token) {
+    auto* inner =
+        build_expression(rule<PascalParser::ExpressionContext>(context));
+    return program_.create_node<Expression>(
+        inner, nullptr, nullptr, Expression::Signs{}, nullptr, true);
+  }
+
+  // The signs come before the atom, whose value may hold expressions of its
+  // own, so they are copied out of signs_ before it is built.
+  signs_.clear();
+  for (auto* child : context->children) {
+    if (rule_of(child) == PascalParser::RuleSign) {
+      signs_.push_back(
+          program_.create_node<Operation>(symbols_.intern(child->getText())));
     }
-    atom = dynamic_cast<Value*>(std::any_cast<Member*>(visit(context->atom())));
   }
+  const auto signs = program_.copy_nodes(signs_.data(), signs_.size());
+  auto* atom = build_value(rule<PascalParser::ValueContext>(
+      as<PascalParser::AtomContext>(context->children.back())));
+  return program_.create_node<Expression>(
+      nullptr, nullptr, nullptr, signs, atom, false);
+}
+
+Expression* Builder::build_operations(
+    PascalParser::ExpressionContext* context) {
+  // The grammar has a single precedence level, so `a + b * c` arrives as
+  // ((a + b) * c). Collect the operands along the left spine and regroup
+  // them by precedence. Nested chains use the stacks above this one's.
+  const auto rhs_begin = rhs_.size();
+  const auto operations_begin = operations_.size();
+  const auto operands_begin = operands_.size();
+  while (rule_of(context->children.front()) == PascalParser::RuleExpression) {
+    rhs_.push_back(rule<PascalParser::ExpressionContext>(context, 2));
+    operations_.push_back(
+        build_operation(rule<PascalParser::OperationContext>(context, 1)));
+    context = rule<PascalParser::ExpressionContext>(context, 0);
+  }
+  std::reverse(operations_.begin() + operations_begin, operations_.end());
 
-  return static_cast<Member*>(program_.create_node<Expression>(
-      operands, operation, signs, atom, brackets));
+  operands_.push_back(build_expression(context));
+  for (auto i = rhs_.size(); i != rhs_begin; --i) {
+    operands_.push_back(build_expression(rhs_[i - 1]));
+  }
+  auto* expression = group_operations(
+      program_,
+      operands_.data() + operands_begin,
+      operations_.data() + operations_begin,
+      operations_.size() - operations_begin);
+  rhs_.resize(rhs_begin);
+  operations_.resize(operations_begin);
+  operands_.resize(operands_begin);
+  return expression;
 }
 
-std::any Builder::visitBoolexpr(PascalParser::BoolexprContext* context) {
-  auto* operand1 = dynamic_cast<Expression*>(
-      std::any_cast<Member*>(visit(context->operand1())));
-  auto* booloperation = dynamic_cast<Booloperation*>(
-      std::any_cast<Member*>(visit(context->booloperation())));
-  auto* operand2 = dynamic_cast<Expression*>(
-      std::any_cast<Member*>(visit(context->operand2())));
-  return static_cast<Member*>(
-      program_.create_node<Boolexpr>(operand1, booloperation, operand2));
+Boolexpr* Builder::build_boolexpr(PascalParser::BoolexprContext* context) {
+  auto* operand1 = build_expression(rule<PascalParser::ExpressionContext>(
+      rule<PascalParser::Operand1Context>(context, 0)));
+  auto* booloperation = build_booloperation(
+      rule<PascalParser::BooloperationContext>(context, 1));
+  auto* operand2 = build_expression(rule<PascalParser::ExpressionContext>(
+      rule<PascalParser::Operand2Context>(context, 2)));
+  return program_.create_node<Boolexpr>(operand1, booloperation, operand2);
 }
 
-std::any Builder::visitVardecl(PascalParser::VardeclContext* context) {
+Vardecl* Builder::build_vardecl(PascalParser::VardeclContext* context) {
   Vardecl::Declarations declarations;
-  for (const auto& declaration : context->declaration()) {
-    declarations.push_back(
-        dynamic_cast<Declaration*>(std::any_cast<Member*>(visit(declaration))));
+  for (auto* child : context->children) {
+    if (rule_of(child) == PascalParser::RuleDeclaration) {
+      declarations.push_back(
+          build_declaration(as<PascalParser::DeclarationContext>(child)));
+    }
   }
-  return static_cast<Member*>(program_.create_node<Vardecl>(declarations));
+  return program_.create_node<Vardecl>(std::move(declarations));
 }
 
-std::any Builder::visitDeclaration(PascalParser::DeclarationContext* context) {
+Declaration* Builder::build_declaration(
+    PascalParser::DeclarationContext* context) {
   Declaration::Varnames varnames;
-  for (const auto& varname : context->varname()) {
-    varnames.push_back(
-        dynamic_cast<Id*>(std::any_cast<Member*>(visit(varname))));
+  Vartype* vartype = nullptr;
+  for (auto* child : context->children) {
+    switch (rule_of(child)) {
+      case PascalParser::RuleVarname:
+        varnames.push_back(build_id(rule<PascalParser::IdContext>(
+            as<PascalParser::VarnameContext>(child))));
+        break;
+      case PascalParser::RuleVartype:
+        vartype = build_vartype(as<PascalParser::VartypeContext>(child));
+        break;
+      default:
+        break;
+    }
   }
-  auto* vartype =
-      dynamic_cast<Vartype*>(std::any_cast<Member*>(visit(context->vartype())));
-  return static_cast<Member*>(
-      program_.create_node<Declaration>(varnames, vartype));
+  return program_.create_node<Declaration>(std::move(varnames), vartype);
 }
 
-std::any Builder::visitSimpletype(PascalParser::SimpletypeContext* context) {
-  return static_cast<Member*>(
-      program_.create_node<Simpletype>(normalize_register(context->getText())));
+Vartype* Builder::build_vartype(PascalParser::VartypeContext* context) {
+  auto* child = context->children.front();
+  if (rule_of(child) == PascalParser::RuleArraytype) {
+    return build_arraytype(as<PascalParser::ArraytypeContext>(child));
+  }
+  return build_simpletype(as<PascalParser::SimpletypeContext>(child));
+}
+
+Simpletype* Builder::build_simpletype(
+    PascalParser::SimpletypeContext* context) {
+  return program_.create_node<Simpletype>(
+      symbols_.intern_lowercase(context->getText()));
 }
 
-std::any Builder::visitInterval(PascalParser::IntervalContext* context) {
-  auto* lborder =
-      dynamic_cast<Value*>(std::any_cast<Member*>(visit(context->lborder())));
-  auto* rborder =
-      dynamic_cast<Value*>(std::any_cast<Member*>(visit(context->rborder())));
-  return static_cast<Member*>(program_.create_node<Interval>(lborder, rborder));
+Interval* Builder::build_interval(PascalParser::IntervalContext* context) {
+  auto* lborder = build_int(rule<PascalParser::IntContext>(
+      rule<PascalParser::LborderContext>(context, 0)));
+  auto* rborder = build_int(rule<PascalParser::IntContext>(
+      rule<PascalParser::RborderContext>(context, 1)));
+  return program_.create_node<Interval>(lborder, rborder);
 }
 
-std::any Builder::visitArraytype(PascalParser::ArraytypeContext* context) {
-  auto* interval = dynamic_cast<Interval*>(
-      std::any_cast<Member*>(visit(context->interval())));
-  auto* simpletype = dynamic_cast<Simpletype*>(
-      std::any_cast<Member*>(visit(context->simpletype())));
-  return static_cast<Member*>(
-      program_.create_node<Arraytype>(interval, simpletype));
+Arraytype* Builder::build_arraytype(PascalParser::ArraytypeContext* context) {
+  auto* interval =
+      build_interval(rule<PascalParser::IntervalContext>(context, 0));
+  auto* simpletype =
+      build_simpletype(rule<PascalParser::SimpletypeContext>(context, 1));
+  return program_.create_node<Arraytype>(interval, simpletype);
 }
 
-std::any Builder::visitBlock(PascalParser::BlockContext* context) {
+Block* Builder::build_block(PascalParser::BlockContext* context) {
   Block::Components components;
-  for (const auto& statement : context->statement()) {
-    components.push_back(
-        dynamic_cast<Statement*>(std::any_cast<Member*>(visit(statement))));
+  for (auto* child : context->children) {
+    if (rule_of(child) == PascalParser::RuleStatement) {
+      components.push_back(
+          build_statement(as<PascalParser::StatementContext>(child)));
+    }
   }
-  return static_cast<Member*>(program_.create_node<Block>(components));
+  return program_.create_node<Block>(std::move(components));
 }
 
-std::any Builder::visitFunctioncall(
-    PascalParser::FunctioncallContext* context) {
-  auto* functionname = dynamic_cast<Functionname*>(
-      std::any_cast<Member*>(visit(context->functionname())));
+Statement* Builder::build_statement(PascalParser::StatementContext* context) {
+  auto* child = context->children.front();
+  switch (rule_of(child)) {
+    case PascalParser::RuleBlock:
+      return build_block(as<PascalParser::BlockContext>(child));
+    case PascalParser::RuleFunctioncall:
+      return build_functioncall(as<PascalParser::FunctioncallContext>(child));
+    case PascalParser::RuleAssignment:
+      return build_assignment(as<PascalParser::AssignmentContext>(child));
+    case PascalParser::RuleWhile:
+      return build_while(as<PascalParser::WhileContext>(child));
+    case PascalParser::RuleBranch:
+      return build_branch(as<PascalParser::BranchContext>(child));
+    default:
+      assert(false);
+      return nullptr;
+  }
+}
 
+Functioncall* Builder::build_functioncall(
+    PascalParser::FunctioncallContext* context) {
+  Functionname* functionname = nullptr;
   Functioncall::Variables variables;
-  for (const auto& variable : context->variable()) {
-    variables.push_back(
-        dynamic_cast<Value*>(std::any_cast<Member*>(visit(variable))));
-  }
   Functioncall::Arguments arguments;
-  for (const auto& argument : context->argument()) {
-    arguments.push_back(
-        dynamic_cast<Expression*>(std::any_cast<Member*>(visit(argument))));
+  for (auto* child : context->children) {
+    switch (rule_of(child)) {
+      case PascalParser::RuleFunctionname:
+        functionname =
+            build_functionname(as<PascalParser::FunctionnameContext>(child));
+        break;
+      case PascalParser::RuleVariable:
+        variables.push_back(
+            build_variable(as<PascalParser::VariableContext>(child)));
+        break;
+      case PascalParser::RuleArgument:
+        arguments.push_back(build_expression(
+            rule<PascalParser::ExpressionContext>(
+                as<PascalParser::ArgumentContext>(child))));
+        break;
+      default:
+        break;
+    }
   }
+  return program_.create_node<Functioncall>(
+      functionname, std::move(variables), std::move(arguments));
+}
 
-  return static_cast<Member*>(
-      program_.create_node<Functioncall>(functionname, variables, arguments));
+Value* Builder::build_variable(PascalParser::VariableContext* context) {
+  auto* child = context->children.front();
+  if (rule_of(child) == PascalParser::RuleCell) {
+    return build_cell(as<PascalParser::CellContext>(child));
+  }
+  return build_id(
+      rule<PascalParser::IdContext>(as<PascalParser::VarnameContext>(child)));
 }
 
-std::any Builder::visitAssignment(PascalParser::AssignmentContext* context) {
+Assignment* Builder::build_assignment(
+    PascalParser::AssignmentContext* context) {
   Cell* cell = nullptr;
   Id* varname = nullptr;
-  if (context->cell() != nullptr) {
-    cell = dynamic_cast<Cell*>(std::any_cast<Member*>(visit(context->cell())));
+  auto* target = context->children.front();
+  if (rule_of(target) == PascalParser::RuleCell) {
+    cell = build_cell(as<PascalParser::CellContext>(target));
   } else {
-    varname =
-        dynamic_cast<Id*>(std::any_cast<Member*>(visit(context->varname())));
+    varname = build_id(rule<PascalParser::IdContext>(
+        as<PascalParser::VarnameContext>(target)));
   }
-  auto* modification = dynamic_cast<Modification*>(
-      std::any_cast<Member*>(visit(context->modification())));
-  auto* expression = dynamic_cast<Expression*>(
-      std::any_cast<Member*>(visit(context->expression())));
-  return static_cast<Member*>(program_.create_node<Assignment>(
-      cell, varname, modification, expression));
+  auto* modification =
+      build_modification(rule<PascalParser::ModificationContext>(context, 1));
+  auto* expression =
+      build_expression(rule<PascalParser::ExpressionContext>(context, 2));
+  return program_.create_node<Assignment>(
+      cell, varname, modification, expression);
 }
 
-std::any Builder::visitWhile(PascalParser::WhileContext* context) {
-  auto* boolexpr = dynamic_cast<Boolexpr*>(
-      std::any_cast<Member*>(visit(context->boolexpr())));
-  auto* statement = dynamic_cast<Statement*>(
-      std::any_cast<Member*>(visit(context->statement())));
-  return static_cast<Member*>(program_.create_node<While>(boolexpr, statement));
+While* Builder::build_while(PascalParser::WhileContext* context) {
+  auto* boolexpr =
+      build_boolexpr(rule<PascalParser::BoolexprContext>(context, 0));
+  auto* statement =
+      build_statement(rule<PascalParser::StatementContext>(context, 1));
+  return program_.create_node<While>(boolexpr, statement);
 }
 
-std::any Builder::visitBranch(PascalParser::BranchContext* context) {
+Branch* Builder::build_branch(PascalParser::BranchContext* context) {
   Statement* alternative = nullptr;
-  auto* boolexpr = dynamic_cast<Boolexpr*>(
-      std::any_cast<Member*>(visit(context->boolexpr())));
-  auto* statement = dynamic_cast<Statement*>(
-      std::any_cast<Member*>(visit(context->statement())));
-  if (context->alternative() != nullptr) {
-    alternative = dynamic_cast<Statement*>(
-        std::any_cast<Member*>(visit(context->alternative())));
+  auto* boolexpr =
+      build_boolexpr(rule<PascalParser::BoolexprContext>(context, 0));
+  auto* statement =
+      build_statement(rule<PascalParser::StatementContext>(context, 1));
+  if (auto* alternative_context =
+          rule<PascalParser::AlternativeContext>(context, 2)) {
+    alternative = build_statement(
+        rule<PascalParser::StatementContext>(alternative_context));
   }
-  return static_cast<Member*>(
-      program_.create_node<Branch>(boolexpr, statement, alternative));
+  return program_.create_node<Branch>(boolexpr, statement, alternative);
 }
 
-std::any Builder::visitOperation(PascalParser::OperationContext* context) {
-  return static_cast<Member*>(
-      program_.create_node<Operation>(normalize_register(context->getText())));
+Operation* Builder::build_operation(PascalParser::OperationContext* context) {
+  return program_.create_node<Operation>(
+      symbols_.intern_lowercase(context->getText()));
 }
 
-std::any Builder::visitBooloperation(
+Booloperation* Builder::build_booloperation(
     PascalParser::BooloperationContext* context) {
-  return static_cast<Member*>(program_.create_node<Booloperation>(
-      normalize_register(context->getText())));
+  return program_.create_node<Booloperation>(
+      symbols_.intern_lowercase(context->getText()));
 }
 
-std::any Builder::visitModification(
+Modification* Builder::build_modification(
     PascalParser::ModificationContext* context) {
-  return static_cast<Member*>(
-      program_.create_node<Modification>(context->getText()));
+  return program_.create_node<Modification>(
+      symbols_.intern(context->getText()));
 }
 
-std::any Builder::visitFunctionname(
+Functionname* Builder::build_functionname(
     PascalParser::FunctionnameContext* context) {
-  return static_cast<Member*>(program_.create_node<Functionname>(
-      normalize_register(context->getText())));
+  return program_.create_node<Functionname>(
+      symbols_.intern_lowercase(context->getText()));
+}
+
+Value* Builder::build_value(PascalParser::ValueContext* context) {
+  auto* child = context->children.front();
+  switch (rule_of(child)) {
+    case PascalParser::RuleId:
+      return build_id(as<PascalParser::IdContext>(child));
+    case PascalParser::RuleInt:
+      return build_int(as<PascalParser::IntContext>(child));
+    case PascalParser::RuleChar:
+      return build_char(as<PascalParser::CharContext>(child));
+    case PascalParser::RuleStringliteral:
+      return build_stringliteral(
+          as<PascalParser::StringliteralContext>(child));
+    case PascalParser::RuleCell:
+      return build_cell(as<PascalParser::CellContext>(child));
+    default:
+      assert(false);
+      return nullptr;
+  }
 }
 
-std::any Builder::visitId(PascalParser::IdContext* context) {
-  return static_cast<Member*>(
-      program_.create_node<Id>(normalize_register(context->getText())));
+Id* Builder::build_id(PascalParser::IdContext* context) {
+  return program_.create_node<Id>(
+      symbols_.intern_lowercase(context->getText()));
 }
 
-std::any Builder::visitCell(PascalParser::CellContext* context) {
-  auto* varname =
-      dynamic_cast<Id*>(std::any_cast<Member*>(visit(context->varname())));
-  auto* index = dynamic_cast<Expression*>(
-      std::any_cast<Member*>(visit(context->index())));
-  return static_cast<Member*>(program_.create_node<Cell>(varname, index));
+Cell* Builder::build_cell(PascalParser::CellContext* context) {
+  auto* varname = build_id(rule<PascalParser::IdContext>(
+      rule<PascalParser::VarnameContext>(context, 0)));
+  auto* index = build_expression(rule<PascalParser::ExpressionContext>(
+      rule<PascalParser::IndexContext>(context, 1)));
+  return program_.create_node<Cell>(varname, index);
 }
 
-std::any Builder::visitChar(PascalParser::CharContext* context) {
-  const auto text = trim_quotes(context->getText());
-  return static_cast<Member*>(program_.create_node<Char>(text));
+Char* Builder::build_char(PascalParser::CharContext* context) {
+  return program_.create_node<Char>(
+      intern_unquoted(symbols_, context->getText()));
 }
 
-std::any Builder::visitStringliteral(
+Stringliteral* Builder::build_stringliteral(
     PascalParser::StringliteralContext* context) {
-  const auto text = trim_quotes(context->getText());
-  return static_cast<Member*>(program_.create_node<Stringliteral>(text));
+  return program_.create_node<Stringliteral>(
+      intern_unquoted(symbols_, context->getText()));
 }
 
-std::any Builder::visitInt(PascalParser::IntContext* context) {
-  return static_cast<Member*>(program_.create_node<Int>(context->getText()));
+Int* Builder::build_int(PascalParser::IntContext* context) {
+  return program_.create_node<Int>(symbols_.intern(context->getText()));
 }
 
 }  // namespace pascal::ast::detail
@@ -3,53 +3,73 @@
 #include <libpas/ast/Ast.hpp>
 #include <libpas/compiler.hpp>
 
-#include <PascalBaseVisitor.h>
+#include <PascalParser.h>
+
+#include <vector>
 
 namespace pascal::ast::detail {
 
-class Builder final : public PascalBaseVisitor {
+// Builds an ast::Program from PascalParser's parse tree. Each rule has a
+// method that returns its node with its static type, so there is neither
+// std::any boxing, as a PascalVisitor would have, nor dynamic_cast back to
+// the node types. The children of a context are told apart by rule index,
+// since the generated accessors find them with a dynamic_cast each.
+class Builder final {
  public:
-  explicit Builder(ast::Program& program) : program_(program) {}
-
-  std::any visitProgram(PascalParser::ProgramContext* context) override;
-
-  std::any visitHeader(PascalParser::HeaderContext* context) override;
-
-  std::any visitConstdecl(PascalParser::ConstdeclContext* context) override;
-  std::any visitConstdeclaration(
-      PascalParser::ConstdeclarationContext* context) override;
-  std::any visitExpression(PascalParser::ExpressionContext* context) override;
-  std::any visitBoolexpr(PascalParser::BoolexprContext* context) override;
-
-  std::any visitVardecl(PascalParser::VardeclContext* context) override;
-  std::any visitDeclaration(PascalParser::DeclarationContext* context) override;
-  std::any visitSimpletype(PascalParser::SimpletypeContext* context) override;
-  std::any visitInterval(PascalParser::IntervalContext* context) override;
-  std::any visitArraytype(PascalParser::ArraytypeContext* context) override;
-
-  std::any visitBlock(PascalParser::BlockContext* context) override;
-  std::any visitFunctioncall(
-      PascalParser::FunctioncallContext* context) override;
-  std::any visitAssignment(PascalParser::AssignmentContext* context) override;
-  std::any visitWhile(PascalParser::WhileContext* context) override;
-  std::any visitBranch(PascalParser::BranchContext* context) override;
-  std::any visitOperation(PascalParser::OperationContext* context) override;
-  std::any visitBooloperation(
-      PascalParser::BooloperationContext* context) override;
-  std::any visitModification(
-      PascalParser::ModificationContext* context) override;
-  std::any visitFunctionname(
-      PascalParser::FunctionnameContext* context) override;
-
-  std::any visitId(PascalParser::IdContext* context) override;
-  std::any visitCell(PascalParser::CellContext* context) override;
-  std::any visitChar(PascalParser::CharContext* context) override;
-  std::any visitStringliteral(
-      PascalParser::StringliteralContext* context) override;
-  std::any visitInt(PascalParser::IntContext* context) override;
+  explicit Builder(ast::Program& program)
+      : program_(program), symbols_(program.symbols()) {}
+
+  void build(PascalParser::ProgramContext* context);
 
  private:
+  Header* build_header(PascalParser::HeaderContext* context);
+
+  Constdecl* build_constdecl(PascalParser::ConstdeclContext* context);
+  Constdeclaration* build_constdeclaration(
+      PascalParser::ConstdeclarationContext* context);
+  Expression* build_expression(PascalParser::ExpressionContext* context);
+  // A chain of binary expressions, grouped by precedence.
+  Expression* build_operations(PascalParser::ExpressionContext* context);
+  Boolexpr* build_boolexpr(PascalParser::BoolexprContext* context);
+
+  Vardecl* build_vardecl(PascalParser::VardeclContext* context);
+  Declaration* build_declaration(PascalParser::DeclarationContext* context);
+  Vartype* build_vartype(PascalParser::VartypeContext* context);
+  Simpletype* build_simpletype(PascalParser::SimpletypeContext* context);
+  Interval* build_interval(PascalParser::IntervalContext* context);
+  Arraytype* build_arraytype(PascalParser::ArraytypeContext* context);
+
+  Block* build_block(PascalParser::BlockContext* context);
+  Statement* build_statement(PascalParser::StatementContext* context);
+  Functioncall* build_functioncall(PascalParser::FunctioncallContext* context);
+  Value* build_variable(PascalParser::VariableContext* context);
+  Assignment* build_assignment(PascalParser::AssignmentContext* context);
+  While* build_while(PascalParser::WhileContext* context);
+  Branch* build_branch(PascalParser::BranchContext* context);
+  Operation* build_operation(PascalParser::OperationContext* context);
+  Booloperation* build_booloperation(
+      PascalParser::BooloperationContext* context);
+  Modification* build_modification(PascalParser::ModificationContext* context);
+  Functionname* build_functionname(PascalParser::FunctionnameContext* context);
+
+  Value* build_value(PascalParser::ValueContext* context);
+  Id* build_id(PascalParser::IdContext* context);
+  Cell* build_cell(PascalParser::CellContext* context);
+  Char* build_char(PascalParser::CharContext* context);
+  Stringliteral* build_stringliteral(
+      PascalParser::StringliteralContext* context);
+  Int* build_int(PascalParser::IntContext* context);
+
   ast::Program& program_;
+  // Identifiers and keywords are interned in lower case: they are
+  // case-insensitive.
+  Interner& symbols_;
+  // Stacks for build_operations, kept so that their memory is reused.
+  std::vector<PascalParser::ExpressionContext*> rhs_;
+  std::vector<Operation*> operations_;
+  std::vector<Expression*> operands_;
+  // An atom's signs before they are copied into the program's arena.
+  std::vector<Operation*> signs_;
 };
 
 }  // namespace pascal::ast::detail
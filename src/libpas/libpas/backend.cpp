@@ -0,0 +1,301 @@
+#include <libpas/backend.hpp>
+
+#include <fmt/format.h>
+
+#include <llvm/ADT/StringMap.h>
+#include <llvm/ADT/Triple.h>
+#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/Module.h>
+#include <llvm/MC/MCSubtargetInfo.h>
+#include <llvm/MC/SubtargetFeature.h>
+#include <llvm/MC/TargetRegistry.h>
+#include <llvm/Passes/OptimizationLevel.h>
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/FileUtilities.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Support/Program.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
+#include <llvm/Target/TargetOptions.h>
+
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace pascal::backend {
+
+namespace {
+
+void initialize_native_target() {
+  static std::once_flag flag;
+  std::call_once(flag, [] {
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+  });
+}
+
+std::string find_linker() {
+  for (const auto* name : {"clang", "cc", "gcc"}) {
+    auto path = llvm::sys::findProgramByName(name);
+    if (path) {
+      return *path;
+    }
+  }
+  throw BackendError("Unable to find a linker driver (clang, cc or gcc)");
+}
+
+void link_executable(
+    std::string_view object_file,
+    std::string_view output_file) {
+  const auto linker = find_linker();
+  const std::string object(object_file);
+  const std::string output(output_file);
+  const llvm::StringRef args[] = {linker, object, "-o", output};
+
+  std::string error;
+  const auto status = llvm::sys::ExecuteAndWait(
+      linker, args, llvm::None, {}, 0, 0, &error);
+  if (status != 0) {
+    throw BackendError(
+        error.empty() ? fmt::format("Linker exited with status {}", status)
+                      : error);
+  }
+}
+
+std::string host_features() {
+  llvm::StringMap<bool> host_features;
+  llvm::SubtargetFeatures features;
+  if (llvm::sys::getHostCPUFeatures(host_features)) {
+    for (const auto& feature : host_features) {
+      features.AddFeature(feature.first(), feature.second);
+    }
+  }
+  return features.getString();
+}
+
+llvm::CodeGenOpt::Level to_codegen_level(OptLevel level) {
+  switch (level) {
+    case OptLevel::O1:
+      return llvm::CodeGenOpt::Less;
+    case OptLevel::O2:
+      return llvm::CodeGenOpt::Default;
+    case OptLevel::O3:
+      return llvm::CodeGenOpt::Aggressive;
+    default:
+      return llvm::CodeGenOpt::None;
+  }
+}
+
+std::unique_ptr<llvm::TargetMachine> create_target_machine(
+    llvm::Module& module,
+    OptLevel level,
+    std::string_view cpu_name) {
+  initialize_native_target();
+
+  auto triple = module.getTargetTriple();
+  if (triple.empty()) {
+    triple = llvm::sys::getDefaultTargetTriple();
+    module.setTargetTriple(triple);
+  }
+
+  std::string error;
+  const auto* target = llvm::TargetRegistry::lookupTarget(triple, error);
+  if (target == nullptr) {
+    throw BackendError(error);
+  }
+
+  // Code runs on any machine of the triple unless a CPU is asked for.
+  std::string cpu(cpu_name);
+  std::string features;
+  if (cpu == native_cpu) {
+    if (llvm::Triple(triple).normalize() !=
+        llvm::Triple(llvm::sys::getDefaultTargetTriple()).normalize()) {
+      throw BackendError(fmt::format(
+          "The host CPU cannot be used for target '{}'", triple));
+    }
+    cpu = llvm::sys::getHostCPUName().str();
+    features = host_features();
+  } else if (cpu != generic_cpu) {
+    const std::unique_ptr<llvm::MCSubtargetInfo> subtarget(
+        target->createMCSubtargetInfo(triple, cpu, ""));
+    if (!subtarget || !subtarget->isCPUStringValid(cpu)) {
+      throw BackendError(
+          fmt::format("Unknown CPU '{}' for target '{}'", cpu, triple));
+    }
+  }
+
+  std::unique_ptr<llvm::TargetMachine> machine(target->createTargetMachine(
+      triple,
+      cpu,
+      features,
+      llvm::TargetOptions(),
+      llvm::Reloc::PIC_,
+      llvm::None,
+      to_codegen_level(level)));
+  module.setDataLayout(machine->createDataLayout());
+  return machine;
+}
+
+template <class T>
+T unwrap(llvm::Expected<T> value) {
+  if (!value) {
+    throw BackendError(llvm::toString(value.takeError()));
+  }
+  return std::move(*value);
+}
+
+void check(llvm::Error error) {
+  if (error) {
+    throw BackendError(llvm::toString(std::move(error)));
+  }
+}
+
+template <class BuildPipeline>
+void run_pipeline(
+    llvm::Module& module,
+    OptLevel level,
+    std::string_view cpu,
+    BuildPipeline build_pipeline) {
+  auto machine = create_target_machine(module, level, cpu);
+
+  llvm::LoopAnalysisManager loop_manager;
+  llvm::FunctionAnalysisManager function_manager;
+  llvm::CGSCCAnalysisManager cgscc_manager;
+  llvm::ModuleAnalysisManager module_manager;
+
+  llvm::PassBuilder pass_builder(machine.get());
+  pass_builder.registerModuleAnalyses(module_manager);
+  pass_builder.registerCGSCCAnalyses(cgscc_manager);
+  pass_builder.registerFunctionAnalyses(function_manager);
+  pass_builder.registerLoopAnalyses(loop_manager);
+  pass_builder.crossRegisterProxies(
+      loop_manager, function_manager, cgscc_manager, module_manager);
+
+  auto pass_manager = build_pipeline(pass_builder);
+  pass_manager.run(module, module_manager);
+}
+
+}  // namespace
+
+void optimize(llvm::Module& module, OptLevel level, std::string_view cpu) {
+  if (level == OptLevel::O0) {
+    return;
+  }
+  run_pipeline(module, level, cpu, [level](llvm::PassBuilder& pass_builder) {
+    switch (level) {
+      case OptLevel::O1:
+        return pass_builder.buildPerModuleDefaultPipeline(
+            llvm::OptimizationLevel::O1);
+      case OptLevel::O2:
+        return pass_builder.buildPerModuleDefaultPipeline(
+            llvm::OptimizationLevel::O2);
+      default:
+        return pass_builder.buildPerModuleDefaultPipeline(
+            llvm::OptimizationLevel::O3);
+    }
+  });
+}
+
+void optimize(
+    llvm::Module& module,
+    std::string_view passes,
+    std::string_view cpu) {
+  run_pipeline(
+      module, OptLevel::O2, cpu, [passes](llvm::PassBuilder& pass_builder) {
+        llvm::ModulePassManager pass_manager;
+        if (auto error =
+                pass_builder.parsePassPipeline(pass_manager, passes)) {
+          throw BackendError(fmt::format(
+              "Invalid pass pipeline '{}': {}",
+              passes,
+              llvm::toString(std::move(error))));
+        }
+        return pass_manager;
+      });
+}
+
+void emit_object(
+    llvm::Module& module,
+    llvm::raw_pwrite_stream& out,
+    OptLevel level,
+    std::string_view cpu) {
+  auto machine = create_target_machine(module, level, cpu);
+
+  llvm::legacy::PassManager pass_manager;
+  if (machine->addPassesToEmitFile(
+          pass_manager, out, nullptr, llvm::CGFT_ObjectFile)) {
+    throw BackendError(fmt::format(
+        "Target '{}' cannot emit object files", module.getTargetTriple()));
+  }
+  pass_manager.run(module);
+}
+
+void emit_executable(
+    llvm::Module& module,
+    std::string_view output_file,
+    OptLevel level,
+    std::string_view cpu) {
+  int fd = -1;
+  llvm::SmallString<128> object_file;
+  if (const auto ec = llvm::sys::fs::createTemporaryFile(
+          "pascal", "o", fd, object_file)) {
+    throw BackendError(ec.message());
+  }
+  const llvm::FileRemover remover(object_file);
+
+  {
+    llvm::raw_fd_ostream object_stream(fd, /*shouldClose=*/true);
+    emit_object(module, object_stream, level, cpu);
+  }
+
+  link_executable(object_file.str(), output_file);
+}
+
+RunResult run(
+    std::unique_ptr<llvm::Module> module,
+    std::unique_ptr<llvm::LLVMContext> context,
+    OptLevel level) {
+  using Clock = std::chrono::steady_clock;
+  initialize_native_target();
+
+  const auto compile_start = Clock::now();
+  auto machine_builder =
+      unwrap(llvm::orc::JITTargetMachineBuilder::detectHost());
+  machine_builder.setCodeGenOptLevel(to_codegen_level(level));
+  auto jit = unwrap(llvm::orc::LLJITBuilder()
+                        .setJITTargetMachineBuilder(std::move(machine_builder))
+                        .create());
+
+  // printf, scanf and the string functions come from the C runtime the
+  // compiler itself is linked against.
+  jit->getMainJITDylib().addGenerator(
+      unwrap(llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
+          jit->getDataLayout().getGlobalPrefix())));
+
+  module->setTargetTriple(jit->getTargetTriple().str());
+  module->setDataLayout(jit->getDataLayout());
+  check(jit->addIRModule(
+      llvm::orc::ThreadSafeModule(std::move(module), std::move(context))));
+  const auto main_symbol = unwrap(jit->lookup("main"));
+  // NOLINTNEXTLINE
+  auto* main = reinterpret_cast<int (*)()>(main_symbol.getAddress());
+
+  const auto run_start = Clock::now();
+  RunResult result;
+  result.exit_code = main();
+  std::fflush(stdout);
+  const auto run_end = Clock::now();
+
+  result.compile_time = run_start - compile_start;
+  result.run_time = run_end - run_start;
+  return result;
+}
+
+}  // namespace pascal::backend
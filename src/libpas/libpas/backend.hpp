@@ -0,0 +1,71 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+
+namespace llvm {
+class LLVMContext;
+class Module;
+class raw_pwrite_stream;
+}  // namespace llvm
+
+namespace pascal::backend {
+
+class BackendError final : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+enum class OptLevel { O0, O1, O2, O3 };
+
+// The CPU code is generated for. The generic one runs on every machine of
+// the target triple; "native" is the host's CPU with all of its features,
+// and any other name is one LLVM knows for the target, e.g. "skylake".
+inline constexpr std::string_view generic_cpu = "generic";
+inline constexpr std::string_view native_cpu = "native";
+
+// Runs the new pass manager's default per-module pipeline for the level.
+void optimize(
+    llvm::Module& module,
+    OptLevel level,
+    std::string_view cpu = generic_cpu);
+
+// Runs a textual pipeline in `opt -passes=` syntax, e.g. "mem2reg,instcombine".
+void optimize(
+    llvm::Module& module,
+    std::string_view passes,
+    std::string_view cpu = generic_cpu);
+
+// Lowers the module to a native object file for its target triple
+// (the host triple if the module has none).
+void emit_object(
+    llvm::Module& module,
+    llvm::raw_pwrite_stream& out,
+    OptLevel level = OptLevel::O0,
+    std::string_view cpu = generic_cpu);
+
+// Emits the module into a temporary object file and links it against the
+// C runtime with the system compiler driver.
+void emit_executable(
+    llvm::Module& module,
+    std::string_view output_file,
+    OptLevel level = OptLevel::O0,
+    std::string_view cpu = generic_cpu);
+
+struct RunResult {
+  int exit_code = 0;
+  std::chrono::nanoseconds compile_time{};
+  std::chrono::nanoseconds run_time{};
+};
+
+// JIT-compiles the module with ORC LLJIT for the host CPU and calls its
+// `main` in this process, so the program shares the compiler's stdin and
+// stdout.
+RunResult run(
+    std::unique_ptr<llvm::Module> module,
+    std::unique_ptr<llvm::LLVMContext> context,
+    OptLevel level = OptLevel::O0);
+
+}  // namespace pascal::backend
@@ -2,19 +2,35 @@
 #include <libpas/ast/SemanticAnalysier.hpp>
 #include <libpas/ast/XmlSerializer.hpp>
 #include <libpas/ast/detail/Builder.hpp>
+#include <libpas/backend.hpp>
 #include <libpas/compiler.hpp>
+#include <libpas/input_stream.hpp>
 
 #include <PascalLexer.h>
 #include <PascalParser.h>
+#include <WarmupCorpus.hpp>
 
 #include <fmt/format.h>
 
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Support/raw_os_ostream.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <mutex>
+#include <optional>
+#include <vector>
 
 namespace pascal {
 
 namespace {
 
+std::atomic<uint64_t> parses{0};
+std::atomic<uint64_t> ll_fallbacks{0};
+
 class StreamErrorListener : public antlr4::BaseErrorListener {
  public:
   void syntaxError(
@@ -33,17 +49,90 @@ class StreamErrorListener : public antlr4::BaseErrorListener {
   Errors errors_;
 };
 
-}  // namespace
+// Puts a ProfilingATNSimulator in place of the parser's own simulator for
+// as long as it lives. Both share the parser's ATN and DFA caches.
+class Profiler {
+ public:
+  explicit Profiler(PascalParser& parser)
+      : parser_(parser),
+        original_(parser.getInterpreter<antlr4::atn::ParserATNSimulator>()),
+        simulator_(&parser) {
+    parser_.setInterpreter(&simulator_);
+  }
 
-ParseResult parse(PascalLexer& lexer) {
-  antlr4::CommonTokenStream tokens(&lexer);
+  // The parser deletes whichever simulator it has when it is destroyed.
+  ~Profiler() { parser_.setInterpreter(original_); }
+
+  Profiler(const Profiler&) = delete;
+  Profiler& operator=(const Profiler&) = delete;
+
+  void add_to(ParserProfile& profile) {
+    const auto& decisions = simulator_.getDecisionInfo();
+    const auto& atn = parser_.getATN();
+    const auto& rule_names = parser_.getRuleNames();
+    if (profile.size() < decisions.size()) {
+      profile.resize(decisions.size());
+    }
+    const auto count = [](long long value) {
+      return static_cast<uint64_t>(value);
+    };
+    for (const auto& info : decisions) {
+      auto& entry = profile[info.decision];
+      entry.decision_ = info.decision;
+      entry.rule_ = rule_names[atn.getDecisionState(info.decision)->ruleIndex];
+      entry.invocations_ += count(info.invocations);
+      entry.time_ns_ += count(info.timeInPrediction);
+      entry.sll_total_lookahead_ += count(info.SLL_TotalLook);
+      entry.sll_max_lookahead_ =
+          std::max(entry.sll_max_lookahead_, count(info.SLL_MaxLook));
+      entry.ll_fallbacks_ += count(info.LL_Fallback);
+      entry.ll_total_lookahead_ += count(info.LL_TotalLook);
+      entry.ll_max_lookahead_ =
+          std::max(entry.ll_max_lookahead_, count(info.LL_MaxLook));
+      entry.ambiguities_ += info.ambiguities.size();
+      entry.context_sensitivities_ += info.contextSensitivities.size();
+    }
+  }
+
+ private:
+  PascalParser& parser_;
+  antlr4::atn::ParserATNSimulator* original_;
+  antlr4::atn::ProfilingATNSimulator simulator_;
+};
+
+ParseResult parse_tokens(antlr4::TokenStream& tokens, ParserProfile* profile) {
   PascalParser parser(&tokens);
+  ++parses;
+  std::optional<Profiler> profiler;
+  if (profile != nullptr) {
+    profiler.emplace(parser);
+  }
 
-  StreamErrorListener error_listener;
+  // SLL prediction is enough for almost every program and much cheaper
+  // than full LL. It may reject a valid program, though, and its error
+  // messages differ, so on any syntax error the program is parsed again
+  // with full LL and the usual error recovery.
+  auto* interpreter = parser.getInterpreter<antlr4::atn::ParserATNSimulator>();
+  interpreter->setPredictionMode(antlr4::atn::PredictionMode::SLL);
   parser.removeErrorListeners();
-  parser.addErrorListener(&error_listener);
+  parser.setErrorHandler(std::make_shared<antlr4::BailErrorStrategy>());
 
-  auto* program_parse_tree = parser.program();
+  StreamErrorListener error_listener;
+  PascalParser::ProgramContext* program_parse_tree = nullptr;
+  try {
+    program_parse_tree = parser.program();
+  } catch (const antlr4::ParseCancellationException&) {
+    ++ll_fallbacks;
+    interpreter->setPredictionMode(antlr4::atn::PredictionMode::LL);
+    parser.addErrorListener(&error_listener);
+    parser.setErrorHandler(std::make_shared<antlr4::DefaultErrorStrategy>());
+    parser.reset();
+    program_parse_tree = parser.program();
+  }
+
+  if (profiler) {
+    profiler->add_to(*profile);
+  }
 
   const auto& errors = error_listener.errors();
   if (!errors.empty()) {
@@ -52,15 +141,156 @@ ParseResult parse(PascalLexer& lexer) {
 
   ast::Program program;
   ast::detail::Builder builder(program);
-  builder.visit(program_parse_tree);
+  builder.build(program_parse_tree);
 
   return ParseResult::program(std::move(program));
 }
 
+}  // namespace
+
+ParseResult parse(PascalLexer& lexer) {
+  antlr4::CommonTokenStream tokens(&lexer);
+  return parse(tokens);
+}
+
+ParseResult parse(antlr4::TokenSource& lexer) {
+  antlr4::CommonTokenStream tokens(&lexer);
+  return parse(tokens);
+}
+
+ParseResult parse(antlr4::CharStream& input) {
+  PascalLexer lexer(&input);
+  return parse(lexer);
+}
+
+ParseResult parse(antlr4::TokenStream& tokens) {
+  return parse_tokens(tokens, nullptr);
+}
+
+ParseResult parse(antlr4::TokenStream& tokens, ParserProfile& profile) {
+  return parse_tokens(tokens, &profile);
+}
+
+ParseResult parse(DescentParser& parser) {
+  if (auto program = parser.parse()) {
+    return ParseResult::program(std::move(*program));
+  }
+  ByteStream input(parser.source());
+  return parse(input);
+}
+
+ParseStats parse_stats() {
+  return ParseStats{parses.load(), ll_fallbacks.load()};
+}
+
+void preload_parser() {
+  static std::once_flag preloaded;
+  std::call_once(preloaded, [] {
+    for (const auto& source : grammar::warmup_corpus()) {
+      ByteStream input(source.text_, std::string(source.name_));
+      parse(input);
+    }
+  });
+}
+
+void dump_parser_profile(const ParserProfile& profile, std::ostream& out) {
+  std::vector<const DecisionProfile*> ranked;
+  size_t rule_width = 4;
+  for (const auto& entry : profile) {
+    if (entry.invocations_ > 0) {
+      ranked.push_back(&entry);
+      rule_width = std::max(rule_width, entry.rule_.size());
+    }
+  }
+  std::stable_sort(
+      ranked.begin(), ranked.end(), [](const auto* lhs, const auto* rhs) {
+        return lhs->time_ns_ > rhs->time_ns_;
+      });
+
+  const auto average = [](uint64_t total, uint64_t count) {
+    return count == 0 ? 0.0
+                      : static_cast<double>(total) / static_cast<double>(count);
+  };
+  out << fmt::format(
+      "{:>8}  {:<{}}{:>12}{:>11}{:>9}{:>9}{:>14}{:>8}{:>8}{:>13}\n",
+      "Decision",
+      "Rule",
+      rule_width,
+      "Invocations",
+      "Time (ms)",
+      "SLL avg",
+      "SLL max",
+      "LL fallbacks",
+      "LL avg",
+      "LL max",
+      "Ambiguities");
+  for (const auto* entry : ranked) {
+    out << fmt::format(
+        "{:>8}  {:<{}}{:>12}{:>11.3f}{:>9.2f}{:>9}{:>14}{:>8.2f}{:>8}{:>13}\n",
+        entry->decision_,
+        entry->rule_,
+        rule_width,
+        entry->invocations_,
+        static_cast<double>(entry->time_ns_) / 1e6,
+        average(entry->sll_total_lookahead_, entry->invocations_),
+        entry->sll_max_lookahead_,
+        entry->ll_fallbacks_,
+        average(entry->ll_total_lookahead_, entry->ll_fallbacks_),
+        entry->ll_max_lookahead_,
+        entry->ambiguities_);
+  }
+}
+
 void dump_ast(ast::Program& program, std::ostream& out) {
   ast::XmlSerializer::exec(program, out);
 }
 
+bool dump_binary_ast(
+    ast::Program& program,
+    const ast::SymbolTable* symbol_table,
+    std::ostream& out,
+    std::ostream& err) {
+  try {
+    ast::BinaryAst::write(program, symbol_table, out);
+  } catch (const ast::BinaryAstError& e) {
+    err << fmt::format("Error: {}\n", e.what());
+    return false;
+  }
+  return true;
+}
+
+bool dump_binary_ast(
+    const ast::FlatAst& ast,
+    const ast::SymbolTable* symbol_table,
+    std::ostream& out,
+    std::ostream& err) {
+  try {
+    ast::BinaryAst::write(ast, symbol_table, out);
+  } catch (const ast::BinaryAstError& e) {
+    err << fmt::format("Error: {}\n", e.what());
+    return false;
+  }
+  return true;
+}
+
+bool load_binary_ast(
+    std::string_view bytes,
+    ast::Program& program,
+    std::optional<ast::SymbolTable>& symbol_table,
+    std::ostream& out) {
+  try {
+    const ast::BinaryAst binary_ast(bytes);
+    program = binary_ast.program();
+    if (binary_ast.analysed()) {
+      symbol_table = binary_ast.symbol_table(program);
+    }
+  } catch (const ast::BinaryAstError& e) {
+    out << fmt::format("Error: {}\n", e.what());
+    return false;
+  }
+  return true;
+}
+
 bool semantic_analyse(
     ast::Program& program,
     ast::SymbolTable& symbol_table,
@@ -74,19 +304,117 @@ bool semantic_analyse(
   return true;
 }
 
+std::unique_ptr<llvm::Module> code_generate(
+    ast::Program& program,
+    ast::SymbolTable& symbol_table,
+    llvm::LLVMContext& context) {
+  return ast::CodeGenerator::exec(program, symbol_table, context);
+}
+
 void code_generate(
     ast::Program& program,
     ast::SymbolTable& symbol_table,
     std::ostream& out) {
-  ast::CodeGenerator::exec(program, symbol_table, out);
+  llvm::LLVMContext context;
+  auto module = code_generate(program, symbol_table, context);
+  dump_asm(*module, out);
+}
+
+bool semantic_analyse(
+    ast::FlatAst& ast,
+    ast::SymbolTable& symbol_table,
+    std::ostream& out) {
+  try {
+    symbol_table = ast::SemanticAnalysier::exec(ast);
+  } catch (const ast::SemanticError& e) {
+    out << fmt::format("Error: {}\n", e.what());
+    return false;
+  }
+  return true;
+}
+
+std::unique_ptr<llvm::Module> code_generate(
+    const ast::FlatAst& ast,
+    ast::SymbolTable& symbol_table,
+    llvm::LLVMContext& context) {
+  return ast::CodeGenerator::exec(ast, symbol_table, context);
 }
 
-void exec_generate(std::string_view input_file, std::string_view output_file) {
-  std::stringstream ss;
-  ss << "clang " << input_file << " -o " << output_file;
-  const auto str = ss.str();
-  // NOLINTNEXTLINE
-  system(str.c_str());
+bool optimize(
+    llvm::Module& module,
+    backend::OptLevel level,
+    std::string_view passes,
+    std::ostream& out,
+    std::string_view cpu) {
+  try {
+    if (passes.empty()) {
+      backend::optimize(module, level, cpu);
+    } else {
+      backend::optimize(module, passes, cpu);
+    }
+  } catch (const backend::BackendError& e) {
+    out << fmt::format("Error: {}\n", e.what());
+    return false;
+  }
+  return true;
+}
+
+void dump_asm(llvm::Module& module, std::ostream& out) {
+  llvm::raw_os_ostream stream(out);
+  module.print(stream, nullptr);
+}
+
+void dump_bitcode(llvm::Module& module, std::ostream& out) {
+  llvm::raw_os_ostream stream(out);
+  llvm::WriteBitcodeToFile(module, stream);
+}
+
+bool dump_object(
+    llvm::Module& module,
+    std::ostream& out,
+    std::ostream& err,
+    backend::OptLevel level,
+    std::string_view cpu) {
+  // Object writers seek back to patch headers, which a pipe cannot do, so
+  // the object is assembled in memory and written out in one piece.
+  llvm::SmallVector<char, 0> object;
+  try {
+    llvm::raw_svector_ostream stream(object);
+    backend::emit_object(module, stream, level, cpu);
+  } catch (const backend::BackendError& e) {
+    err << fmt::format("Error: {}\n", e.what());
+    return false;
+  }
+  out.write(object.data(), static_cast<std::streamsize>(object.size()));
+  return true;
+}
+
+bool exec_generate(
+    llvm::Module& module,
+    std::string_view output_file,
+    std::ostream& out,
+    backend::OptLevel level,
+    std::string_view cpu) {
+  try {
+    backend::emit_executable(module, output_file, level, cpu);
+  } catch (const backend::BackendError& e) {
+    out << fmt::format("Error: {}\n", e.what());
+    return false;
+  }
+  return true;
+}
+
+std::optional<backend::RunResult> run(
+    std::unique_ptr<llvm::Module> module,
+    std::unique_ptr<llvm::LLVMContext> context,
+    std::ostream& out,
+    backend::OptLevel level) {
+  try {
+    return backend::run(std::move(module), std::move(context), level);
+  } catch (const backend::BackendError& e) {
+    out << fmt::format("Error: {}\n", e.what());
+  }
+  return std::nullopt;
 }
 
 void dump_errors(const Errors& errors, std::ostream& out) {
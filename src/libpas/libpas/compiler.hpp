@@ -1,11 +1,24 @@
 #pragma once
 
 #include <libpas/ast/Ast.hpp>
+#include <libpas/ast/BinaryAst.hpp>
+#include <libpas/ast/FlatAst.hpp>
 #include <libpas/ast/SymbolTable.hpp>
+#include <libpas/backend.hpp>
+#include <libpas/descent_parser.hpp>
 
 #include <PascalLexer.h>
 
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+
+#include <cstdint>
 #include <iosfwd>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace pascal {
 
@@ -35,17 +48,126 @@ struct ParseResult {
 };
 
 ParseResult parse(PascalLexer& lexer);
+// Parses the tokens of any lexer, e.g. a DfaTokenSource.
+ParseResult parse(antlr4::TokenSource& lexer);
+ParseResult parse(antlr4::CharStream& input);
+// Parses tokens that may already have been read, e.g. to time lexing alone,
+// or an ArenaTokenStream.
+ParseResult parse(antlr4::TokenStream& tokens);
+// Prediction statistics of one PascalParser decision, as gathered by ANTLR's
+// ProfilingATNSimulator. Lookahead is counted in tokens. The LL figures are
+// those of full-context prediction, which runs when SLL finds a conflict.
+struct DecisionProfile {
+  size_t decision_ = 0;
+  std::string rule_;
+  uint64_t invocations_ = 0;
+  uint64_t time_ns_ = 0;
+  uint64_t sll_total_lookahead_ = 0;
+  uint64_t sll_max_lookahead_ = 0;
+  uint64_t ll_fallbacks_ = 0;
+  uint64_t ll_total_lookahead_ = 0;
+  uint64_t ll_max_lookahead_ = 0;
+  uint64_t ambiguities_ = 0;
+  uint64_t context_sensitivities_ = 0;
+};
+
+// Indexed by decision number and summed over all profiled parses.
+using ParserProfile = std::vector<DecisionProfile>;
 
+// Like parse(tokens), and adds what ProfilingATNSimulator saw to `profile`.
+ParseResult parse(antlr4::TokenStream& tokens, ParserProfile& profile);
+// Builds the program with the hand-written parser. On a syntax error the
+// source is parsed again by PascalParser, which reports the errors.
+ParseResult parse(DescentParser& parser);
+
+// parse() first tries SLL prediction and falls back to full LL when it
+// fails. Counted over the whole process.
+struct ParseStats {
+  uint64_t parses_ = 0;
+  uint64_t ll_fallbacks_ = 0;
+};
+
+ParseStats parse_stats();
+
+// Parses the warm-up corpus built into the Pascal library, once per process.
+// That deserializes the ATNs of PascalLexer and PascalParser and fills their
+// DFA caches, which all instances share, so the first real parse runs about
+// as fast as later ones. The corpus parses count in parse_stats().
+void preload_parser();
+
+// Prints the decisions that were predicted, the most time-consuming first.
+void dump_parser_profile(const ParserProfile& profile, std::ostream& out);
 void dump_ast(ast::Program& program, std::ostream& out);
+// Writes the program in ast::BinaryAst's format, with the symbol table
+// semantic analysis returned for it unless that is null. Writes nothing and
+// reports the error to `err` if the format cannot hold the program, e.g.
+// one nested deeper than ast::BinaryAst::max_depth.
+bool dump_binary_ast(
+    ast::Program& program,
+    const ast::SymbolTable* symbol_table,
+    std::ostream& out,
+    std::ostream& err);
+// The same for a FlatAst, with the types its semantic analysis gave it.
+bool dump_binary_ast(
+    const ast::FlatAst& ast,
+    const ast::SymbolTable* symbol_table,
+    std::ostream& out,
+    std::ostream& err);
+// Builds the program a binary AST holds. `symbol_table` is set when it was
+// written with one; the program still needs semantic analysis before
+// codegen, since loading does not check its types.
+bool load_binary_ast(
+    std::string_view bytes,
+    ast::Program& program,
+    std::optional<ast::SymbolTable>& symbol_table,
+    std::ostream& out);
 bool semantic_analyse(
     ast::Program& program,
     ast::SymbolTable& symbol_table,
     std::ostream& out);
+std::unique_ptr<llvm::Module> code_generate(
+    ast::Program& program,
+    ast::SymbolTable& symbol_table,
+    llvm::LLVMContext& context);
 void code_generate(
     ast::Program& program,
     ast::SymbolTable& symbol_table,
     std::ostream& out);
-void exec_generate(std::string_view input_file, std::string_view output_file);
+// The same passes over ast::FlatAst::flatten(program), which produce the
+// same errors and the same module.
+bool semantic_analyse(
+    ast::FlatAst& ast,
+    ast::SymbolTable& symbol_table,
+    std::ostream& out);
+std::unique_ptr<llvm::Module> code_generate(
+    const ast::FlatAst& ast,
+    ast::SymbolTable& symbol_table,
+    llvm::LLVMContext& context);
+bool optimize(
+    llvm::Module& module,
+    backend::OptLevel level,
+    std::string_view passes,
+    std::ostream& out,
+    std::string_view cpu = backend::generic_cpu);
+void dump_asm(llvm::Module& module, std::ostream& out);
+void dump_bitcode(llvm::Module& module, std::ostream& out);
+bool dump_object(
+    llvm::Module& module,
+    std::ostream& out,
+    std::ostream& err,
+    backend::OptLevel level = backend::OptLevel::O0,
+    std::string_view cpu = backend::generic_cpu);
+bool exec_generate(
+    llvm::Module& module,
+    std::string_view output_file,
+    std::ostream& out,
+    backend::OptLevel level = backend::OptLevel::O0,
+    std::string_view cpu = backend::generic_cpu);
+std::optional<backend::RunResult> run(
+    std::unique_ptr<llvm::Module> module,
+    std::unique_ptr<llvm::LLVMContext> context,
+    std::ostream& out,
+    backend::OptLevel level = backend::OptLevel::O0);
 void dump_errors(
     const Errors& errors,
     std::ostream& out /*, std::istream& in*/);
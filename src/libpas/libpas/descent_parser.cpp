@@ -0,0 +1,540 @@
+#include <libpas/descent_parser.hpp>
+
+#include <PascalLexer.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace pascal {
+
+namespace {
+
+class SyntaxError final : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+bool is_operation(size_t type) {
+  return type == PascalLexer::PLUS || type == PascalLexer::MINUS ||
+      type == PascalLexer::STAR || type == PascalLexer::DIV ||
+      type == PascalLexer::MOD;
+}
+
+bool is_booloperation(size_t type) {
+  return type == PascalLexer::EQUAL || type == PascalLexer::MORETHEN ||
+      type == PascalLexer::LESSTHEN || type == PascalLexer::NOTEQUAL ||
+      type == PascalLexer::NOTMORE || type == PascalLexer::NOTLESS;
+}
+
+bool is_modification(size_t type) {
+  return type == PascalLexer::ASSIGNMENT || type == PascalLexer::ADD ||
+      type == PascalLexer::REDUCE || type == PascalLexer::MULTIPLY;
+}
+
+bool is_functionname(size_t type) {
+  return type == PascalLexer::READLN || type == PascalLexer::WRITE ||
+      type == PascalLexer::WRITELN;
+}
+
+bool is_lbrack(size_t type) {
+  return type == PascalLexer::LBRACK || type == PascalLexer::LBRACK2;
+}
+
+bool is_rbrack(size_t type) {
+  return type == PascalLexer::RBRACK || type == PascalLexer::RBRACK2;
+}
+
+bool is_sign(const ast::Operation& operation) {
+  static const auto plus = ast::Interner::fixed("+");
+  static const auto minus = ast::Interner::fixed("-");
+  return operation.symbol() == plus || operation.symbol() == minus;
+}
+
+// Tokens an expression can start with, besides signs.
+bool starts_primary(size_t type) {
+  return type == PascalLexer::LPAREN || type == PascalLexer::ID ||
+      type == PascalLexer::INT || type == PascalLexer::CHARACTER ||
+      type == PascalLexer::STRINGLITERAL;
+}
+
+}  // namespace
+
+DescentParser::DescentParser(std::string_view source)
+    : source_(source), tokens_(source) {}
+
+std::optional<ast::Program> DescentParser::parse() {
+  ast::Program program;
+  program_ = &program;
+  position_ = 0;
+  chain_.clear();
+  try {
+    program.set_header(parse_header());
+    // ((constdecl? vardecl?) | (vardecl? constdecl?))
+    if (type() == PascalLexer::CONST) {
+      program.set_constdecl(parse_constdecl());
+      if (type() == PascalLexer::VAR) {
+        program.set_vardecl(parse_vardecl());
+      }
+    } else if (type() == PascalLexer::VAR) {
+      program.set_vardecl(parse_vardecl());
+      if (type() == PascalLexer::CONST) {
+        program.set_constdecl(parse_constdecl());
+      }
+    }
+    program.set_block(parse_block());
+    // Like the grammar, which has no EOF, ignores anything after the dot.
+    expect(PascalLexer::DOT);
+  } catch (const SyntaxError&) {
+    return std::nullopt;
+  }
+  return program;
+}
+
+size_t DescentParser::type(size_t offset) const {
+  // The last token is EOF.
+  return tokens_[std::min(position_ + offset, tokens_.size() - 1)].type();
+}
+
+std::string_view DescentParser::text() const {
+  return tokens_.text(tokens_[position_]);
+}
+
+std::string_view DescentParser::consume() {
+  const auto consumed = text();
+  position_ += position_ + 1 < tokens_.size() ? 1 : 0;
+  return consumed;
+}
+
+std::string_view DescentParser::expect(size_t type) {
+  if (this->type() != type) {
+    throw SyntaxError("unexpected token");
+  }
+  return consume();
+}
+
+bool DescentParser::accept(size_t type) {
+  if (this->type() != type) {
+    return false;
+  }
+  consume();
+  return true;
+}
+
+size_t DescentParser::type_after_parentheses() const {
+  size_t depth = 0;
+  for (size_t offset = 0;; ++offset) {
+    const auto type = this->type(offset);
+    if (type == antlr4::Token::EOF) {
+      return type;
+    }
+    if (type == PascalLexer::LPAREN) {
+      ++depth;
+    } else if (type == PascalLexer::RPAREN && --depth == 0) {
+      return this->type(offset + 1);
+    }
+  }
+}
+
+bool DescentParser::variables_ahead() const {
+  // variable: varname | cell. An index may hold brackets and parentheses of
+  // its own; whether it is a valid expression is checked when parsing.
+  size_t offset = 0;
+  while (true) {
+    if (type(offset++) != PascalLexer::ID) {
+      return false;
+    }
+    if (is_lbrack(type(offset))) {
+      size_t depth = 0;
+      do {
+        const auto type = this->type(offset++);
+        if (type == antlr4::Token::EOF) {
+          return false;
+        }
+        if (is_lbrack(type) || type == PascalLexer::LPAREN) {
+          ++depth;
+        } else if (is_rbrack(type) || type == PascalLexer::RPAREN) {
+          --depth;
+        }
+      } while (depth != 0);
+    }
+    const auto separator = type(offset++);
+    if (separator == PascalLexer::RPAREN) {
+      return true;
+    }
+    if (separator != PascalLexer::COMMA) {
+      return false;
+    }
+  }
+}
+
+ast::SymbolId DescentParser::intern(std::string_view text) {
+  return program_->symbols().intern(text);
+}
+
+ast::SymbolId DescentParser::intern_lowercase(std::string_view text) {
+  return program_->symbols().intern_lowercase(text);
+}
+
+ast::SymbolId DescentParser::intern_unquoted(std::string_view text) {
+  return intern(text.substr(1, text.size() - 2));
+}
+
+ast::Header* DescentParser::parse_header() {
+  expect(PascalLexer::PROGRAM);
+  auto* progname = parse_id();
+  expect(PascalLexer::SEMICOLON);
+  return program_->create_node<ast::Header>(progname);
+}
+
+ast::Constdecl* DescentParser::parse_constdecl() {
+  expect(PascalLexer::CONST);
+  ast::Constdecl::Constdeclarations constdeclarations;
+  do {
+    constdeclarations.push_back(parse_constdeclaration());
+    expect(PascalLexer::SEMICOLON);
+  } while (type() == PascalLexer::ID);
+  return program_->create_node<ast::Constdecl>(std::move(constdeclarations));
+}
+
+ast::Constdeclaration* DescentParser::parse_constdeclaration() {
+  auto* constname = parse_id();
+  expect(PascalLexer::EQUAL);
+  auto* expression = parse_expression();
+  return program_->create_node<ast::Constdeclaration>(constname, expression);
+}
+
+ast::Vardecl* DescentParser::parse_vardecl() {
+  expect(PascalLexer::VAR);
+  ast::Vardecl::Declarations declarations;
+  while (type() == PascalLexer::ID) {
+    declarations.push_back(parse_declaration());
+  }
+  return program_->create_node<ast::Vardecl>(std::move(declarations));
+}
+
+ast::Declaration* DescentParser::parse_declaration() {
+  ast::Declaration::Varnames varnames;
+  varnames.push_back(parse_id());
+  while (accept(PascalLexer::COMMA)) {
+    varnames.push_back(parse_id());
+  }
+  expect(PascalLexer::COLON);
+  auto* vartype = parse_vartype();
+  expect(PascalLexer::SEMICOLON);
+  return program_->create_node<ast::Declaration>(std::move(varnames), vartype);
+}
+
+ast::Vartype* DescentParser::parse_vartype() {
+  if (type() == PascalLexer::ARRAY) {
+    return parse_arraytype();
+  }
+  return parse_simpletype();
+}
+
+ast::Simpletype* DescentParser::parse_simpletype() {
+  if (type() != PascalLexer::INTEGER && type() != PascalLexer::CHAR &&
+      type() != PascalLexer::STRING) {
+    throw SyntaxError("expected a simple type");
+  }
+  return program_->create_node<ast::Simpletype>(intern_lowercase(consume()));
+}
+
+ast::Arraytype* DescentParser::parse_arraytype() {
+  expect(PascalLexer::ARRAY);
+  if (!is_lbrack(type())) {
+    throw SyntaxError("expected '['");
+  }
+  consume();
+  auto* lborder = parse_int();
+  expect(PascalLexer::DOTDOT);
+  auto* rborder = parse_int();
+  if (!is_rbrack(type())) {
+    throw SyntaxError("expected ']'");
+  }
+  consume();
+  expect(PascalLexer::OF);
+  auto* interval = program_->create_node<ast::Interval>(lborder, rborder);
+  auto* simpletype = parse_simpletype();
+  return program_->create_node<ast::Arraytype>(interval, simpletype);
+}
+
+ast::Int* DescentParser::parse_int() {
+  return program_->create_node<ast::Int>(intern(expect(PascalLexer::INT)));
+}
+
+ast::Block* DescentParser::parse_block() {
+  // BEGIN END | BEGIN statement (SEMICOLON (statement SEMICOLON)*)? END
+  expect(PascalLexer::BEGIN);
+  ast::Block::Components components;
+  if (type() != PascalLexer::END) {
+    components.push_back(parse_statement());
+    if (accept(PascalLexer::SEMICOLON)) {
+      while (type() != PascalLexer::END) {
+        components.push_back(parse_statement());
+        expect(PascalLexer::SEMICOLON);
+      }
+    }
+  }
+  expect(PascalLexer::END);
+  return program_->create_node<ast::Block>(std::move(components));
+}
+
+ast::Statement* DescentParser::parse_statement() {
+  switch (type()) {
+    case PascalLexer::BEGIN:
+      return parse_block();
+    case PascalLexer::READLN:
+    case PascalLexer::WRITE:
+    case PascalLexer::WRITELN:
+      return parse_functioncall();
+    case PascalLexer::ID:
+      return parse_assignment();
+    case PascalLexer::WHILE:
+      return parse_while();
+    case PascalLexer::IF:
+      return parse_branch();
+    default:
+      throw SyntaxError("expected a statement");
+  }
+}
+
+ast::Functioncall* DescentParser::parse_functioncall() {
+  if (!is_functionname(type())) {
+    throw SyntaxError("expected a function name");
+  }
+  auto* functionname =
+      program_->create_node<ast::Functionname>(intern_lowercase(consume()));
+  expect(PascalLexer::LPAREN);
+
+  // An argument list that is also a variable list is one, as ANTLR resolves
+  // the ambiguity to the first alternative.
+  ast::Functioncall::Variables variables;
+  ast::Functioncall::Arguments arguments;
+  if (variables_ahead()) {
+    do {
+      if (is_lbrack(type(1))) {
+        variables.push_back(parse_cell());
+      } else {
+        variables.push_back(parse_id());
+      }
+    } while (accept(PascalLexer::COMMA));
+  } else {
+    do {
+      arguments.push_back(parse_expression());
+    } while (accept(PascalLexer::COMMA));
+  }
+  expect(PascalLexer::RPAREN);
+  return program_->create_node<ast::Functioncall>(
+      functionname, std::move(variables), std::move(arguments));
+}
+
+ast::Assignment* DescentParser::parse_assignment() {
+  ast::Cell* cell = nullptr;
+  ast::Id* varname = nullptr;
+  if (is_lbrack(type(1))) {
+    cell = parse_cell();
+  } else {
+    varname = parse_id();
+  }
+  if (!is_modification(type())) {
+    throw SyntaxError("expected an assignment");
+  }
+  auto* modification =
+      program_->create_node<ast::Modification>(intern(consume()));
+  auto* expression = parse_expression();
+  return program_->create_node<ast::Assignment>(
+      cell, varname, modification, expression);
+}
+
+ast::While* DescentParser::parse_while() {
+  expect(PascalLexer::WHILE);
+  auto* boolexpr = parse_boolexpr(PascalLexer::DO);
+  expect(PascalLexer::DO);
+  auto* statement = parse_statement();
+  return program_->create_node<ast::While>(boolexpr, statement);
+}
+
+ast::Branch* DescentParser::parse_branch() {
+  expect(PascalLexer::IF);
+  auto* boolexpr = parse_boolexpr(PascalLexer::THEN);
+  expect(PascalLexer::THEN);
+  auto* statement = parse_statement();
+  // A dangling else belongs to the nearest if, as ANTLR matches greedily.
+  ast::Statement* alternative = nullptr;
+  if (accept(PascalLexer::ELSE)) {
+    alternative = parse_statement();
+  }
+  return program_->create_node<ast::Branch>(boolexpr, statement, alternative);
+}
+
+ast::Boolexpr* DescentParser::parse_boolexpr(size_t follow) {
+  // LPAREN operand1 booloperation operand2 RPAREN | operand1 booloperation
+  // operand2. Only the first alternative can end right before `follow` when
+  // the condition starts with a parenthesis: in the second one the
+  // parenthesized expression is just the first operand.
+  if (type() == PascalLexer::LPAREN && type_after_parentheses() == follow) {
+    consume();
+    auto* boolexpr = parse_condition();
+    expect(PascalLexer::RPAREN);
+    return boolexpr;
+  }
+  return parse_condition();
+}
+
+ast::Boolexpr* DescentParser::parse_condition() {
+  const auto begin = chain_.size();
+  parse_chain();
+  const auto end = chain_.size();
+
+  ast::Booloperation* booloperation = nullptr;
+  ast::Expression* operand1 = nullptr;
+  ast::Expression* operand2 = nullptr;
+  if (is_booloperation(type())) {
+    booloperation = program_->create_node<ast::Booloperation>(
+        intern_lowercase(consume()));
+    operand1 = build_expression(begin, end);
+    operand2 = parse_expression();
+  } else if (starts_primary(type())) {
+    // The booloperation may be empty: `a b`.
+    booloperation = program_->create_node<ast::Booloperation>(intern(""));
+    operand1 = build_expression(begin, end);
+    operand2 = parse_expression();
+  } else {
+    // The booloperation is empty and the second operand starts with a sign
+    // that was read as an operation: `a - b` is `a` and `-b`. Full-LL
+    // prediction keeps extending the first operand while the rest still
+    // parses, so the split is at the last '+' or '-' before a signed atom.
+    auto split = end;
+    for (auto i = end - 1; i > begin; --i) {
+      if (is_sign(*chain_[i].operation_) &&
+          chain_[i].atom_ != nullptr) {
+        split = i;
+        break;
+      }
+    }
+    if (split == end) {
+      throw SyntaxError("expected a comparison");
+    }
+    booloperation = program_->create_node<ast::Booloperation>(intern(""));
+    operand1 = build_expression(begin, split);
+    auto& primary = chain_[split];
+    signs_.assign(1, primary.operation_);
+    signs_.insert(signs_.end(), primary.signs_.begin(), primary.signs_.end());
+    primary.signs_ = program_->copy_nodes(signs_.data(), signs_.size());
+    primary.operation_ = nullptr;
+    operand2 = build_expression(split, end);
+  }
+  chain_.resize(begin);
+  return program_->create_node<ast::Boolexpr>(
+      operand1, booloperation, operand2);
+}
+
+ast::Expression* DescentParser::parse_expression() {
+  const auto begin = chain_.size();
+  parse_chain();
+  auto* expression = build_expression(begin, chain_.size());
+  chain_.resize(begin);
+  return expression;
+}
+
+void DescentParser::parse_chain() {
+  // expression operation expression, left-recursive with a single
+  // precedence level, is `primary (operation primary)*`. build_expression
+  // groups it by precedence.
+  chain_.push_back(parse_primary());
+  while (is_operation(type())) {
+    auto* operation =
+        program_->create_node<ast::Operation>(intern_lowercase(consume()));
+    auto primary = parse_primary();
+    primary.operation_ = operation;
+    chain_.push_back(primary);
+  }
+}
+
+DescentParser::Primary DescentParser::parse_primary() {
+  // LPAREN expression RPAREN | sign* atom
+  Primary primary{nullptr, {}, nullptr, nullptr};
+  if (accept(PascalLexer::LPAREN)) {
+    primary.brackets_ = parse_expression();
+    expect(PascalLexer::RPAREN);
+    return primary;
+  }
+  signs_.clear();
+  while (type() == PascalLexer::PLUS || type() == PascalLexer::MINUS) {
+    signs_.push_back(
+        program_->create_node<ast::Operation>(intern(consume())));
+  }
+  primary.signs_ = program_->copy_nodes(signs_.data(), signs_.size());
+  primary.atom_ = parse_value();
+  return primary;
+}
+
+ast::Expression* DescentParser::build_expression(size_t begin, size_t end) {
+  operands_.clear();
+  operations_.clear();
+  for (auto i = begin; i != end; ++i) {
+    auto& primary = chain_[i];
+    operands_.push_back(
+        primary.atom_ != nullptr
+            ? program_->create_node<ast::Expression>(
+                  nullptr,
+                  nullptr,
+                  nullptr,
+                  primary.signs_,
+                  primary.atom_,
+                  false)
+            : program_->create_node<ast::Expression>(
+                  primary.brackets_,
+                  nullptr,
+                  nullptr,
+                  ast::Expression::Signs{},
+                  nullptr,
+                  true));
+    if (i != begin) {
+      operations_.push_back(primary.operation_);
+    }
+  }
+  return ast::group_operations(
+      *program_, operands_.data(), operations_.data(), operations_.size());
+}
+
+ast::Value* DescentParser::parse_value() {
+  switch (type()) {
+    case PascalLexer::ID:
+      if (is_lbrack(type(1))) {
+        return parse_cell();
+      }
+      return parse_id();
+    case PascalLexer::INT:
+      return parse_int();
+    case PascalLexer::CHARACTER:
+      return program_->create_node<ast::Char>(intern_unquoted(consume()));
+    case PascalLexer::STRINGLITERAL:
+      return program_->create_node<ast::Stringliteral>(
+          intern_unquoted(consume()));
+    default:
+      throw SyntaxError("expected a value");
+  }
+}
+
+ast::Id* DescentParser::parse_id() {
+  return program_->create_node<ast::Id>(
+      intern_lowercase(expect(PascalLexer::ID)));
+}
+
+ast::Cell* DescentParser::parse_cell() {
+  auto* varname = parse_id();
+  if (!is_lbrack(type())) {
+    throw SyntaxError("expected '['");
+  }
+  consume();
+  auto* index = parse_expression();
+  if (!is_rbrack(type())) {
+    throw SyntaxError("expected ']'");
+  }
+  consume();
+  return program_->create_node<ast::Cell>(varname, index);
+}
+
+}  // namespace pascal
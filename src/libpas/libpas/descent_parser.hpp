@@ -0,0 +1,101 @@
+#pragma once
+
+#include <libpas/ast/Ast.hpp>
+#include <libpas/token_arena.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace pascal {
+
+// Hand-written recursive-descent parser for Pascal.g4. It builds the same
+// ast::Program as PascalParser followed by ast::detail::Builder, but straight
+// from DfaLexer tokens, without a parse tree. Where the grammar is ambiguous
+// it picks what ANTLR's full-LL prediction picks.
+//
+// It only recognises programs: at the first syntax error it gives up, and
+// parse(DescentParser&) lets the ANTLR parser report the errors, so they
+// are worded exactly as before.
+class DescentParser {
+ public:
+  // Lexes the whole source up front.
+  explicit DescentParser(std::string_view source);
+
+  // The program, or nullopt if the source has a syntax error.
+  std::optional<ast::Program> parse();
+
+  std::string_view source() const { return source_; }
+
+ private:
+  // An operand of `primary (operation primary)*` before it is made into an
+  // Expression, so that a condition can still move the point where its
+  // first operand ends (see parse_condition).
+  struct Primary {
+    // The operation before this operand, null for the first one.
+    ast::Operation* operation_;
+    ast::Expression::Signs signs_;
+    // Either a signed atom or an expression in parentheses.
+    ast::Value* atom_;
+    ast::Expression* brackets_;
+  };
+
+  size_t type(size_t offset = 0) const;
+  std::string_view text() const;
+  std::string_view consume();
+  std::string_view expect(size_t type);
+  bool accept(size_t type);
+  // The type of the token after the parenthesis that closes the one at the
+  // current position.
+  size_t type_after_parentheses() const;
+  // Whether a call's arguments are all variables, which ANTLR prefers.
+  bool variables_ahead() const;
+
+  // Intern into the program's symbols. Identifiers and keywords are
+  // case-insensitive; literals are interned without their quotes.
+  ast::SymbolId intern(std::string_view text);
+  ast::SymbolId intern_lowercase(std::string_view text);
+  ast::SymbolId intern_unquoted(std::string_view text);
+
+  ast::Header* parse_header();
+  ast::Constdecl* parse_constdecl();
+  ast::Constdeclaration* parse_constdeclaration();
+  ast::Vardecl* parse_vardecl();
+  ast::Declaration* parse_declaration();
+  ast::Vartype* parse_vartype();
+  ast::Simpletype* parse_simpletype();
+  ast::Arraytype* parse_arraytype();
+  ast::Int* parse_int();
+
+  ast::Block* parse_block();
+  ast::Statement* parse_statement();
+  ast::Functioncall* parse_functioncall();
+  ast::Assignment* parse_assignment();
+  ast::While* parse_while();
+  ast::Branch* parse_branch();
+  ast::Boolexpr* parse_boolexpr(size_t follow);
+  ast::Boolexpr* parse_condition();
+
+  ast::Expression* parse_expression();
+  void parse_chain();
+  Primary parse_primary();
+  ast::Expression* build_expression(size_t begin, size_t end);
+  ast::Value* parse_value();
+  ast::Id* parse_id();
+  ast::Cell* parse_cell();
+
+  std::string_view source_;
+  TokenArena tokens_;
+  size_t position_ = 0;
+  ast::Program* program_ = nullptr;
+  // Operands of the chains being parsed, innermost last.
+  std::vector<Primary> chain_;
+  // Scratch space of build_expression.
+  std::vector<ast::Expression*> operands_;
+  std::vector<ast::Operation*> operations_;
+  // An atom's signs before they are copied into the program's arena.
+  std::vector<ast::Operation*> signs_;
+};
+
+}  // namespace pascal
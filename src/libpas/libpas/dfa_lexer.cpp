@@ -0,0 +1,501 @@
+#include <libpas/dfa_lexer.hpp>
+
+#include <PascalLexer.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+namespace pascal {
+
+namespace {
+
+// Bytes that no rule tells apart share a class.
+enum Class : uint8_t {
+  Other,
+  Letter,
+  Zero,
+  Digit,
+  Underscore,
+  Space,
+  Quote,
+  LParen,
+  RParen,
+  Star,
+  LCurly,
+  RCurly,
+  Dot,
+  Colon,
+  Equal,
+  Plus,
+  Minus,
+  Less,
+  More,
+  Comma,
+  Semicolon,
+  LBrack,
+  RBrack,
+  ClassCount
+};
+
+enum State : uint8_t {
+  Dead,
+  Start,
+  Id,
+  IntZero,
+  Int,
+  Whitespace,
+  Invalid,
+  // Quoted literals: Opened has seen the opening quote, Empty is '', Item
+  // is inside after one character (or '' pair), Character is a closed
+  // one-character literal, Items is inside after more and String is a
+  // closed longer literal.
+  Opened,
+  Empty,
+  Item,
+  Character,
+  Items,
+  String,
+  // (* ... *)
+  LParenState,
+  Comment1,
+  Comment1Star,
+  Comment1End,
+  // { ... }
+  LCurlyState,
+  Comment2,
+  Comment2End,
+  LBrack2,
+  RParenState,
+  StarState,
+  Multiply,
+  RCurlyState,
+  DotState,
+  DotDot,
+  RBrack2,
+  ColonState,
+  Assignment,
+  EqualState,
+  PlusState,
+  Add,
+  MinusState,
+  Reduce,
+  LessState,
+  NotEqual,
+  NotMore,
+  MoreState,
+  NotLess,
+  CommaState,
+  SemicolonState,
+  LBrackState,
+  RBrackState,
+  StateCount
+};
+
+// Accepting states map to a token type; whitespace and comments map to
+// `skip`.
+constexpr uint8_t none = 0;
+constexpr uint8_t skip = 0xff;
+
+struct Tables {
+  std::array<Class, 256> classes_{};
+  std::array<std::array<State, ClassCount>, StateCount> next_{};
+  std::array<uint8_t, StateCount> accept_{};
+};
+
+constexpr Tables make_tables() {
+  Tables tables{};
+  for (int byte = 'a'; byte <= 'z'; ++byte) {
+    tables.classes_[byte] = Letter;
+    tables.classes_[byte - 'a' + 'A'] = Letter;
+  }
+  tables.classes_['0'] = Zero;
+  for (int byte = '1'; byte <= '9'; ++byte) {
+    tables.classes_[byte] = Digit;
+  }
+  tables.classes_['_'] = Underscore;
+  tables.classes_[' '] = Space;
+  tables.classes_['\t'] = Space;
+  tables.classes_['\r'] = Space;
+  tables.classes_['\n'] = Space;
+  tables.classes_['\''] = Quote;
+  tables.classes_['('] = LParen;
+  tables.classes_[')'] = RParen;
+  tables.classes_['*'] = Star;
+  tables.classes_['{'] = LCurly;
+  tables.classes_['}'] = RCurly;
+  tables.classes_['.'] = Dot;
+  tables.classes_[':'] = Colon;
+  tables.classes_['='] = Equal;
+  tables.classes_['+'] = Plus;
+  tables.classes_['-'] = Minus;
+  tables.classes_['<'] = Less;
+  tables.classes_['>'] = More;
+  tables.classes_[','] = Comma;
+  tables.classes_[';'] = Semicolon;
+  tables.classes_['['] = LBrack;
+  tables.classes_[']'] = RBrack;
+
+  auto& next = tables.next_;
+  const auto all = [&next](State from, State to) {
+    for (auto& state : next[from]) {
+      state = to;
+    }
+  };
+
+  // Any byte no other rule starts with is INVALID.
+  all(Start, Invalid);
+  next[Start][Letter] = Id;
+  next[Start][Zero] = IntZero;
+  next[Start][Digit] = Int;
+  next[Start][Space] = Whitespace;
+  next[Start][Quote] = Opened;
+  next[Start][LParen] = LParenState;
+  next[Start][RParen] = RParenState;
+  next[Start][Star] = StarState;
+  next[Start][LCurly] = LCurlyState;
+  next[Start][RCurly] = RCurlyState;
+  next[Start][Dot] = DotState;
+  next[Start][Colon] = ColonState;
+  next[Start][Equal] = EqualState;
+  next[Start][Plus] = PlusState;
+  next[Start][Minus] = MinusState;
+  next[Start][Less] = LessState;
+  next[Start][More] = MoreState;
+  next[Start][Comma] = CommaState;
+  next[Start][Semicolon] = SemicolonState;
+  next[Start][LBrack] = LBrackState;
+  next[Start][RBrack] = RBrackState;
+
+  next[Id][Letter] = Id;
+  next[Id][Zero] = Id;
+  next[Id][Digit] = Id;
+  next[Id][Underscore] = Id;
+  next[Int][Zero] = Int;
+  next[Int][Digit] = Int;
+  next[Whitespace][Space] = Whitespace;
+
+  all(Opened, Item);
+  next[Opened][Quote] = Empty;
+  next[Empty][Quote] = Item;
+  all(Item, Items);
+  next[Item][Quote] = Character;
+  next[Character][Quote] = Items;
+  all(Items, Items);
+  next[Items][Quote] = String;
+  next[String][Quote] = Items;
+
+  next[LParenState][Dot] = LBrack2;
+  next[LParenState][Star] = Comment1;
+  all(Comment1, Comment1);
+  next[Comment1][Star] = Comment1Star;
+  all(Comment1Star, Comment1);
+  next[Comment1Star][Star] = Comment1Star;
+  next[Comment1Star][RParen] = Comment1End;
+
+  all(LCurlyState, Comment2);
+  next[LCurlyState][RCurly] = Comment2End;
+  all(Comment2, Comment2);
+  next[Comment2][RCurly] = Comment2End;
+
+  next[StarState][Equal] = Multiply;
+  next[DotState][Dot] = DotDot;
+  next[DotState][RParen] = RBrack2;
+  next[ColonState][Equal] = Assignment;
+  next[PlusState][Equal] = Add;
+  next[MinusState][Equal] = Reduce;
+  next[LessState][More] = NotEqual;
+  next[LessState][Equal] = NotMore;
+  next[MoreState][Equal] = NotLess;
+
+  auto& accept = tables.accept_;
+  accept[Id] = PascalLexer::ID;
+  accept[IntZero] = PascalLexer::INT;
+  accept[Int] = PascalLexer::INT;
+  accept[Whitespace] = skip;
+  accept[Invalid] = PascalLexer::INVALID;
+  // A lone quote is INVALID, '' an empty STRINGLITERAL.
+  accept[Opened] = PascalLexer::INVALID;
+  accept[Empty] = PascalLexer::STRINGLITERAL;
+  accept[Character] = PascalLexer::CHARACTER;
+  accept[String] = PascalLexer::STRINGLITERAL;
+  // An unterminated comment falls back to the bracket that opened it.
+  accept[LParenState] = PascalLexer::LPAREN;
+  accept[Comment1End] = skip;
+  accept[LCurlyState] = PascalLexer::LCURLY;
+  accept[Comment2End] = skip;
+  accept[LBrack2] = PascalLexer::LBRACK2;
+  accept[RParenState] = PascalLexer::RPAREN;
+  accept[StarState] = PascalLexer::STAR;
+  accept[Multiply] = PascalLexer::MULTIPLY;
+  accept[RCurlyState] = PascalLexer::RCURLY;
+  accept[DotState] = PascalLexer::DOT;
+  accept[DotDot] = PascalLexer::DOTDOT;
+  accept[RBrack2] = PascalLexer::RBRACK2;
+  accept[ColonState] = PascalLexer::COLON;
+  accept[Assignment] = PascalLexer::ASSIGNMENT;
+  accept[EqualState] = PascalLexer::EQUAL;
+  accept[PlusState] = PascalLexer::PLUS;
+  accept[Add] = PascalLexer::ADD;
+  accept[MinusState] = PascalLexer::MINUS;
+  accept[Reduce] = PascalLexer::REDUCE;
+  accept[LessState] = PascalLexer::LESSTHEN;
+  accept[NotEqual] = PascalLexer::NOTEQUAL;
+  accept[NotMore] = PascalLexer::NOTMORE;
+  accept[MoreState] = PascalLexer::MORETHEN;
+  accept[NotLess] = PascalLexer::NOTLESS;
+  accept[CommaState] = PascalLexer::COMMA;
+  accept[SemicolonState] = PascalLexer::SEMICOLON;
+  accept[LBrackState] = PascalLexer::LBRACK;
+  accept[RBrackState] = PascalLexer::RBRACK;
+  return tables;
+}
+
+constexpr Tables tables = make_tables();
+
+// Spans shorter than a vector, i.e. most tokens, are not worth a call into
+// the scanner.
+constexpr size_t short_span = 16;
+
+struct Keyword {
+  std::string_view text_;
+  size_t type_;
+};
+
+constexpr size_t max_keyword_length = 8;
+
+constexpr std::array<Keyword, 26> keywords{{
+    {"program", PascalLexer::PROGRAM},
+    {"begin", PascalLexer::BEGIN},
+    {"end", PascalLexer::END},
+    {"var", PascalLexer::VAR},
+    {"const", PascalLexer::CONST},
+    {"integer", PascalLexer::INTEGER},
+    {"char", PascalLexer::CHAR},
+    {"string", PascalLexer::STRING},
+    {"of", PascalLexer::OF},
+    {"readln", PascalLexer::READLN},
+    {"write", PascalLexer::WRITE},
+    {"writeln", PascalLexer::WRITELN},
+    {"div", PascalLexer::DIV},
+    {"mod", PascalLexer::MOD},
+    {"if", PascalLexer::IF},
+    {"then", PascalLexer::THEN},
+    {"else", PascalLexer::ELSE},
+    {"not", PascalLexer::NOT},
+    {"and", PascalLexer::AND},
+    {"or", PascalLexer::OR},
+    {"xor", PascalLexer::XOR},
+    {"while", PascalLexer::WHILE},
+    {"do", PascalLexer::DO},
+    {"break", PascalLexer::BREAK},
+    {"continue", PascalLexer::CONTINUE},
+    {"array", PascalLexer::ARRAY},
+}};
+
+// Keywords by first letter, so that an ID is compared with at most three.
+struct KeywordIndex {
+  std::array<std::array<uint8_t, 4>, 26> buckets_{};
+  std::array<uint8_t, 26> sizes_{};
+};
+
+constexpr KeywordIndex make_keyword_index() {
+  KeywordIndex index{};
+  for (size_t i = 0; i < keywords.size(); ++i) {
+    const auto letter = static_cast<size_t>(keywords[i].text_[0] - 'a');
+    index.buckets_[letter][index.sizes_[letter]++] = static_cast<uint8_t>(i);
+  }
+  return index;
+}
+
+constexpr KeywordIndex keyword_index = make_keyword_index();
+
+// Keywords are case-insensitive, like the whole grammar. Setting bit 5
+// lower-cases a letter and cannot turn a digit or '_' into one.
+size_t identifier_type(std::string_view text) {
+  if (text.size() > max_keyword_length) {
+    return PascalLexer::ID;
+  }
+  const auto letter = static_cast<size_t>((text[0] | 0x20) - 'a');
+  for (size_t i = 0; i < keyword_index.sizes_[letter]; ++i) {
+    const auto& keyword = keywords[keyword_index.buckets_[letter][i]];
+    if (keyword.text_.size() != text.size()) {
+      continue;
+    }
+    size_t matched = 1;
+    while (matched < text.size() &&
+           (text[matched] | 0x20) == keyword.text_[matched]) {
+      ++matched;
+    }
+    if (matched == text.size()) {
+      return keyword.type_;
+    }
+  }
+  return PascalLexer::ID;
+}
+
+Token make_token(
+    size_t kind,
+    size_t start,
+    size_t length,
+    size_t line,
+    size_t column) {
+  return Token{
+      static_cast<uint32_t>(start),
+      static_cast<uint32_t>(length),
+      static_cast<uint32_t>(line),
+      static_cast<uint32_t>(std::min<size_t>(column, Token::max_column)),
+      static_cast<uint32_t>(kind)};
+}
+
+}  // namespace
+
+DfaLexer::DfaLexer(std::string_view text, scan::Isa isa)
+    : text_(text), scanner_(&scan::scanner(isa)) {
+  if (text.size() >= std::numeric_limits<uint32_t>::max()) {
+    throw std::length_error("DfaLexer: source of 4 GiB or more");
+  }
+}
+
+Token DfaLexer::next() {
+  const auto size = text_.size();
+  while (position_ < size) {
+    if (skip_trivia()) {
+      continue;
+    }
+
+    // Longest match: run until the dead state and keep the last accepting
+    // one. Every byte on its own is at least INVALID, so one always exists.
+    auto state = Start;
+    auto type = none;
+    auto end = position_;
+    for (auto i = position_; i < size; ++i) {
+      const auto byte = static_cast<unsigned char>(text_[i]);
+      state = tables.next_[state][tables.classes_[byte]];
+      if (state == Dead) {
+        break;
+      }
+      if (tables.accept_[state] != none) {
+        type = tables.accept_[state];
+        end = i + 1;
+      }
+    }
+
+    auto token = make_token(type, position_, end - position_, line_, column_);
+    advance(end);
+    if (type == skip) {
+      continue;
+    }
+    if (type == PascalLexer::ID) {
+      token.kind_ = static_cast<uint32_t>(identifier_type(text(token)));
+    }
+    return token;
+  }
+  return make_token(Token::eof_kind, position_, 0, line_, column_);
+}
+
+bool DfaLexer::skip_trivia() {
+  const auto* const begin = text_.data() + position_;
+  const auto* const end = text_.data() + text_.size();
+  const char* stop = nullptr;
+  switch (*begin) {
+    case ' ':
+    case '\t':
+    case '\r':
+    case '\n':
+      // Most runs are the single space between two tokens.
+      stop = begin + 1 != end && tables.classes_[static_cast<unsigned char>(
+                                     begin[1])] == Space
+          ? scanner_->skip_whitespace_(begin + 1, end)
+          : begin + 1;
+      break;
+    case '{': {
+      const auto* const close = scanner_->find_(begin + 1, end, '}');
+      if (close == end) {
+        return false;
+      }
+      stop = close + 1;
+      break;
+    }
+    case '(': {
+      if (end - begin < 2 || begin[1] != '*') {
+        return false;
+      }
+      const auto* const close = scanner_->find_comment_end_(begin + 2, end);
+      if (close == end) {
+        return false;
+      }
+      stop = close + 2;
+      break;
+    }
+    default:
+      return false;
+  }
+  advance(static_cast<size_t>(stop - text_.data()));
+  return true;
+}
+
+void DfaLexer::advance(size_t end) {
+  // Only whitespace, comments and string literals span lines.
+  const auto* const start = text_.data() + position_;
+  const auto* const stop = text_.data() + end;
+  scan::Lines lines;
+  if (end - position_ < short_span) {
+    for (const auto* byte = start; byte != stop; ++byte) {
+      if (*byte == '\n') {
+        ++lines.count_;
+        lines.last_ = byte;
+      }
+    }
+  } else {
+    lines = scanner_->count_lines_(start, stop);
+  }
+  if (lines.last_ != nullptr) {
+    line_ += lines.count_;
+    column_ = static_cast<size_t>(stop - lines.last_ - 1);
+  } else {
+    column_ += end - position_;
+  }
+  position_ = end;
+}
+
+DfaTokenSource::DfaTokenSource(ByteStream& input)
+    : input_(input), lexer_(input.text()) {}
+
+std::unique_ptr<antlr4::Token> DfaTokenSource::nextToken() {
+  const auto token = lexer_.next();
+  // Same fields as PascalLexer's tokens; EOF spans [start, start - 1].
+  return getTokenFactory()->create(
+      {this, &input_},
+      token.type(),
+      {},
+      antlr4::Token::DEFAULT_CHANNEL,
+      token.start_,
+      size_t{token.start_} + token.length_ - 1,
+      token.line_,
+      token.column_);
+}
+
+size_t DfaTokenSource::getLine() const {
+  return lexer_.line();
+}
+
+size_t DfaTokenSource::getCharPositionInLine() {
+  return lexer_.column();
+}
+
+antlr4::CharStream* DfaTokenSource::getInputStream() {
+  return &input_;
+}
+
+std::string DfaTokenSource::getSourceName() {
+  return input_.getSourceName();
+}
+
+antlr4::TokenFactory<antlr4::CommonToken>* DfaTokenSource::getTokenFactory() {
+  return antlr4::CommonTokenFactory::DEFAULT.get();
+}
+
+}  // namespace pascal
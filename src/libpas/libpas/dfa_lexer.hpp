@@ -0,0 +1,94 @@
+#pragma once
+
+#include <libpas/input_stream.hpp>
+#include <libpas/scan.hpp>
+
+#include <antlr4-runtime.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace pascal {
+
+// A token of DfaLexer, packed into 16 bytes so that whole token streams
+// stay small (see TokenArena). The type is a PascalLexer token type (or
+// antlr4::Token::EOF), the text is the `length_` bytes at `start_`.
+// Offsets are 32-bit, so DfaLexer takes sources under 4 GiB; columns past
+// 2^24 - 1 are clamped.
+struct Token {
+  static constexpr uint32_t eof_kind = 0xff;
+  static constexpr uint32_t max_column = (1u << 24) - 1;
+
+  size_t type() const {
+    return kind_ == eof_kind ? antlr4::Token::EOF : kind_;
+  }
+
+  uint32_t start_;
+  uint32_t length_;
+  uint32_t line_;
+  uint32_t column_ : 24;
+  uint32_t kind_ : 8;
+};
+
+static_assert(sizeof(Token) == 16);
+
+// Hand-written lexer for Pascal.g4 driven by a byte class table and a state
+// transition table. It produces the same token types, lines and columns as
+// PascalLexer over a ByteStream of the same text, but needs neither the ATN
+// simulator nor a heap token per token. Keywords are recognised as IDs and
+// then looked up, which is what the grammar's rule order amounts to.
+// Whitespace runs and comment bodies bypass the DFA: they are skipped with
+// the vector scanners of `isa`.
+class DfaLexer {
+ public:
+  // Throws std::length_error if `text` is 4 GiB or larger.
+  explicit DfaLexer(
+      std::string_view text,
+      scan::Isa isa = scan::best_isa());
+
+  // Skips whitespace and comments. At the end of the input returns an EOF
+  // token every time.
+  Token next();
+
+  std::string_view text(const Token& token) const {
+    return text_.substr(token.start_, token.length_);
+  }
+
+  size_t line() const { return line_; }
+  size_t column() const { return column_; }
+
+ private:
+  // Skips whitespace or a terminated comment at the current position.
+  // Anything else, including an unterminated comment, is left to the DFA.
+  bool skip_trivia();
+  void advance(size_t end);
+
+  std::string_view text_;
+  const scan::Scanner* scanner_;
+  size_t position_ = 0;
+  size_t line_ = 1;
+  size_t column_ = 0;
+};
+
+// Feeds DfaLexer tokens to PascalParser in place of PascalLexer. The tokens
+// refer to `input` for their text, as PascalLexer's do.
+class DfaTokenSource final : public antlr4::TokenSource {
+ public:
+  explicit DfaTokenSource(ByteStream& input);
+
+  std::unique_ptr<antlr4::Token> nextToken() override;
+  size_t getLine() const override;
+  size_t getCharPositionInLine() override;
+  antlr4::CharStream* getInputStream() override;
+  std::string getSourceName() override;
+  antlr4::TokenFactory<antlr4::CommonToken>* getTokenFactory() override;
+
+ private:
+  ByteStream& input_;
+  DfaLexer lexer_;
+};
+
+}  // namespace pascal
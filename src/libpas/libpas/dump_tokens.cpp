@@ -1,26 +1,117 @@
 #include <libpas/dump_tokens.hpp>
+#include <libpas/input_stream.hpp>
 
 #include <PascalLexer.h>
 #include <antlr4-runtime.h>
+#include <fmt/compile.h>
 #include <fmt/format.h>
 
+#include <iterator>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
 namespace pascal {
 
-static std::string_view get_token_type_name(
-    const PascalLexer& lexer,
-    const antlr4::Token& token) {
-  return lexer.getVocabulary().getSymbolicName(token.getType());
+namespace {
+
+// Symbolic names of the token types, indexed by type.
+const std::vector<std::string>& token_names() {
+  static const std::vector<std::string> names = [] {
+    // The vocabulary is static data of the generated lexer, but it is only
+    // reachable through an instance.
+    ByteStream empty_input(std::string_view{});
+    const PascalLexer lexer(&empty_input);
+    const auto& vocabulary = lexer.getVocabulary();
+    std::vector<std::string> names(vocabulary.getMaxTokenType() + 1);
+    for (size_t type = 0; type != names.size(); ++type) {
+      names[type] = vocabulary.getSymbolicName(type);
+    }
+    return names;
+  }();
+  return names;
 }
 
+std::string_view token_name(size_t type) {
+  const auto& names = token_names();
+  return type < names.size() ? std::string_view(names[type])
+                             : std::string_view{};
+}
+
+// Formats token lines into one buffer and writes it out in large chunks.
+class TokenWriter {
+ public:
+  explicit TokenWriter(std::ostream& out) : out_(out) {}
+  TokenWriter(const TokenWriter&) = delete;
+  TokenWriter& operator=(const TokenWriter&) = delete;
+  ~TokenWriter() { flush(); }
+
+  void write(
+      size_t line,
+      size_t column,
+      size_t type,
+      std::string_view lexeme) {
+    fmt::format_to(
+        std::back_inserter(buffer_),
+        FMT_COMPILE("Loc=<{}:{}>\t{} '{}'\n"),
+        line,
+        column,
+        token_name(type),
+        lexeme);
+    if (buffer_.size() >= chunk_size) {
+      flush();
+    }
+  }
+
+ private:
+  static constexpr size_t chunk_size = 64 * 1024;
+
+  void flush() {
+    out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    buffer_.clear();
+  }
+
+  std::ostream& out_;
+  fmt::memory_buffer buffer_;
+};
+
+}  // namespace
+
 void dump_tokens(PascalLexer& lexer, std::ostream& out) {
+  // Over a ByteStream the lexemes are slices of its text. Other streams
+  // only hand out copies.
+  const auto* bytes = dynamic_cast<ByteStream*>(lexer.getInputStream());
+  TokenWriter writer(out);
+  std::string copy;
   for (auto token = lexer.nextToken(); token->getType() != antlr4::Token::EOF;
        token = lexer.nextToken()) {
-    out << fmt::format(
-        "Loc=<{row}:{col}>\t{token_class} '{lexeme}'\n",
-        fmt::arg("row", token->getLine()),
-        fmt::arg("col", token->getCharPositionInLine()),
-        fmt::arg("token_class", get_token_type_name(lexer, *token)),
-        fmt::arg("lexeme", token->getText()));
+    std::string_view lexeme;
+    if (bytes != nullptr) {
+      const auto start = token->getStartIndex();
+      lexeme = bytes->text().substr(start, token->getStopIndex() + 1 - start);
+    } else {
+      copy = token->getText();
+      lexeme = copy;
+    }
+    writer.write(
+        token->getLine(),
+        token->getCharPositionInLine(),
+        token->getType(),
+        lexeme);
+  }
+}
+
+void dump_tokens(antlr4::CharStream& input, std::ostream& out) {
+  PascalLexer lexer(&input);
+  dump_tokens(lexer, out);
+}
+
+void dump_tokens(DfaLexer& lexer, std::ostream& out) {
+  TokenWriter writer(out);
+  for (auto token = lexer.next(); token.type() != antlr4::Token::EOF;
+       token = lexer.next()) {
+    writer.write(token.line_, token.column_, token.type(), lexer.text(token));
   }
 }
 
@@ -1,4 +1,7 @@
 #pragma once
+
+#include <libpas/dfa_lexer.hpp>
+
 #include <PascalLexer.h>
 
 #include <iosfwd>
@@ -6,5 +9,7 @@
 namespace pascal {
 
 void dump_tokens(PascalLexer& lexer, std::ostream& out);
+void dump_tokens(antlr4::CharStream& input, std::ostream& out);
+void dump_tokens(DfaLexer& lexer, std::ostream& out);
 
 }  // namespace pascal
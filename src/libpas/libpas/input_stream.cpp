@@ -0,0 +1,285 @@
+#include <libpas/input_stream.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <system_error>
+#include <utility>
+
+namespace pascal {
+
+ByteStream::ByteStream(std::string_view text, std::string source_name)
+    : text_(text), source_name_(std::move(source_name)) {}
+
+void ByteStream::consume() {
+  if (position_ >= text_.size()) {
+    throw antlr4::IllegalStateException("cannot consume EOF");
+  }
+  ++position_;
+}
+
+size_t ByteStream::LA(ssize_t i) {
+  if (i == 0) {
+    return 0;  // undefined
+  }
+  // LA(1) is the current symbol, LA(-1) the previous one.
+  const auto offset = static_cast<ssize_t>(position_) + (i > 0 ? i - 1 : i);
+  if (offset < 0 || offset >= static_cast<ssize_t>(text_.size())) {
+    return antlr4::IntStream::EOF;
+  }
+  return static_cast<unsigned char>(text_[static_cast<size_t>(offset)]);
+}
+
+ssize_t ByteStream::mark() {
+  // The whole input is always available.
+  return -1;
+}
+
+void ByteStream::release(ssize_t /*marker*/) {}
+
+size_t ByteStream::index() {
+  return position_;
+}
+
+void ByteStream::seek(size_t index) {
+  position_ = std::min(index, text_.size());
+}
+
+size_t ByteStream::size() {
+  return text_.size();
+}
+
+std::string ByteStream::getSourceName() const {
+  return source_name_.empty() ? antlr4::IntStream::UNKNOWN_SOURCE_NAME
+                              : source_name_;
+}
+
+std::string ByteStream::getText(const antlr4::misc::Interval& interval) {
+  if (interval.a < 0 || interval.b < interval.a ||
+      static_cast<size_t>(interval.a) >= text_.size()) {
+    return {};
+  }
+  const auto start = static_cast<size_t>(interval.a);
+  const auto stop = std::min(static_cast<size_t>(interval.b), text_.size() - 1);
+  return std::string(text_.substr(start, stop - start + 1));
+}
+
+std::string ByteStream::toString() const {
+  return std::string(text_);
+}
+
+namespace {
+
+constexpr size_t read_size = 65536;
+
+// Returns 0 at the end of input.
+size_t read_some(int fd, char* data, size_t size, const std::string& name) {
+  while (true) {
+    const auto count = ::read(fd, data, size);
+    if (count >= 0) {
+      return static_cast<size_t>(count);
+    }
+    if (errno != EINTR) {
+      throw std::system_error(errno, std::generic_category(), name);
+    }
+  }
+}
+
+}  // namespace
+
+FdStream::FdStream(int fd, std::string source_name)
+    : fd_(fd), source_name_(std::move(source_name)) {}
+
+void FdStream::consume() {
+  if (LA(1) == antlr4::IntStream::EOF) {
+    throw antlr4::IllegalStateException("cannot consume EOF");
+  }
+  ++position_;
+}
+
+size_t FdStream::LA(ssize_t i) {
+  if (i == 0) {
+    return 0;  // undefined
+  }
+  if (i < 0) {
+    const auto offset = static_cast<ssize_t>(position_) + i;
+    if (offset >= 0) {
+      return static_cast<unsigned char>(data_[static_cast<size_t>(offset)]);
+    }
+    return offset == -1 ? previous_ : antlr4::IntStream::EOF;
+  }
+  const auto offset = position_ + static_cast<size_t>(i) - 1;
+  fill(offset - position_ + 1);
+  if (offset >= data_.size()) {
+    return antlr4::IntStream::EOF;
+  }
+  return static_cast<unsigned char>(data_[offset]);
+}
+
+ssize_t FdStream::mark() {
+  if (markers_ == 0) {
+    mark_position_ = position_;
+  }
+  ++markers_;
+  return -static_cast<ssize_t>(markers_);
+}
+
+void FdStream::release(ssize_t marker) {
+  if (marker != -static_cast<ssize_t>(markers_)) {
+    throw antlr4::IllegalStateException(
+        "release() called with an invalid marker.");
+  }
+  --markers_;
+}
+
+size_t FdStream::index() {
+  return start_ + position_;
+}
+
+void FdStream::seek(size_t index) {
+  if (index < start_) {
+    throw antlr4::IllegalArgumentException(
+        "cannot seek to a discarded index");
+  }
+  while (start_ + position_ < index && LA(1) != antlr4::IntStream::EOF) {
+    consume();
+  }
+  position_ = std::min(index - start_, data_.size());
+}
+
+size_t FdStream::size() {
+  throw antlr4::UnsupportedOperationException(
+      "the size of a streamed input is unknown");
+}
+
+std::string FdStream::getSourceName() const {
+  return source_name_.empty() ? antlr4::IntStream::UNKNOWN_SOURCE_NAME
+                              : source_name_;
+}
+
+std::string FdStream::getText(const antlr4::misc::Interval& interval) {
+  if (interval.a < 0 || interval.b < interval.a) {
+    return {};
+  }
+  const auto end = start_ + data_.size();
+  const auto first = std::max(static_cast<size_t>(interval.a), start_);
+  const auto last = std::min(static_cast<size_t>(interval.b) + 1, end);
+  if (first >= last) {
+    return {};
+  }
+  return data_.substr(first - start_, last - first);
+}
+
+std::string FdStream::toString() const {
+  return data_;
+}
+
+void FdStream::fill(size_t count) {
+  while (data_.size() - position_ < count && !end_of_input_) {
+    discard();
+    const auto size = data_.size();
+    data_.resize(size + read_size);
+    const auto read = read_some(fd_, &data_[size], read_size, source_name_);
+    data_.resize(size + read);
+    end_of_input_ = read == 0;
+  }
+}
+
+void FdStream::discard() {
+  // Compacting only before a read keeps consume() and release() O(1).
+  const auto keep_from = markers_ > 0 ? mark_position_ : position_;
+  if (keep_from == 0) {
+    return;
+  }
+  previous_ = static_cast<unsigned char>(data_[keep_from - 1]);
+  data_.erase(0, keep_from);
+  start_ += keep_from;
+  position_ -= keep_from;
+  mark_position_ -= std::min(mark_position_, keep_from);
+}
+
+SourceFile::SourceFile(const std::string& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw std::system_error(errno, std::generic_category(), path);
+  }
+  try {
+    load(fd, path);
+  } catch (...) {
+    ::close(fd);
+    throw;
+  }
+  ::close(fd);
+}
+
+SourceFile::SourceFile(int fd, const std::string& name) {
+  load(fd, name);
+}
+
+SourceFile::~SourceFile() {
+  unmap();
+}
+
+SourceFile::SourceFile(SourceFile&& other) noexcept
+    : mapping_(std::exchange(other.mapping_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      buffer_(std::move(other.buffer_)) {}
+
+SourceFile& SourceFile::operator=(SourceFile&& other) noexcept {
+  if (this != &other) {
+    unmap();
+    mapping_ = std::exchange(other.mapping_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    buffer_ = std::move(other.buffer_);
+  }
+  return *this;
+}
+
+std::string_view SourceFile::text() const {
+  if (mapping_ != nullptr) {
+    return {static_cast<const char*>(mapping_), size_};
+  }
+  return buffer_;
+}
+
+void SourceFile::load(int fd, const std::string& name) {
+  // A descriptor that was already read from (e.g. stdin) is mapped only if
+  // nothing has been consumed yet.
+  struct stat status {};
+  if (::fstat(fd, &status) == 0 && S_ISREG(status.st_mode) &&
+      status.st_size > 0 && ::lseek(fd, 0, SEEK_CUR) == 0) {
+    size_ = static_cast<size_t>(status.st_size);
+    mapping_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping_ == MAP_FAILED) {
+      mapping_ = nullptr;
+      size_ = 0;
+    } else {
+      ::madvise(mapping_, size_, MADV_SEQUENTIAL);
+      // Leave the descriptor at the end as reading it would, so that a
+      // program run on the same stdin does not see the source again.
+      ::lseek(fd, 0, SEEK_END);
+      return;
+    }
+  }
+
+  // Not mappable: read until end of file.
+  std::array<char, read_size> chunk{};
+  while (const auto count = read_some(fd, chunk.data(), chunk.size(), name)) {
+    buffer_.append(chunk.data(), count);
+  }
+}
+
+void SourceFile::unmap() {
+  if (mapping_ != nullptr) {
+    ::munmap(mapping_, size_);
+    mapping_ = nullptr;
+    size_ = 0;
+  }
+}
+
+}  // namespace pascal
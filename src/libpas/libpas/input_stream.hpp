@@ -0,0 +1,104 @@
+#pragma once
+
+#include <antlr4-runtime.h>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace pascal {
+
+// CharStream over UTF-8 bytes owned by the caller. Unlike
+// antlr4::ANTLRInputStream it neither copies the input nor widens it to
+// UTF-32: every symbol is one byte, so all of Pascal.g4 (which is ASCII)
+// lexes the same way, and non-ASCII bytes inside literals and comments are
+// passed through untouched. Columns count bytes.
+class ByteStream final : public antlr4::CharStream {
+ public:
+  explicit ByteStream(std::string_view text, std::string source_name = {});
+
+  void consume() override;
+  size_t LA(ssize_t i) override;
+  ssize_t mark() override;
+  void release(ssize_t marker) override;
+  size_t index() override;
+  void seek(size_t index) override;
+  size_t size() override;
+  std::string getSourceName() const override;
+  std::string getText(const antlr4::misc::Interval& interval) override;
+  std::string toString() const override;
+
+  std::string_view text() const { return text_; }
+
+ private:
+  std::string_view text_;
+  std::string source_name_;
+  size_t position_ = 0;
+};
+
+// CharStream that reads a file descriptor only as far as the lexer looks
+// ahead, so tokens come out while a pipe is still being written. Symbols
+// before the oldest mark are discarded, which for a lexer means everything
+// before the current token: getText() works inside that window only, so
+// tokens must copy their text (antlr4::CommonTokenFactory(true)) and size()
+// is unsupported. Throws std::system_error if the descriptor cannot be read.
+class FdStream final : public antlr4::CharStream {
+ public:
+  FdStream(int fd, std::string source_name);
+
+  void consume() override;
+  size_t LA(ssize_t i) override;
+  ssize_t mark() override;
+  void release(ssize_t marker) override;
+  size_t index() override;
+  void seek(size_t index) override;
+  size_t size() override;
+  std::string getSourceName() const override;
+  std::string getText(const antlr4::misc::Interval& interval) override;
+  std::string toString() const override;
+
+ private:
+  // Reads until `count` symbols from the current one on are buffered or the
+  // input ends.
+  void fill(size_t count);
+  void discard();
+
+  int fd_;
+  std::string source_name_;
+  bool end_of_input_ = false;
+  // data_[0] is the symbol at index start_.
+  std::string data_;
+  size_t start_ = 0;
+  size_t position_ = 0;
+  size_t previous_ = antlr4::IntStream::EOF;  // the symbol before data_[0]
+  size_t markers_ = 0;
+  size_t mark_position_ = 0;
+};
+
+// Contents of a source file. Regular files are mapped read-only; anything
+// that cannot be mapped (pipes, terminals) is read into an owned buffer.
+// Throws std::system_error if the file cannot be opened or read.
+class SourceFile {
+ public:
+  explicit SourceFile(const std::string& path);
+  // Reads an open descriptor, e.g. stdin, to its end without closing it.
+  SourceFile(int fd, const std::string& name);
+  ~SourceFile();
+
+  SourceFile(SourceFile&& other) noexcept;
+  SourceFile& operator=(SourceFile&& other) noexcept;
+  SourceFile(const SourceFile&) = delete;
+  SourceFile& operator=(const SourceFile&) = delete;
+
+  std::string_view text() const;
+
+ private:
+  void load(int fd, const std::string& name);
+  void unmap();
+
+  void* mapping_ = nullptr;
+  size_t size_ = 0;
+  std::string buffer_;
+};
+
+}  // namespace pascal
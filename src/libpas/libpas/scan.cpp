@@ -0,0 +1,292 @@
+#include <libpas/scan.hpp>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define PASCAL_SCAN_X86 1
+#include <immintrin.h>
+#else
+#define PASCAL_SCAN_X86 0
+#endif
+
+#include <cstdint>
+
+namespace pascal::scan {
+
+namespace {
+
+bool is_space(char byte) {
+  return byte == ' ' || byte == '\t' || byte == '\r' || byte == '\n';
+}
+
+namespace scalar {
+
+const char* skip_whitespace(const char* begin, const char* end) {
+  while (begin != end && is_space(*begin)) {
+    ++begin;
+  }
+  return begin;
+}
+
+const char* find(const char* begin, const char* end, char byte) {
+  while (begin != end && *begin != byte) {
+    ++begin;
+  }
+  return begin;
+}
+
+const char* find_comment_end(const char* begin, const char* end) {
+  for (; begin + 1 < end; ++begin) {
+    if (begin[0] == '*' && begin[1] == ')') {
+      return begin;
+    }
+  }
+  return end;
+}
+
+Lines count_lines(const char* begin, const char* end) {
+  Lines lines;
+  for (; begin != end; ++begin) {
+    if (*begin == '\n') {
+      ++lines.count_;
+      lines.last_ = begin;
+    }
+  }
+  return lines;
+}
+
+}  // namespace scalar
+
+#if PASCAL_SCAN_X86
+
+// Each vector loop handles whole blocks and leaves the tail to the scalar
+// code. Loads are unaligned: the input is a view into any buffer.
+
+namespace sse2 {
+
+constexpr std::ptrdiff_t width = 16;
+
+__m128i load(const char* pointer) {
+  // NOLINTNEXTLINE
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(pointer));
+}
+
+uint32_t mask_of(__m128i bytes) {
+  return static_cast<uint32_t>(_mm_movemask_epi8(bytes));
+}
+
+const char* skip_whitespace(const char* begin, const char* end) {
+  const auto space = _mm_set1_epi8(' ');
+  const auto tab = _mm_set1_epi8('\t');
+  const auto carriage_return = _mm_set1_epi8('\r');
+  const auto newline = _mm_set1_epi8('\n');
+  for (; end - begin >= width; begin += width) {
+    const auto bytes = load(begin);
+    const auto spaces = _mm_or_si128(
+        _mm_or_si128(
+            _mm_cmpeq_epi8(bytes, space), _mm_cmpeq_epi8(bytes, tab)),
+        _mm_or_si128(
+            _mm_cmpeq_epi8(bytes, carriage_return),
+            _mm_cmpeq_epi8(bytes, newline)));
+    const auto others = ~mask_of(spaces) & 0xffffU;
+    if (others != 0) {
+      return begin + __builtin_ctz(others);
+    }
+  }
+  return scalar::skip_whitespace(begin, end);
+}
+
+const char* find(const char* begin, const char* end, char byte) {
+  const auto needle = _mm_set1_epi8(byte);
+  for (; end - begin >= width; begin += width) {
+    const auto found = mask_of(_mm_cmpeq_epi8(load(begin), needle));
+    if (found != 0) {
+      return begin + __builtin_ctz(found);
+    }
+  }
+  return scalar::find(begin, end, byte);
+}
+
+const char* find_comment_end(const char* begin, const char* end) {
+  const auto star = _mm_set1_epi8('*');
+  const auto paren = _mm_set1_epi8(')');
+  // Compares each byte and its successor, so a block needs one more byte.
+  for (; end - begin > width; begin += width) {
+    const auto found = mask_of(_mm_and_si128(
+        _mm_cmpeq_epi8(load(begin), star),
+        _mm_cmpeq_epi8(load(begin + 1), paren)));
+    if (found != 0) {
+      return begin + __builtin_ctz(found);
+    }
+  }
+  return scalar::find_comment_end(begin, end);
+}
+
+Lines count_lines(const char* begin, const char* end) {
+  const auto newline = _mm_set1_epi8('\n');
+  Lines lines;
+  for (; end - begin >= width; begin += width) {
+    const auto found = mask_of(_mm_cmpeq_epi8(load(begin), newline));
+    if (found != 0) {
+      lines.count_ += static_cast<size_t>(__builtin_popcount(found));
+      lines.last_ = begin + 31 - __builtin_clz(found);
+    }
+  }
+  const auto tail = scalar::count_lines(begin, end);
+  lines.count_ += tail.count_;
+  if (tail.last_ != nullptr) {
+    lines.last_ = tail.last_;
+  }
+  return lines;
+}
+
+}  // namespace sse2
+
+namespace avx2 {
+
+constexpr std::ptrdiff_t width = 32;
+
+__attribute__((target("avx2"))) __m256i load(const char* pointer) {
+  // NOLINTNEXTLINE
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pointer));
+}
+
+__attribute__((target("avx2"))) uint32_t mask_of(__m256i bytes) {
+  return static_cast<uint32_t>(_mm256_movemask_epi8(bytes));
+}
+
+__attribute__((target("avx2"))) const char* skip_whitespace(
+    const char* begin,
+    const char* end) {
+  const auto space = _mm256_set1_epi8(' ');
+  const auto tab = _mm256_set1_epi8('\t');
+  const auto carriage_return = _mm256_set1_epi8('\r');
+  const auto newline = _mm256_set1_epi8('\n');
+  for (; end - begin >= width; begin += width) {
+    const auto bytes = load(begin);
+    const auto spaces = _mm256_or_si256(
+        _mm256_or_si256(
+            _mm256_cmpeq_epi8(bytes, space), _mm256_cmpeq_epi8(bytes, tab)),
+        _mm256_or_si256(
+            _mm256_cmpeq_epi8(bytes, carriage_return),
+            _mm256_cmpeq_epi8(bytes, newline)));
+    const auto others = ~mask_of(spaces);
+    if (others != 0) {
+      return begin + __builtin_ctz(others);
+    }
+  }
+  return sse2::skip_whitespace(begin, end);
+}
+
+__attribute__((target("avx2"))) const char* find(
+    const char* begin,
+    const char* end,
+    char byte) {
+  const auto needle = _mm256_set1_epi8(byte);
+  for (; end - begin >= width; begin += width) {
+    const auto found = mask_of(_mm256_cmpeq_epi8(load(begin), needle));
+    if (found != 0) {
+      return begin + __builtin_ctz(found);
+    }
+  }
+  return sse2::find(begin, end, byte);
+}
+
+__attribute__((target("avx2"))) const char* find_comment_end(
+    const char* begin,
+    const char* end) {
+  const auto star = _mm256_set1_epi8('*');
+  const auto paren = _mm256_set1_epi8(')');
+  for (; end - begin > width; begin += width) {
+    const auto found = mask_of(_mm256_and_si256(
+        _mm256_cmpeq_epi8(load(begin), star),
+        _mm256_cmpeq_epi8(load(begin + 1), paren)));
+    if (found != 0) {
+      return begin + __builtin_ctz(found);
+    }
+  }
+  return sse2::find_comment_end(begin, end);
+}
+
+__attribute__((target("avx2"))) Lines count_lines(
+    const char* begin,
+    const char* end) {
+  const auto newline = _mm256_set1_epi8('\n');
+  Lines lines;
+  for (; end - begin >= width; begin += width) {
+    const auto found = mask_of(_mm256_cmpeq_epi8(load(begin), newline));
+    if (found != 0) {
+      lines.count_ += static_cast<size_t>(__builtin_popcount(found));
+      lines.last_ = begin + 31 - __builtin_clz(found);
+    }
+  }
+  const auto tail = sse2::count_lines(begin, end);
+  lines.count_ += tail.count_;
+  if (tail.last_ != nullptr) {
+    lines.last_ = tail.last_;
+  }
+  return lines;
+}
+
+}  // namespace avx2
+
+#endif
+
+constexpr Scanner scalar_scanner{
+    scalar::skip_whitespace,
+    scalar::find,
+    scalar::find_comment_end,
+    scalar::count_lines};
+
+#if PASCAL_SCAN_X86
+constexpr Scanner sse2_scanner{
+    sse2::skip_whitespace,
+    sse2::find,
+    sse2::find_comment_end,
+    sse2::count_lines};
+
+constexpr Scanner avx2_scanner{
+    avx2::skip_whitespace,
+    avx2::find,
+    avx2::find_comment_end,
+    avx2::count_lines};
+#endif
+
+}  // namespace
+
+Isa best_isa() {
+  static const auto isa = is_supported(Isa::Avx2) ? Isa::Avx2
+      : is_supported(Isa::Sse2)                   ? Isa::Sse2
+                                                  : Isa::Scalar;
+  return isa;
+}
+
+bool is_supported(Isa isa) {
+  switch (isa) {
+    case Isa::Scalar:
+      return true;
+    case Isa::Sse2:
+      // Part of x86-64 itself.
+      return PASCAL_SCAN_X86 != 0;
+    case Isa::Avx2:
+#if PASCAL_SCAN_X86
+      return __builtin_cpu_supports("avx2") != 0;
+#else
+      return false;
+#endif
+  }
+  return false;
+}
+
+const Scanner& scanner(Isa isa) {
+  switch (isa) {
+#if PASCAL_SCAN_X86
+    case Isa::Avx2:
+      return avx2_scanner;
+    case Isa::Sse2:
+      return sse2_scanner;
+#endif
+    default:
+      return scalar_scanner;
+  }
+}
+
+}  // namespace pascal::scan
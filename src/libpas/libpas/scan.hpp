@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+
+namespace pascal::scan {
+
+// Instruction sets the scanners are written for, narrowest first.
+enum class Isa { Scalar, Sse2, Avx2 };
+
+// The widest instruction set this CPU supports.
+Isa best_isa();
+bool is_supported(Isa isa);
+
+struct Lines {
+  size_t count_ = 0;
+  // The last '\n', or null if there is none.
+  const char* last_ = nullptr;
+};
+
+// Byte scanners over [begin, end) for the parts of a program the lexer does
+// not need to look at one byte at a time. Each returns `end` if the input
+// runs out first.
+struct Scanner {
+  // First byte that is not ' ', '\t', '\r' or '\n'.
+  const char* (*skip_whitespace_)(const char* begin, const char* end);
+  // First occurrence of `byte`, like memchr.
+  const char* (*find_)(const char* begin, const char* end, char byte);
+  // The '*' of the first "*)".
+  const char* (*find_comment_end_)(const char* begin, const char* end);
+  Lines (*count_lines_)(const char* begin, const char* end);
+};
+
+// The scanner for a supported instruction set.
+const Scanner& scanner(Isa isa = best_isa());
+
+}  // namespace pascal::scan
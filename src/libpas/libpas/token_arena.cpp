@@ -0,0 +1,243 @@
+#include <libpas/token_arena.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+namespace pascal {
+
+TokenArena::TokenArena(std::string_view source, scan::Isa isa)
+    : source_(source) {
+  DfaLexer lexer(source, isa);
+  // Pascal sources average well over four bytes per token; the estimate
+  // keeps growth to a doubling or two, and the array is trimmed at the end.
+  tokens_.reserve(source.size() / 8 + 1);
+  do {
+    tokens_.push_back(lexer.next());
+  } while (tokens_.back().type() != antlr4::Token::EOF);
+  tokens_.shrink_to_fit();
+}
+
+ArenaTokenStream::ArenaTokenStream(ByteStream& input)
+    : input_(input),
+      arena_(input.text()),
+      source_(input),
+      views_(arena_.size(), View(this)) {}
+
+antlr4::Token* ArenaTokenStream::LT(ssize_t k) {
+  if (k == 0) {
+    return nullptr;
+  }
+  if (k < 0) {
+    const auto back = static_cast<size_t>(-k);
+    return back <= position_ ? &views_[position_ - back] : nullptr;
+  }
+  // Past the end every token is EOF.
+  const auto index =
+      std::min(position_ + static_cast<size_t>(k) - 1, views_.size() - 1);
+  return &views_[index];
+}
+
+antlr4::Token* ArenaTokenStream::get(size_t index) const {
+  if (index >= views_.size()) {
+    throw antlr4::IndexOutOfBoundsException(
+        "token index " + std::to_string(index) + " out of range 0.." +
+        std::to_string(views_.size() - 1));
+  }
+  return const_cast<View*>(&views_[index]);
+}
+
+antlr4::TokenSource* ArenaTokenStream::getTokenSource() const {
+  return &source_;
+}
+
+std::string ArenaTokenStream::getText(const antlr4::misc::Interval& interval) {
+  // The texts of the tokens in the interval, up to EOF, as
+  // BufferedTokenStream joins them. Whitespace and comments are not tokens.
+  const auto start = interval.a;
+  auto stop = interval.b;
+  if (start < 0 || stop < 0) {
+    return "";
+  }
+  stop = std::min(stop, static_cast<ssize_t>(arena_.size()) - 1);
+  std::string text;
+  for (auto i = static_cast<size_t>(start); i <= static_cast<size_t>(stop);
+       ++i) {
+    const auto& token = arena_[i];
+    if (token.type() == antlr4::Token::EOF) {
+      break;
+    }
+    text += arena_.text(token);
+  }
+  return text;
+}
+
+std::string ArenaTokenStream::getText() {
+  return getText(antlr4::misc::Interval(
+      ssize_t{0}, static_cast<ssize_t>(arena_.size()) - 1));
+}
+
+std::string ArenaTokenStream::getText(antlr4::RuleContext* context) {
+  return getText(context->getSourceInterval());
+}
+
+std::string ArenaTokenStream::getText(
+    antlr4::Token* start,
+    antlr4::Token* stop) {
+  if (start == nullptr || stop == nullptr) {
+    return "";
+  }
+  return getText(
+      antlr4::misc::Interval(start->getTokenIndex(), stop->getTokenIndex()));
+}
+
+void ArenaTokenStream::consume() {
+  if (LA(1) == antlr4::Token::EOF) {
+    throw antlr4::IllegalStateException("cannot consume EOF");
+  }
+  ++position_;
+}
+
+size_t ArenaTokenStream::LA(ssize_t i) {
+  const auto* token = LT(i);
+  return token != nullptr ? token->getType() : antlr4::Token::INVALID_TYPE;
+}
+
+ssize_t ArenaTokenStream::mark() {
+  return 0;
+}
+
+void ArenaTokenStream::release(ssize_t /*marker*/) {}
+
+size_t ArenaTokenStream::index() {
+  return position_;
+}
+
+void ArenaTokenStream::seek(size_t index) {
+  position_ = std::min(index, views_.size() - 1);
+}
+
+size_t ArenaTokenStream::size() {
+  return views_.size();
+}
+
+std::string ArenaTokenStream::getSourceName() const {
+  return input_.getSourceName();
+}
+
+const Token& ArenaTokenStream::View::token() const {
+  return stream_->arena_[getTokenIndex()];
+}
+
+std::string ArenaTokenStream::View::getText() const {
+  const auto& token = this->token();
+  if (token.type() == antlr4::Token::EOF) {
+    // What CommonToken says when its text lies past the input.
+    return "<EOF>";
+  }
+  return std::string(stream_->arena_.text(token));
+}
+
+size_t ArenaTokenStream::View::getType() const {
+  return token().type();
+}
+
+size_t ArenaTokenStream::View::getLine() const {
+  return token().line_;
+}
+
+size_t ArenaTokenStream::View::getCharPositionInLine() const {
+  return token().column_;
+}
+
+size_t ArenaTokenStream::View::getChannel() const {
+  return antlr4::Token::DEFAULT_CHANNEL;
+}
+
+size_t ArenaTokenStream::View::getTokenIndex() const {
+  return static_cast<size_t>(this - stream_->views_.data());
+}
+
+size_t ArenaTokenStream::View::getStartIndex() const {
+  return token().start_;
+}
+
+size_t ArenaTokenStream::View::getStopIndex() const {
+  // EOF spans [start, start - 1], as in PascalLexer.
+  const auto& token = this->token();
+  return size_t{token.start_} + token.length_ - 1;
+}
+
+antlr4::TokenSource* ArenaTokenStream::View::getTokenSource() const {
+  return &stream_->source_;
+}
+
+antlr4::CharStream* ArenaTokenStream::View::getInputStream() const {
+  return &stream_->input_;
+}
+
+std::string ArenaTokenStream::View::toString() const {
+  // The format of CommonToken::toString, where EOF is -1.
+  const auto number = [](size_t value) {
+    return value == antlr4::Token::EOF ? std::string("-1")
+                                       : std::to_string(value);
+  };
+  std::string text;
+  for (const auto ch : getText()) {
+    switch (ch) {
+      case '\n':
+        text += "\\n";
+        break;
+      case '\r':
+        text += "\\r";
+        break;
+      case '\t':
+        text += "\\t";
+        break;
+      default:
+        text += ch;
+    }
+  }
+  return "[@" + number(getTokenIndex()) + "," + number(getStartIndex()) +
+      ":" + number(getStopIndex()) + "='" + text + "',<" +
+      number(getType()) + ">," + number(getLine()) + ":" +
+      number(getCharPositionInLine()) + "]";
+}
+
+std::unique_ptr<antlr4::Token> ArenaTokenStream::Source::nextToken() {
+  // Never asked for: the stream has all tokens. Behaves like an exhausted
+  // lexer.
+  const auto end = input_.size();
+  return getTokenFactory()->create(
+      {this, &input_},
+      antlr4::Token::EOF,
+      {},
+      antlr4::Token::DEFAULT_CHANNEL,
+      end,
+      end - 1,
+      getLine(),
+      getCharPositionInLine());
+}
+
+size_t ArenaTokenStream::Source::getLine() const {
+  return 0;
+}
+
+size_t ArenaTokenStream::Source::getCharPositionInLine() {
+  return 0;
+}
+
+antlr4::CharStream* ArenaTokenStream::Source::getInputStream() {
+  return &input_;
+}
+
+std::string ArenaTokenStream::Source::getSourceName() {
+  return input_.getSourceName();
+}
+
+antlr4::TokenFactory<antlr4::CommonToken>*
+ArenaTokenStream::Source::getTokenFactory() {
+  return antlr4::CommonTokenFactory::DEFAULT.get();
+}
+
+}  // namespace pascal
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <libpas/dfa_lexer.hpp>
+#include <libpas/input_stream.hpp>
+#include <libpas/scan.hpp>
+
+#include <antlr4-runtime.h>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pascal {
+
+// All tokens of a source, lexed up front by DfaLexer into one array of
+// 16-byte Tokens, EOF last. Token text is a view of the source, which must
+// outlive the arena.
+class TokenArena {
+ public:
+  explicit TokenArena(
+      std::string_view source,
+      scan::Isa isa = scan::best_isa());
+
+  size_t size() const { return tokens_.size(); }
+  const Token& operator[](size_t index) const { return tokens_[index]; }
+  const Token* begin() const { return tokens_.data(); }
+  const Token* end() const { return tokens_.data() + tokens_.size(); }
+
+  std::string_view text(const Token& token) const {
+    return source_.substr(token.start_, token.length_);
+  }
+  std::string_view source() const { return source_; }
+
+ private:
+  std::string_view source_;
+  std::vector<Token> tokens_;
+};
+
+// Feeds a TokenArena to PascalParser in place of a CommonTokenStream, which
+// keeps a heap-allocated CommonToken per token. Each antlr4::Token handed to
+// the parser is a 16-byte view of an arena token, and all views live in one
+// array. The tokens are the same as PascalLexer's over `input`.
+class ArenaTokenStream final : public antlr4::TokenStream {
+ public:
+  explicit ArenaTokenStream(ByteStream& input);
+  ArenaTokenStream(const ArenaTokenStream&) = delete;
+  ArenaTokenStream& operator=(const ArenaTokenStream&) = delete;
+
+  const TokenArena& arena() const { return arena_; }
+
+  antlr4::Token* LT(ssize_t k) override;
+  antlr4::Token* get(size_t index) const override;
+  antlr4::TokenSource* getTokenSource() const override;
+  std::string getText(const antlr4::misc::Interval& interval) override;
+  std::string getText() override;
+  std::string getText(antlr4::RuleContext* context) override;
+  std::string getText(antlr4::Token* start, antlr4::Token* stop) override;
+
+  void consume() override;
+  size_t LA(ssize_t i) override;
+  ssize_t mark() override;
+  void release(ssize_t marker) override;
+  size_t index() override;
+  void seek(size_t index) override;
+  size_t size() override;
+  std::string getSourceName() const override;
+
+ private:
+  // An antlr4::Token that only knows its stream; its index is its offset in
+  // views_.
+  class View final : public antlr4::Token {
+   public:
+    explicit View(ArenaTokenStream* stream) : stream_(stream) {}
+
+    std::string getText() const override;
+    size_t getType() const override;
+    size_t getLine() const override;
+    size_t getCharPositionInLine() const override;
+    size_t getChannel() const override;
+    size_t getTokenIndex() const override;
+    size_t getStartIndex() const override;
+    size_t getStopIndex() const override;
+    antlr4::TokenSource* getTokenSource() const override;
+    antlr4::CharStream* getInputStream() const override;
+    std::string toString() const override;
+
+   private:
+    const pascal::Token& token() const;
+
+    ArenaTokenStream* stream_;
+  };
+
+  // Where the parser's error recovery gets its input and token factory from.
+  // The tokens themselves all come from the arena.
+  class Source final : public antlr4::TokenSource {
+   public:
+    explicit Source(ByteStream& input) : input_(input) {}
+
+    std::unique_ptr<antlr4::Token> nextToken() override;
+    size_t getLine() const override;
+    size_t getCharPositionInLine() override;
+    antlr4::CharStream* getInputStream() override;
+    std::string getSourceName() override;
+    antlr4::TokenFactory<antlr4::CommonToken>* getTokenFactory() override;
+
+   private:
+    ByteStream& input_;
+  };
+
+  ByteStream& input_;
+  TokenArena arena_;
+  mutable Source source_;
+  std::vector<View> views_;
+  size_t position_ = 0;
+};
+
+}  // namespace pascal
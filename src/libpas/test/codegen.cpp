@@ -1,18 +1,23 @@
 #include <libpas/compiler.hpp>
 
-#include <PascalLexer.h>
-#include <antlr4-runtime.h>
 #include <gtest/gtest.h>
 
+#include "front_end.hpp"
+
 #include <algorithm>
 #include <exception>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <iterator>
+#include <optional>
 #include <sstream>
 #include <string>
 
 namespace pascal::test {
 
+class CodegenSuite : public testing::TestWithParam<FrontEnd> {};
+
 static size_t count_indentation(const std::string& str) {
   const auto it = std::find_if_not(
       str.begin(), str.end(), [](char ch) { return std::isspace(ch); });
@@ -37,7 +42,7 @@ static std::string dedent(const std::string& str) {
   return out.str();
 }
 
-TEST(CodegenSuite, HelloWorld) {
+TEST_P(CodegenSuite, HelloWorld) {
   std::stringstream in(R"(
     {Test HelloWorld program}
     Program HelloWorld;
@@ -46,10 +51,7 @@ TEST(CodegenSuite, HelloWorld) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
 
   std::stringstream llvm_ir_str;
@@ -60,29 +62,23 @@ TEST(CodegenSuite, HelloWorld) {
   pascal::code_generate(parse_result.program_, symbol_table, llvm_ir_str);
   EXPECT_TRUE(error_stream.str().empty());
   EXPECT_EQ(llvm_ir_str.str(), dedent(R"(
+    ; ModuleID = 'helloworld'
+    source_filename = "helloworld"
     target triple = "x86_64-pc-linux-gnu"
-    declare i32 @printf(i8* %format, ...)
-    declare i32 @__isoc99_scanf(i8*, ...)
 
-
-    @.str.strln = constant [4 x i8] c"%s\0A\00"
-    define void @writeln_string(i8* %x) {
-      call i32 (i8*, ...) @printf(i8* getelementptr ([4 x i8], [4 x i8]* @.str.strln, i64 0, i64 0), i8* %x)
-      ret void
-    }
-
-    @.str.1 = constant [13 x i8] c"Hello world!\00"
+    @.str = private unnamed_addr constant [13 x i8] c"Hello world!\00", align 1
+    @.str.1 = private unnamed_addr constant [4 x i8] c"%s\0A\00", align 1
 
     define i32 @main() {
     start:
-      %.2 = getelementptr [13 x i8], [13 x i8]* @.str.1, i64 0, i64 0
-      call void @writeln_string(i8* %.2)
-
+      %0 = call i32 (i8*, ...) @printf(i8* getelementptr inbounds ([4 x i8], [4 x i8]* @.str.1, i32 0, i32 0), i8* getelementptr inbounds ([13 x i8], [13 x i8]* @.str, i32 0, i32 0))
       ret i32 0
-    })"));
+    }
+
+    declare i32 @printf(i8*, ...))"));
 }
 
-TEST(CodegenSuite, GCD) {
+TEST_P(CodegenSuite, GCD) {
   std::stringstream in(R"(
     {Test GCD program}
     program GCD;
@@ -107,10 +103,7 @@ TEST(CodegenSuite, GCD) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
 
   std::stringstream llvm_ir_str;
@@ -121,145 +114,93 @@ TEST(CodegenSuite, GCD) {
   pascal::code_generate(parse_result.program_, symbol_table, llvm_ir_str);
   EXPECT_TRUE(error_stream.str().empty());
   EXPECT_EQ(llvm_ir_str.str(), dedent(R"(
+    ; ModuleID = 'gcd'
+    source_filename = "gcd"
     target triple = "x86_64-pc-linux-gnu"
-    declare i32 @printf(i8* %format, ...)
-    declare i32 @__isoc99_scanf(i8*, ...)
-
-    @.str.int = constant [3 x i8] c"%d\00"
-    @.str.str = constant [3 x i8] c"%s\00"
 
-    define void @read_int(i32* %x) {
-      call i32 (i8*, ...) @__isoc99_scanf(i8* getelementptr  ([3 x i8], [3 x i8]* @.str.int, i64 0, i64 0), i32* %x)
-      ret void
-    }
-
-    define void @write_string(i8* %x) {
-      call i32 (i8*, ...) @printf(i8* getelementptr ([3 x i8], [3 x i8]* @.str.str, i64 0, i64 0), i8* %x)
-      ret void
-    }
-
-    @.str.intln = constant [4 x i8] c"%d\0A\00"
-    define void @writeln_int(i32 %x) {
-      call i32 (i8*, ...) @printf(i8* getelementptr ([4 x i8], [4 x i8]* @.str.intln, i64 0, i64 0), i32 %x)
-      ret void
-    }
-
-    @.str.strln = constant [4 x i8] c"%s\0A\00"
-    define void @writeln_string(i8* %x) {
-      call i32 (i8*, ...) @printf(i8* getelementptr ([4 x i8], [4 x i8]* @.str.strln, i64 0, i64 0), i8* %x)
-      ret void
-    }
-
-    @.str.6 = constant [14 x i8] c"Enter a and b\00"
-    @.str.45 = constant [6 x i8] c"GCD: \00"
+    @.str = private unnamed_addr constant [14 x i8] c"Enter a and b\00", align 1
+    @.str.1 = private unnamed_addr constant [4 x i8] c"%s\0A\00", align 1
+    @.str.2 = private unnamed_addr constant [3 x i8] c"%d\00", align 1
+    @.str.3 = private unnamed_addr constant [6 x i8] c"GCD: \00", align 1
+    @.str.4 = private unnamed_addr constant [3 x i8] c"%s\00", align 1
+    @.str.5 = private unnamed_addr constant [4 x i8] c"%d\0A\00", align 1
 
     define i32 @main() {
     start:
-      %.1 = alloca i32
-      %.2 = alloca i32
-      %.3 = alloca i32
-      %.4 = alloca i32
-      %.5 = alloca i32
-
-      %.7 = getelementptr [14 x i8], [14 x i8]* @.str.6, i64 0, i64 0
-      call void @writeln_string(i8* %.7)
-
-      call void @read_int(i32* %.3)
-      call void @read_int(i32* %.4)
-
-      %.8 = load i32, i32* %.3
-
-      %.9 = load i32, i32* %.4
-
-      %.10 = icmp slt i32%.8, %.9
-      br i1 %.10, label %.11, label %.12
-
-    .11:
-      %.14 = load i32, i32* %.3
-
-      store i32 %.14, i32* %.5
-      br label %.13
-
-    .12:
-      %.15 = load i32, i32* %.4
-
-      store i32 %.15, i32* %.5
-      br label %.13
-
-    .13:
-      %.16 = alloca i32
-      store i32 1, i32* %.16
-      %.17 = load i32, i32* %.16
-
-      store i32 %.17, i32* %.2
-      br label %.18
-
-    .18:
-      %.19 = load i32, i32* %.2
-
-      %.20 = load i32, i32* %.5
-
-      %.21 = icmp sle i32%.19, %.20
-      br i1 %.21, label %.22, label %.23
-
-    .22:
-      %.24 = load i32, i32* %.3
-
-      %.25 = load i32, i32* %.2
-
-      %.26 = srem i32 %.24, %.25
-      %.27 = alloca i32
-      store i32 0, i32* %.27
-      %.28 = load i32, i32* %.27
-
-      %.29 = icmp eq i32%.26, %.28
-      br i1 %.29, label %.30, label %.31
-
-    .30:
-      %.32 = load i32, i32* %.4
-
-      %.33 = load i32, i32* %.2
-
-      %.34 = srem i32 %.32, %.33
-      %.35 = alloca i32
-      store i32 0, i32* %.35
-      %.36 = load i32, i32* %.35
-
-      %.37 = icmp eq i32%.34, %.36
-      br i1 %.37, label %.38, label %.39
-
-    .38:
-      %.40 = load i32, i32* %.2
-
-      store i32 %.40, i32* %.1
-      br label %.39
-
-    .39:
-      br label %.31
-
-    .31:
-      %.41 = alloca i32
-      store i32 1, i32* %.41
-      %.42 = load i32, i32* %.41
-
-      %.43 = load i32, i32* %.2
-
-      %.44 = add i32 %.43, %.42
-      store i32 %.44, i32* %.2
-      br label %.18
-
-    .23:
-      %.46 = getelementptr [6 x i8], [6 x i8]* @.str.45, i64 0, i64 0
-      call void @write_string(i8* %.46)
-      %.47 = load i32, i32* %.1
+      %z = alloca i32, align 4
+      %i = alloca i32, align 4
+      %a = alloca i32, align 4
+      %b = alloca i32, align 4
+      %m = alloca i32, align 4
+      %0 = call i32 (i8*, ...) @printf(i8* getelementptr inbounds ([4 x i8], [4 x i8]* @.str.1, i32 0, i32 0), i8* getelementptr inbounds ([14 x i8], [14 x i8]* @.str, i32 0, i32 0))
+      %1 = call i32 (i8*, ...) @__isoc99_scanf(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @.str.2, i32 0, i32 0), i32* %a)
+      %2 = call i32 (i8*, ...) @__isoc99_scanf(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @.str.2, i32 0, i32 0), i32* %b)
+      %a1 = load i32, i32* %a, align 4
+      %b2 = load i32, i32* %b, align 4
+      %3 = icmp slt i32 %a1, %b2
+      br i1 %3, label %if.then, label %if.else
+
+    if.then:                                          ; preds = %start
+      %a3 = load i32, i32* %a, align 4
+      store i32 %a3, i32* %m, align 4
+      br label %if.end
+
+    if.else:                                          ; preds = %start
+      %b4 = load i32, i32* %b, align 4
+      store i32 %b4, i32* %m, align 4
+      br label %if.end
+
+    if.end:                                           ; preds = %if.else, %if.then
+      store i32 1, i32* %i, align 4
+      br label %while.cond
+
+    while.cond:                                       ; preds = %if.end15, %if.end
+      %i5 = load i32, i32* %i, align 4
+      %m6 = load i32, i32* %m, align 4
+      %4 = icmp sle i32 %i5, %m6
+      br i1 %4, label %while.body, label %while.end
+
+    while.body:                                       ; preds = %while.cond
+      %a7 = load i32, i32* %a, align 4
+      %i8 = load i32, i32* %i, align 4
+      %5 = srem i32 %a7, %i8
+      %6 = icmp eq i32 %5, 0
+      br i1 %6, label %if.then9, label %if.end15
+
+    if.then9:                                         ; preds = %while.body
+      %b10 = load i32, i32* %b, align 4
+      %i11 = load i32, i32* %i, align 4
+      %7 = srem i32 %b10, %i11
+      %8 = icmp eq i32 %7, 0
+      br i1 %8, label %if.then12, label %if.end14
+
+    if.then12:                                        ; preds = %if.then9
+      %i13 = load i32, i32* %i, align 4
+      store i32 %i13, i32* %z, align 4
+      br label %if.end14
+
+    if.end14:                                         ; preds = %if.then12, %if.then9
+      br label %if.end15
+
+    if.end15:                                         ; preds = %if.end14, %while.body
+      %9 = load i32, i32* %i, align 4
+      %10 = add i32 %9, 1
+      store i32 %10, i32* %i, align 4
+      br label %while.cond
+
+    while.end:                                        ; preds = %while.cond
+      %11 = call i32 (i8*, ...) @printf(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @.str.4, i32 0, i32 0), i8* getelementptr inbounds ([6 x i8], [6 x i8]* @.str.3, i32 0, i32 0))
+      %z16 = load i32, i32* %z, align 4
+      %12 = call i32 (i8*, ...) @printf(i8* getelementptr inbounds ([4 x i8], [4 x i8]* @.str.5, i32 0, i32 0), i32 %z16)
+      ret i32 0
+    }
 
-      call void @writeln_int(i32 %.47)
+    declare i32 @printf(i8*, ...)
 
-      ret i32 0
-    })"));
+    declare i32 @__isoc99_scanf(i8*, ...))"));
 }
 
-TEST(CodegenSuite, ArrMin) {
+TEST_P(CodegenSuite, ArrMin) {
   std::stringstream in(R"(
     {Test ArrMin program}
     program ArrMin;
@@ -288,10 +229,7 @@ TEST(CodegenSuite, ArrMin) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
 
   std::stringstream llvm_ir_str;
@@ -302,162 +240,101 @@ TEST(CodegenSuite, ArrMin) {
   pascal::code_generate(parse_result.program_, symbol_table, llvm_ir_str);
   EXPECT_TRUE(error_stream.str().empty());
   EXPECT_EQ(llvm_ir_str.str(), dedent(R"(
+    ; ModuleID = 'arrmin'
+    source_filename = "arrmin"
     target triple = "x86_64-pc-linux-gnu"
-    declare i32 @printf(i8* %format, ...)
-    declare i32 @__isoc99_scanf(i8*, ...)
-
-    @.str.int = constant [3 x i8] c"%d\00"
-    @.str.str = constant [3 x i8] c"%s\00"
-
-    define void @read_int(i32* %x) {
-      call i32 (i8*, ...) @__isoc99_scanf(i8* getelementptr  ([3 x i8], [3 x i8]* @.str.int, i64 0, i64 0), i32* %x)
-      ret void
-    }
 
-    define void @write_int(i32 %x) {
-      call i32 (i8*, ...) @printf(i8* getelementptr ([3 x i8], [3 x i8]* @.str.int, i64 0, i64 0), i32 %x)
-      ret void
-    }
-
-    define void @write_string(i8* %x) {
-      call i32 (i8*, ...) @printf(i8* getelementptr ([3 x i8], [3 x i8]* @.str.str, i64 0, i64 0), i8* %x)
-      ret void
-    }
-
-    @.str.intln = constant [4 x i8] c"%d\0A\00"
-    define void @writeln_int(i32 %x) {
-      call i32 (i8*, ...) @printf(i8* getelementptr ([4 x i8], [4 x i8]* @.str.intln, i64 0, i64 0), i32 %x)
-      ret void
-    }
-
-    @.str.5 = constant [19 x i8] c"Enter array size: \00"
-    @.str.15 = constant [7 x i8] c"Enter \00"
-    @.str.18 = constant [11 x i8] c" element: \00"
-    @.str.60 = constant [6 x i8] c"Min: \00"
+    @.str = private unnamed_addr constant [19 x i8] c"Enter array size: \00", align 1
+    @.str.1 = private unnamed_addr constant [3 x i8] c"%s\00", align 1
+    @.str.2 = private unnamed_addr constant [3 x i8] c"%d\00", align 1
+    @.str.3 = private unnamed_addr constant [7 x i8] c"Enter \00", align 1
+    @.str.4 = private unnamed_addr constant [11 x i8] c" element: \00", align 1
+    @.str.5 = private unnamed_addr constant [6 x i8] c"Min: \00", align 1
+    @.str.6 = private unnamed_addr constant [4 x i8] c"%d\0A\00", align 1
 
     define i32 @main() {
     start:
-      %.1 = alloca [99 x i32]
-      %.2 = alloca i32
-      %.3 = alloca i32
-      %.4 = alloca i32
-
-      %.6 = getelementptr [19 x i8], [19 x i8]* @.str.5, i64 0, i64 0
-      call void @write_string(i8* %.6)
-
-      call void @read_int(i32* %.4)
-
-      %.7 = alloca i32
-      store i32 1, i32* %.7
-      %.8 = load i32, i32* %.7
-
-      store i32 %.8, i32* %.3
-      br label %.9
-
-    .9:
-      %.10 = load i32, i32* %.3
-
-      %.11 = load i32, i32* %.4
-
-      %.12 = icmp sle i32%.10, %.11
-      br i1 %.12, label %.13, label %.14
-
-    .13:
-      %.16 = getelementptr [7 x i8], [7 x i8]* @.str.15, i64 0, i64 0
-      call void @write_string(i8* %.16)
-      %.17 = load i32, i32* %.3
-
-      call void @write_int(i32 %.17)
-      %.19 = getelementptr [11 x i8], [11 x i8]* @.str.18, i64 0, i64 0
-      call void @write_string(i8* %.19)
-
-      %.20 = load i32, i32* %.3
-
-      %.21 = sub i32 %.20, 1
-      %.22 = sext i32 %.21 to i64
-      %.23 = getelementptr [99 x i32], [99 x i32]* %.1, i64 0, i64 %.22
-      call void @read_int(i32* %.23)
-
-      %.24 = alloca i32
-      store i32 1, i32* %.24
-      %.25 = load i32, i32* %.24
-
-      %.26 = load i32, i32* %.3
-
-      %.27 = add i32 %.26, %.25
-      store i32 %.27, i32* %.3
-      br label %.9
-
-    .14:
-      %.28 = alloca i32
-      store i32 1, i32* %.28
-      %.29 = load i32, i32* %.28
-
-      %.30 = sub i32 %.29, 1
-      %.31 = sext i32 %.30 to i64
-      %.32 = getelementptr [99 x i32], [99 x i32]* %.1, i64 0, i64 %.31
-      %.33 = load i32, i32* %.32
-      store i32 %.33, i32* %.2
-      %.34 = alloca i32
-      store i32 2, i32* %.34
-      %.35 = load i32, i32* %.34
-
-      store i32 %.35, i32* %.3
-      br label %.36
-
-    .36:
-      %.37 = load i32, i32* %.3
-
-      %.38 = load i32, i32* %.4
-
-      %.39 = icmp sle i32%.37, %.38
-      br i1 %.39, label %.40, label %.41
-
-    .40:
-      %.42 = load i32, i32* %.3
-
-      %.43 = sub i32 %.42, 1
-      %.44 = sext i32 %.43 to i64
-      %.45 = getelementptr [99 x i32], [99 x i32]* %.1, i64 0, i64 %.44
-      %.46 = load i32, i32* %.45
-      %.47 = load i32, i32* %.2
-
-      %.48 = icmp slt i32%.46, %.47
-      br i1 %.48, label %.49, label %.50
-
-    .49:
-      %.51 = load i32, i32* %.3
-
-      %.52 = sub i32 %.51, 1
-      %.53 = sext i32 %.52 to i64
-      %.54 = getelementptr [99 x i32], [99 x i32]* %.1, i64 0, i64 %.53
-      %.55 = load i32, i32* %.54
-      store i32 %.55, i32* %.2
-      br label %.50
-
-    .50:
-      %.56 = alloca i32
-      store i32 1, i32* %.56
-      %.57 = load i32, i32* %.56
-
-      %.58 = load i32, i32* %.3
-
-      %.59 = add i32 %.58, %.57
-      store i32 %.59, i32* %.3
-      br label %.36
-
-    .41:
-      %.61 = getelementptr [6 x i8], [6 x i8]* @.str.60, i64 0, i64 0
-      call void @write_string(i8* %.61)
-      %.62 = load i32, i32* %.2
+      %a = alloca [100 x i32], align 4
+      %min = alloca i32, align 4
+      %i = alloca i32, align 4
+      %n = alloca i32, align 4
+      %0 = call i32 (i8*, ...) @printf(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @.str.1, i32 0, i32 0), i8* getelementptr inbounds ([19 x i8], [19 x i8]* @.str, i32 0, i32 0))
+      %1 = call i32 (i8*, ...) @__isoc99_scanf(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @.str.2, i32 0, i32 0), i32* %n)
+      store i32 1, i32* %i, align 4
+      br label %while.cond
+
+    while.cond:                                       ; preds = %while.body, %start
+      %i1 = load i32, i32* %i, align 4
+      %n2 = load i32, i32* %n, align 4
+      %2 = icmp sle i32 %i1, %n2
+      br i1 %2, label %while.body, label %while.end
+
+    while.body:                                       ; preds = %while.cond
+      %3 = call i32 (i8*, ...) @printf(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @.str.1, i32 0, i32 0), i8* getelementptr inbounds ([7 x i8], [7 x i8]* @.str.3, i32 0, i32 0))
+      %i3 = load i32, i32* %i, align 4
+      %4 = call i32 (i8*, ...) @printf(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @.str.2, i32 0, i32 0), i32 %i3)
+      %5 = call i32 (i8*, ...) @printf(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @.str.1, i32 0, i32 0), i8* getelementptr inbounds ([11 x i8], [11 x i8]* @.str.4, i32 0, i32 0))
+      %i4 = load i32, i32* %i, align 4
+      %6 = sub i32 %i4, 1
+      %7 = sext i32 %6 to i64
+      %8 = getelementptr [100 x i32], [100 x i32]* %a, i64 0, i64 %7
+      %9 = call i32 (i8*, ...) @__isoc99_scanf(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @.str.2, i32 0, i32 0), i32* %8)
+      %10 = load i32, i32* %i, align 4
+      %11 = add i32 %10, 1
+      store i32 %11, i32* %i, align 4
+      br label %while.cond
+
+    while.end:                                        ; preds = %while.cond
+      %12 = getelementptr [100 x i32], [100 x i32]* %a, i64 0, i64 0
+      %13 = load i32, i32* %12, align 4
+      store i32 %13, i32* %min, align 4
+      store i32 2, i32* %i, align 4
+      br label %while.cond5
+
+    while.cond5:                                      ; preds = %if.end, %while.end
+      %i6 = load i32, i32* %i, align 4
+      %n7 = load i32, i32* %n, align 4
+      %14 = icmp sle i32 %i6, %n7
+      br i1 %14, label %while.body8, label %while.end12
+
+    while.body8:                                      ; preds = %while.cond5
+      %i9 = load i32, i32* %i, align 4
+      %15 = sub i32 %i9, 1
+      %16 = sext i32 %15 to i64
+      %17 = getelementptr [100 x i32], [100 x i32]* %a, i64 0, i64 %16
+      %18 = load i32, i32* %17, align 4
+      %min10 = load i32, i32* %min, align 4
+      %19 = icmp slt i32 %18, %min10
+      br i1 %19, label %if.then, label %if.end
+
+    if.then:                                          ; preds = %while.body8
+      %i11 = load i32, i32* %i, align 4
+      %20 = sub i32 %i11, 1
+      %21 = sext i32 %20 to i64
+      %22 = getelementptr [100 x i32], [100 x i32]* %a, i64 0, i64 %21
+      %23 = load i32, i32* %22, align 4
+      store i32 %23, i32* %min, align 4
+      br label %if.end
+
+    if.end:                                           ; preds = %if.then, %while.body8
+      %24 = load i32, i32* %i, align 4
+      %25 = add i32 %24, 1
+      store i32 %25, i32* %i, align 4
+      br label %while.cond5
+
+    while.end12:                                      ; preds = %while.cond5
+      %26 = call i32 (i8*, ...) @printf(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @.str.1, i32 0, i32 0), i8* getelementptr inbounds ([6 x i8], [6 x i8]* @.str.5, i32 0, i32 0))
+      %min13 = load i32, i32* %min, align 4
+      %27 = call i32 (i8*, ...) @printf(i8* getelementptr inbounds ([4 x i8], [4 x i8]* @.str.6, i32 0, i32 0), i32 %min13)
+      ret i32 0
+    }
 
-      call void @writeln_int(i32 %.62)
+    declare i32 @printf(i8*, ...)
 
-      ret i32 0
-    })"));
+    declare i32 @__isoc99_scanf(i8*, ...))"));
 }
 
-TEST(CodegenSuite, Sort) {
+TEST_P(CodegenSuite, Sort) {
   std::stringstream in(R"(
     {Test BubbleSort program}
     program BubbleSort;
@@ -503,10 +380,7 @@ TEST(CodegenSuite, Sort) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
 
   std::stringstream llvm_ir_str;
@@ -517,281 +391,169 @@ TEST(CodegenSuite, Sort) {
   pascal::code_generate(parse_result.program_, symbol_table, llvm_ir_str);
   EXPECT_TRUE(error_stream.str().empty());
   EXPECT_EQ(llvm_ir_str.str(), dedent(R"(
+    ; ModuleID = 'bubblesort'
+    source_filename = "bubblesort"
     target triple = "x86_64-pc-linux-gnu"
-    declare i32 @printf(i8* %format, ...)
-    declare i32 @__isoc99_scanf(i8*, ...)
 
-    @.str.int = constant [3 x i8] c"%d\00"
-    @.str.char = constant [3 x i8] c"%c\00"
-    @.str.str = constant [3 x i8] c"%s\00"
-
-    define void @read_int(i32* %x) {
-      call i32 (i8*, ...) @__isoc99_scanf(i8* getelementptr  ([3 x i8], [3 x i8]* @.str.int, i64 0, i64 0), i32* %x)
-      ret void
-    }
-
-    define void @write_int(i32 %x) {
-      call i32 (i8*, ...) @printf(i8* getelementptr ([3 x i8], [3 x i8]* @.str.int, i64 0, i64 0), i32 %x)
-      ret void
-    }
-
-    define void @write_char(i32 %x) {
-      call i32 (i8*, ...) @printf(i8* getelementptr ([3 x i8], [3 x i8]* @.str.char, i64 0, i64 0), i32 %x)
-      ret void
-    }
-
-    define void @write_string(i8* %x) {
-      call i32 (i8*, ...) @printf(i8* getelementptr ([3 x i8], [3 x i8]* @.str.str, i64 0, i64 0), i8* %x)
-      ret void
-    }
-
-    @.str.intln = constant [4 x i8] c"%d\0A\00"
-    define void @writeln_int(i32 %x) {
-      call i32 (i8*, ...) @printf(i8* getelementptr ([4 x i8], [4 x i8]* @.str.intln, i64 0, i64 0), i32 %x)
-      ret void
-    }
-
-    @.str.strln = constant [4 x i8] c"%s\0A\00"
-    define void @writeln_string(i8* %x) {
-      call i32 (i8*, ...) @printf(i8* getelementptr ([4 x i8], [4 x i8]* @.str.strln, i64 0, i64 0), i8* %x)
-      ret void
-    }
-
-    @.str.6 = constant [19 x i8] c"Enter array size: \00"
-    @.str.16 = constant [7 x i8] c"Enter \00"
-    @.str.19 = constant [11 x i8] c" element: \00"
-    @.str.96 = constant [14 x i8] c"Sorted array:\00"
+    @.str = private unnamed_addr constant [19 x i8] c"Enter array size: \00", align 1
+    @.str.1 = private unnamed_addr constant [3 x i8] c"%s\00", align 1
+    @.str.2 = private unnamed_addr constant [3 x i8] c"%d\00", align 1
+    @.str.3 = private unnamed_addr constant [7 x i8] c"Enter \00", align 1
+    @.str.4 = private unnamed_addr constant [11 x i8] c" element: \00", align 1
+    @.str.5 = private unnamed_addr constant [14 x i8] c"Sorted array:\00", align 1
+    @.str.6 = private unnamed_addr constant [4 x i8] c"%s\0A\00", align 1
+    @.str.7 = private unnamed_addr constant [3 x i8] c"%c\00", align 1
+    @.str.8 = private unnamed_addr constant [4 x i8] c"%d\0A\00", align 1
 
     define i32 @main() {
     start:
-      %.1 = alloca [99 x i32]
-      %.2 = alloca i32
-      %.3 = alloca i32
-      %.4 = alloca i32
-      %.5 = alloca i32
-
-      %.7 = getelementptr [19 x i8], [19 x i8]* @.str.6, i64 0, i64 0
-      call void @write_string(i8* %.7)
-
-      call void @read_int(i32* %.5)
-
-      %.8 = alloca i32
-      store i32 1, i32* %.8
-      %.9 = load i32, i32* %.8
-
-      store i32 %.9, i32* %.2
-      br label %.10
-
-    .10:
-      %.11 = load i32, i32* %.2
-
-      %.12 = load i32, i32* %.5
-
-      %.13 = icmp sle i32%.11, %.12
-      br i1 %.13, label %.14, label %.15
-
-    .14:
-      %.17 = getelementptr [7 x i8], [7 x i8]* @.str.16, i64 0, i64 0
-      call void @write_string(i8* %.17)
-      %.18 = load i32, i32* %.2
-
-      call void @write_int(i32 %.18)
-      %.20 = getelementptr [11 x i8], [11 x i8]* @.str.19, i64 0, i64 0
-      call void @write_string(i8* %.20)
-
-      %.21 = load i32, i32* %.2
-
-      %.22 = sub i32 %.21, 1
-      %.23 = sext i32 %.22 to i64
-      %.24 = getelementptr [99 x i32], [99 x i32]* %.1, i64 0, i64 %.23
-      call void @read_int(i32* %.24)
-
-      %.25 = alloca i32
-      store i32 1, i32* %.25
-      %.26 = load i32, i32* %.25
-
-      %.27 = load i32, i32* %.2
-
-      %.28 = add i32 %.27, %.26
-      store i32 %.28, i32* %.2
-      br label %.10
-
-    .15:
-      %.29 = alloca i32
-      store i32 1, i32* %.29
-      %.30 = load i32, i32* %.29
-
-      store i32 %.30, i32* %.2
-      br label %.31
-
-    .31:
-      %.32 = load i32, i32* %.2
-
-      %.33 = load i32, i32* %.5
-
-      %.34 = icmp slt i32%.32, %.33
-      br i1 %.34, label %.35, label %.36
-
-    .35:
-      %.37 = alloca i32
-      store i32 1, i32* %.37
-      %.38 = load i32, i32* %.37
-
-      store i32 %.38, i32* %.3
-      br label %.39
-
-    .39:
-      %.40 = load i32, i32* %.3
-
-      %.41 = load i32, i32* %.5
-
-      %.42 = load i32, i32* %.2
-
-      %.43 = sub i32 %.41, %.42
-      %.44 = icmp sle i32%.40, %.43
-      br i1 %.44, label %.45, label %.46
-
-    .45:
-      %.47 = load i32, i32* %.3
-
-      %.48 = sub i32 %.47, 1
-      %.49 = sext i32 %.48 to i64
-      %.50 = getelementptr [99 x i32], [99 x i32]* %.1, i64 0, i64 %.49
-      %.51 = load i32, i32* %.50
-      %.52 = load i32, i32* %.3
-
-      %.53 = alloca i32
-      store i32 1, i32* %.53
-      %.54 = load i32, i32* %.53
-
-      %.55 = add i32 %.52, %.54
-      %.56 = sub i32 %.55, 1
-      %.57 = sext i32 %.56 to i64
-      %.58 = getelementptr [99 x i32], [99 x i32]* %.1, i64 0, i64 %.57
-      %.59 = load i32, i32* %.58
-      %.60 = icmp sgt i32%.51, %.59
-      br i1 %.60, label %.61, label %.62
-
-    .61:
-      %.63 = load i32, i32* %.3
-
-      %.64 = sub i32 %.63, 1
-      %.65 = sext i32 %.64 to i64
-      %.66 = getelementptr [99 x i32], [99 x i32]* %.1, i64 0, i64 %.65
-      %.67 = load i32, i32* %.66
-      store i32 %.67, i32* %.4
-      %.68 = load i32, i32* %.3
-
-      %.69 = alloca i32
-      store i32 1, i32* %.69
-      %.70 = load i32, i32* %.69
-
-      %.71 = add i32 %.68, %.70
-      %.72 = sub i32 %.71, 1
-      %.73 = sext i32 %.72 to i64
-      %.74 = getelementptr [99 x i32], [99 x i32]* %.1, i64 0, i64 %.73
-      %.75 = load i32, i32* %.74
-      %.76 = load i32, i32* %.3
-
-      %.77 = sub i32 %.76, 1
-      %.78 = sext i32 %.77 to i64
-      %.79 = getelementptr [99 x i32], [99 x i32]* %.1, i64 0, i64 %.78
-      store i32 %.75, i32* %.79
-      %.80 = load i32, i32* %.4
-
-      %.81 = load i32, i32* %.3
-
-      %.82 = alloca i32
-      store i32 1, i32* %.82
-      %.83 = load i32, i32* %.82
-
-      %.84 = add i32 %.81, %.83
-      %.85 = sub i32 %.84, 1
-      %.86 = sext i32 %.85 to i64
-      %.87 = getelementptr [99 x i32], [99 x i32]* %.1, i64 0, i64 %.86
-      store i32 %.80, i32* %.87
-      br label %.62
-
-    .62:
-      %.88 = alloca i32
-      store i32 1, i32* %.88
-      %.89 = load i32, i32* %.88
-
-      %.90 = load i32, i32* %.3
-
-      %.91 = add i32 %.90, %.89
-      store i32 %.91, i32* %.3
-      br label %.39
-
-    .46:
-      %.92 = alloca i32
-      store i32 1, i32* %.92
-      %.93 = load i32, i32* %.92
-
-      %.94 = load i32, i32* %.2
-
-      %.95 = add i32 %.94, %.93
-      store i32 %.95, i32* %.2
-      br label %.31
-
-    .36:
-      %.97 = getelementptr [14 x i8], [14 x i8]* @.str.96, i64 0, i64 0
-      call void @writeln_string(i8* %.97)
-
-      %.98 = alloca i32
-      store i32 1, i32* %.98
-      %.99 = load i32, i32* %.98
-
-      store i32 %.99, i32* %.2
-      br label %.100
-
-    .100:
-      %.101 = load i32, i32* %.2
-
-      %.102 = load i32, i32* %.5
-
-      %.103 = icmp slt i32%.101, %.102
-      br i1 %.103, label %.104, label %.105
-
-    .104:
-      %.106 = load i32, i32* %.2
-
-      %.107 = sub i32 %.106, 1
-      %.108 = sext i32 %.107 to i64
-      %.109 = getelementptr [99 x i32], [99 x i32]* %.1, i64 0, i64 %.108
-      %.110 = load i32, i32* %.109
-      call void @write_int(i32 %.110)
-      %.111 = alloca i8
-      store i8 32, i8* %.111
-      %.112 = load i8, i8* %.111
-
-      %.113 = sext i8 %.112 to i32
-      call void @write_char(i32 %.113)
-
-      %.114 = alloca i32
-      store i32 1, i32* %.114
-      %.115 = load i32, i32* %.114
-
-      %.116 = load i32, i32* %.2
-
-      %.117 = add i32 %.116, %.115
-      store i32 %.117, i32* %.2
-      br label %.100
-
-    .105:
-      %.118 = load i32, i32* %.2
+      %arr = alloca [100 x i32], align 4
+      %i = alloca i32, align 4
+      %j = alloca i32, align 4
+      %buf = alloca i32, align 4
+      %n = alloca i32, align 4
+      %0 = call i32 (i8*, ...) @printf(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @.str.1, i32 0, i32 0), i8* getelementptr inbounds ([19 x i8], [19 x i8]* @.str, i32 0, i32 0))
+      %1 = call i32 (i8*, ...) @__isoc99_scanf(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @.str.2, i32 0, i32 0), i32* %n)
+      store i32 1, i32* %i, align 4
+      br label %while.cond
+
+    while.cond:                                       ; preds = %while.body, %start
+      %i1 = load i32, i32* %i, align 4
+      %n2 = load i32, i32* %n, align 4
+      %2 = icmp sle i32 %i1, %n2
+      br i1 %2, label %while.body, label %while.end
+
+    while.body:                                       ; preds = %while.cond
+      %3 = call i32 (i8*, ...) @printf(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @.str.1, i32 0, i32 0), i8* getelementptr inbounds ([7 x i8], [7 x i8]* @.str.3, i32 0, i32 0))
+      %i3 = load i32, i32* %i, align 4
+      %4 = call i32 (i8*, ...) @printf(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @.str.2, i32 0, i32 0), i32 %i3)
+      %5 = call i32 (i8*, ...) @printf(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @.str.1, i32 0, i32 0), i8* getelementptr inbounds ([11 x i8], [11 x i8]* @.str.4, i32 0, i32 0))
+      %i4 = load i32, i32* %i, align 4
+      %6 = sub i32 %i4, 1
+      %7 = sext i32 %6 to i64
+      %8 = getelementptr [100 x i32], [100 x i32]* %arr, i64 0, i64 %7
+      %9 = call i32 (i8*, ...) @__isoc99_scanf(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @.str.2, i32 0, i32 0), i32* %8)
+      %10 = load i32, i32* %i, align 4
+      %11 = add i32 %10, 1
+      store i32 %11, i32* %i, align 4
+      br label %while.cond
+
+    while.end:                                        ; preds = %while.cond
+      store i32 1, i32* %i, align 4
+      br label %while.cond5
+
+    while.cond5:                                      ; preds = %while.end21, %while.end
+      %i6 = load i32, i32* %i, align 4
+      %n7 = load i32, i32* %n, align 4
+      %12 = icmp slt i32 %i6, %n7
+      br i1 %12, label %while.body8, label %while.end22
+
+    while.body8:                                      ; preds = %while.cond5
+      store i32 1, i32* %j, align 4
+      br label %while.cond9
+
+    while.cond9:                                      ; preds = %if.end, %while.body8
+      %j10 = load i32, i32* %j, align 4
+      %n11 = load i32, i32* %n, align 4
+      %i12 = load i32, i32* %i, align 4
+      %13 = sub i32 %n11, %i12
+      %14 = icmp sle i32 %j10, %13
+      br i1 %14, label %while.body13, label %while.end21
+
+    while.body13:                                     ; preds = %while.cond9
+      %j14 = load i32, i32* %j, align 4
+      %15 = sub i32 %j14, 1
+      %16 = sext i32 %15 to i64
+      %17 = getelementptr [100 x i32], [100 x i32]* %arr, i64 0, i64 %16
+      %18 = load i32, i32* %17, align 4
+      %j15 = load i32, i32* %j, align 4
+      %19 = add i32 %j15, 1
+      %20 = sub i32 %19, 1
+      %21 = sext i32 %20 to i64
+      %22 = getelementptr [100 x i32], [100 x i32]* %arr, i64 0, i64 %21
+      %23 = load i32, i32* %22, align 4
+      %24 = icmp sgt i32 %18, %23
+      br i1 %24, label %if.then, label %if.end
+
+    if.then:                                          ; preds = %while.body13
+      %j16 = load i32, i32* %j, align 4
+      %25 = sub i32 %j16, 1
+      %26 = sext i32 %25 to i64
+      %27 = getelementptr [100 x i32], [100 x i32]* %arr, i64 0, i64 %26
+      %28 = load i32, i32* %27, align 4
+      store i32 %28, i32* %buf, align 4
+      %j17 = load i32, i32* %j, align 4
+      %29 = add i32 %j17, 1
+      %30 = sub i32 %29, 1
+      %31 = sext i32 %30 to i64
+      %32 = getelementptr [100 x i32], [100 x i32]* %arr, i64 0, i64 %31
+      %33 = load i32, i32* %32, align 4
+      %j18 = load i32, i32* %j, align 4
+      %34 = sub i32 %j18, 1
+      %35 = sext i32 %34 to i64
+      %36 = getelementptr [100 x i32], [100 x i32]* %arr, i64 0, i64 %35
+      store i32 %33, i32* %36, align 4
+      %buf19 = load i32, i32* %buf, align 4
+      %j20 = load i32, i32* %j, align 4
+      %37 = add i32 %j20, 1
+      %38 = sub i32 %37, 1
+      %39 = sext i32 %38 to i64
+      %40 = getelementptr [100 x i32], [100 x i32]* %arr, i64 0, i64 %39
+      store i32 %buf19, i32* %40, align 4
+      br label %if.end
+
+    if.end:                                           ; preds = %if.then, %while.body13
+      %41 = load i32, i32* %j, align 4
+      %42 = add i32 %41, 1
+      store i32 %42, i32* %j, align 4
+      br label %while.cond9
+
+    while.end21:                                      ; preds = %while.cond9
+      %43 = load i32, i32* %i, align 4
+      %44 = add i32 %43, 1
+      store i32 %44, i32* %i, align 4
+      br label %while.cond5
+
+    while.end22:                                      ; preds = %while.cond5
+      %45 = call i32 (i8*, ...) @printf(i8* getelementptr inbounds ([4 x i8], [4 x i8]* @.str.6, i32 0, i32 0), i8* getelementptr inbounds ([14 x i8], [14 x i8]* @.str.5, i32 0, i32 0))
+      store i32 1, i32* %i, align 4
+      br label %while.cond23
+
+    while.cond23:                                     ; preds = %while.body26, %while.end22
+      %i24 = load i32, i32* %i, align 4
+      %n25 = load i32, i32* %n, align 4
+      %46 = icmp slt i32 %i24, %n25
+      br i1 %46, label %while.body26, label %while.end28
+
+    while.body26:                                     ; preds = %while.cond23
+      %i27 = load i32, i32* %i, align 4
+      %47 = sub i32 %i27, 1
+      %48 = sext i32 %47 to i64
+      %49 = getelementptr [100 x i32], [100 x i32]* %arr, i64 0, i64 %48
+      %50 = load i32, i32* %49, align 4
+      %51 = call i32 (i8*, ...) @printf(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @.str.2, i32 0, i32 0), i32 %50)
+      %52 = call i32 (i8*, ...) @printf(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @.str.7, i32 0, i32 0), i32 32)
+      %53 = load i32, i32* %i, align 4
+      %54 = add i32 %53, 1
+      store i32 %54, i32* %i, align 4
+      br label %while.cond23
+
+    while.end28:                                      ; preds = %while.cond23
+      %i29 = load i32, i32* %i, align 4
+      %55 = sub i32 %i29, 1
+      %56 = sext i32 %55 to i64
+      %57 = getelementptr [100 x i32], [100 x i32]* %arr, i64 0, i64 %56
+      %58 = load i32, i32* %57, align 4
+      %59 = call i32 (i8*, ...) @printf(i8* getelementptr inbounds ([4 x i8], [4 x i8]* @.str.8, i32 0, i32 0), i32 %58)
+      ret i32 0
+    }
 
-      %.119 = sub i32 %.118, 1
-      %.120 = sext i32 %.119 to i64
-      %.121 = getelementptr [99 x i32], [99 x i32]* %.1, i64 0, i64 %.120
-      %.122 = load i32, i32* %.121
-      call void @writeln_int(i32 %.122)
+    declare i32 @printf(i8*, ...)
 
-      ret i32 0
-    })"));
+    declare i32 @__isoc99_scanf(i8*, ...))"));
 }
 
-TEST(CodegenSuite, Hash) {
+TEST_P(CodegenSuite, Hash) {
   std::stringstream in(R"(
     {Test Hash program}
     program Hash;
@@ -808,10 +570,7 @@ TEST(CodegenSuite, Hash) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
 
   std::stringstream llvm_ir_str;
@@ -822,108 +581,52 @@ TEST(CodegenSuite, Hash) {
   pascal::code_generate(parse_result.program_, symbol_table, llvm_ir_str);
   EXPECT_TRUE(error_stream.str().empty());
   EXPECT_EQ(llvm_ir_str.str(), dedent(R"(
+    ; ModuleID = 'hash'
+    source_filename = "hash"
     target triple = "x86_64-pc-linux-gnu"
-    declare i32 @printf(i8* %format, ...)
-    declare i32 @__isoc99_scanf(i8*, ...)
 
-    @.str.int = constant [3 x i8] c"%d\00"
-    @.str.str = constant [3 x i8] c"%s\00"
-
-    define void @read_int(i32* %x) {
-      call i32 (i8*, ...) @__isoc99_scanf(i8* getelementptr  ([3 x i8], [3 x i8]* @.str.int, i64 0, i64 0), i32* %x)
-      ret void
-    }
-
-    define void @write_string(i8* %x) {
-      call i32 (i8*, ...) @printf(i8* getelementptr ([3 x i8], [3 x i8]* @.str.str, i64 0, i64 0), i8* %x)
-      ret void
-    }
-
-    @.str.intln = constant [4 x i8] c"%d\0A\00"
-    define void @writeln_int(i32 %x) {
-      call i32 (i8*, ...) @printf(i8* getelementptr ([4 x i8], [4 x i8]* @.str.intln, i64 0, i64 0), i32 %x)
-      ret void
-    }
-
-    @.str.strln = constant [4 x i8] c"%s\0A\00"
-    define void @writeln_string(i8* %x) {
-      call i32 (i8*, ...) @printf(i8* getelementptr ([4 x i8], [4 x i8]* @.str.strln, i64 0, i64 0), i8* %x)
-      ret void
-    }
-
-    @.str.9 = constant [14 x i8] c"Enter value: \00"
-    @.str.33 = constant [7 x i8] c"Hash: \00"
+    @.str = private unnamed_addr constant [14 x i8] c"Enter value: \00", align 1
+    @.str.1 = private unnamed_addr constant [4 x i8] c"%s\0A\00", align 1
+    @.str.2 = private unnamed_addr constant [3 x i8] c"%d\00", align 1
+    @.str.3 = private unnamed_addr constant [7 x i8] c"Hash: \00", align 1
+    @.str.4 = private unnamed_addr constant [3 x i8] c"%s\00", align 1
+    @.str.5 = private unnamed_addr constant [4 x i8] c"%d\0A\00", align 1
 
     define i32 @main() {
     start:
-      %.1 = alloca i32
-      store i32 42, i32* %.1
-      %.2 = load i32, i32* %.1
-
-      %.3 = alloca i32
-      store i32 %.2, i32* %.3
-      %.4 = alloca i32
-      store i32 10, i32* %.4
-      %.5 = load i32, i32* %.4
-
-      %.6 = alloca i32
-      store i32 %.5, i32* %.6
-      %.7 = alloca i32
-      %.8 = alloca i32
-
-      %.10 = getelementptr [14 x i8], [14 x i8]* @.str.9, i64 0, i64 0
-      call void @writeln_string(i8* %.10)
-
-      call void @read_int(i32* %.7)
-
-      %.11 = load i32, i32* %.3
-
-      %.12 = load i32, i32* %.7
-
-      %.13 = alloca i32
-      store i32 2, i32* %.13
-      %.14 = load i32, i32* %.13
-
-      %.15 = mul i32 %.12, %.14
-      %.16 = load i32, i32* %.3
-
-      %.17 = alloca i32
-      store i32 3, i32* %.17
-      %.18 = load i32, i32* %.17
-
-      %.19 = alloca i32
-      store i32 4, i32* %.19
-      %.20 = load i32, i32* %.19
-
-      %.21 = load i32, i32* %.6
-
-      %.22 = mul i32 %.20, %.21
-      %.23 = add i32 %.18, %.22
-      %.24 = alloca i32
-      store i32 5, i32* %.24
-      %.25 = load i32, i32* %.24
-
-      %.26 = sdiv i32 %.23, %.25
-      %.27 = alloca i32
-      store i32 45, i32* %.27
-      %.28 = load i32, i32* %.27
-
-      %.29 = mul i32 %.16, %.26
-      %.30 = srem i32 %.29, %.28
-      %.31 = sub i32 %.15, %.30
-      %.32 = mul i32 %.11, %.31
-      store i32 %.32, i32* %.8
-      %.34 = getelementptr [7 x i8], [7 x i8]* @.str.33, i64 0, i64 0
-      call void @write_string(i8* %.34)
-      %.35 = load i32, i32* %.8
+      %b = alloca i32, align 4
+      %ten = alloca i32, align 4
+      %a = alloca i32, align 4
+      %res = alloca i32, align 4
+      store i32 42, i32* %b, align 4
+      store i32 10, i32* %ten, align 4
+      %0 = call i32 (i8*, ...) @printf(i8* getelementptr inbounds ([4 x i8], [4 x i8]* @.str.1, i32 0, i32 0), i8* getelementptr inbounds ([14 x i8], [14 x i8]* @.str, i32 0, i32 0))
+      %1 = call i32 (i8*, ...) @__isoc99_scanf(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @.str.2, i32 0, i32 0), i32* %a)
+      %b1 = load i32, i32* %b, align 4
+      %a2 = load i32, i32* %a, align 4
+      %2 = mul i32 %a2, 2
+      %b3 = load i32, i32* %b, align 4
+      %ten4 = load i32, i32* %ten, align 4
+      %3 = mul i32 4, %ten4
+      %4 = add i32 3, %3
+      %5 = sdiv i32 %4, 5
+      %6 = mul i32 %b3, %5
+      %7 = srem i32 %6, 45
+      %8 = sub i32 %2, %7
+      %9 = mul i32 %b1, %8
+      store i32 %9, i32* %res, align 4
+      %10 = call i32 (i8*, ...) @printf(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @.str.4, i32 0, i32 0), i8* getelementptr inbounds ([7 x i8], [7 x i8]* @.str.3, i32 0, i32 0))
+      %res5 = load i32, i32* %res, align 4
+      %11 = call i32 (i8*, ...) @printf(i8* getelementptr inbounds ([4 x i8], [4 x i8]* @.str.5, i32 0, i32 0), i32 %res5)
+      ret i32 0
+    }
 
-      call void @writeln_int(i32 %.35)
+    declare i32 @printf(i8*, ...)
 
-      ret i32 0
-    })"));
+    declare i32 @__isoc99_scanf(i8*, ...))"));
 }
 
-TEST(CodegenSuite, Strings) {
+TEST_P(CodegenSuite, Strings) {
   std::stringstream in(R"(
     {Test Strings program}
     program ArrMin;
@@ -948,10 +651,7 @@ TEST(CodegenSuite, Strings) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
 
   std::stringstream llvm_ir_str;
@@ -962,126 +662,309 @@ TEST(CodegenSuite, Strings) {
   pascal::code_generate(parse_result.program_, symbol_table, llvm_ir_str);
   EXPECT_TRUE(error_stream.str().empty());
   EXPECT_EQ(llvm_ir_str.str(), dedent(R"(
+    ; ModuleID = 'arrmin'
+    source_filename = "arrmin"
     target triple = "x86_64-pc-linux-gnu"
-    declare i32 @printf(i8* %format, ...)
-    declare i32 @__isoc99_scanf(i8*, ...)
-    declare i8* @strcpy(i8* %dst, i8* %src)
-    declare i8* @strcat(i8* %dst, i8* %src)
-
-    @.str.empty = constant [1 x i8] c"\00"
-    define void @strinit([255 x i8]* %str) {
-      %str.ptr = getelementptr [255 x i8], [255 x i8]* %str, i64 0, i64 0
-      call i8* @strcpy(i8* %str.ptr, i8* getelementptr ([1 x i8], [1 x i8]* @.str.empty, i64 0, i64 0))
-      ret void
-    }
 
-    @.str.c = constant [2 x i8] c"*\00"
-    define i8* @tostr(i8 %c, [255 x i8]* %str) {
-      %str.ptr = getelementptr [255 x i8], [255 x i8]* %str, i64 0, i64 0
-      call i8* @strcpy(i8* %str.ptr, i8* getelementptr ([2 x i8], [2 x i8]* @.str.c, i64 0, i64 0))
-      store i8 %c, i8* %str.ptr
-      ret i8* %str.ptr
+    @.str = private unnamed_addr constant [21 x i8] c"Enter first string: \00", align 1
+    @.str.1 = private unnamed_addr constant [4 x i8] c"%s\0A\00", align 1
+    @.str.2 = private unnamed_addr constant [3 x i8] c"%s\00", align 1
+    @.str.3 = private unnamed_addr constant [22 x i8] c"Enter second string: \00", align 1
+    @.str.4 = private unnamed_addr constant [5 x i8] c"abcd\00", align 1
+
+    define i32 @main() {
+    start:
+      %s1 = alloca [255 x i8], align 1
+      %s2 = alloca [255 x i8], align 1
+      %res = alloca [255 x i8], align 1
+      %ch = alloca i8, align 1
+      %chr = alloca [2 x i8], align 1
+      %chr1 = alloca [2 x i8], align 1
+      %0 = getelementptr [255 x i8], [255 x i8]* %s1, i64 0, i64 0
+      store i8 0, i8* %0, align 1
+      %1 = getelementptr [255 x i8], [255 x i8]* %s2, i64 0, i64 0
+      store i8 0, i8* %1, align 1
+      %2 = getelementptr [255 x i8], [255 x i8]* %res, i64 0, i64 0
+      store i8 0, i8* %2, align 1
+      %3 = call i32 (i8*, ...) @printf(i8* getelementptr inbounds ([4 x i8], [4 x i8]* @.str.1, i32 0, i32 0), i8* getelementptr inbounds ([21 x i8], [21 x i8]* @.str, i32 0, i32 0))
+      %4 = getelementptr [255 x i8], [255 x i8]* %s1, i64 0, i64 0
+      %5 = call i32 (i8*, ...) @__isoc99_scanf(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @.str.2, i32 0, i32 0), i8* %4)
+      %6 = call i32 (i8*, ...) @printf(i8* getelementptr inbounds ([4 x i8], [4 x i8]* @.str.1, i32 0, i32 0), i8* getelementptr inbounds ([22 x i8], [22 x i8]* @.str.3, i32 0, i32 0))
+      %7 = getelementptr [255 x i8], [255 x i8]* %s2, i64 0, i64 0
+      %8 = call i32 (i8*, ...) @__isoc99_scanf(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @.str.2, i32 0, i32 0), i8* %7)
+      store i8 88, i8* %ch, align 1
+      %9 = getelementptr [2 x i8], [2 x i8]* %chr, i64 0, i64 0
+      store i8 97, i8* %9, align 1
+      %10 = getelementptr [2 x i8], [2 x i8]* %chr, i64 0, i64 1
+      store i8 0, i8* %10, align 1
+      %11 = getelementptr [255 x i8], [255 x i8]* %res, i64 0, i64 0
+      %12 = call i8* @strcpy(i8* %11, i8* %9)
+      %13 = getelementptr [255 x i8], [255 x i8]* %s1, i64 0, i64 0
+      %14 = getelementptr [255 x i8], [255 x i8]* %res, i64 0, i64 0
+      %15 = call i8* @strcat(i8* %14, i8* %13)
+      %16 = getelementptr [2 x i8], [2 x i8]* %chr1, i64 0, i64 0
+      store i8 32, i8* %16, align 1
+      %17 = getelementptr [2 x i8], [2 x i8]* %chr1, i64 0, i64 1
+      store i8 0, i8* %17, align 1
+      %18 = getelementptr [255 x i8], [255 x i8]* %res, i64 0, i64 0
+      %19 = call i8* @strcat(i8* %18, i8* %16)
+      %20 = getelementptr [255 x i8], [255 x i8]* %s2, i64 0, i64 0
+      %21 = getelementptr [255 x i8], [255 x i8]* %res, i64 0, i64 0
+      %22 = call i8* @strcat(i8* %21, i8* %20)
+      %23 = getelementptr [255 x i8], [255 x i8]* %s1, i64 0, i64 0
+      %24 = getelementptr [255 x i8], [255 x i8]* %res, i64 0, i64 0
+      %25 = call i8* @strcat(i8* %24, i8* %23)
+      %26 = getelementptr [255 x i8], [255 x i8]* %res, i64 0, i64 0
+      %27 = call i32 (i8*, ...) @printf(i8* getelementptr inbounds ([4 x i8], [4 x i8]* @.str.1, i32 0, i32 0), i8* %26)
+      %28 = getelementptr [255 x i8], [255 x i8]* %res, i64 0, i64 0
+      %29 = call i8* @strcpy(i8* %28, i8* getelementptr inbounds ([5 x i8], [5 x i8]* @.str.4, i32 0, i32 0))
+      %ch2 = load i8, i8* %ch, align 1
+      %30 = getelementptr [255 x i8], [255 x i8]* %res, i64 0, i64 2
+      store i8 %ch2, i8* %30, align 1
+      %31 = getelementptr [255 x i8], [255 x i8]* %res, i64 0, i64 0
+      %32 = call i32 (i8*, ...) @printf(i8* getelementptr inbounds ([4 x i8], [4 x i8]* @.str.1, i32 0, i32 0), i8* %31)
+      ret i32 0
     }
 
-    @.str.str = constant [3 x i8] c"%s\00"
+    declare i32 @printf(i8*, ...)
 
-    define void @read_string(i8* %x) {
-      call i32 (i8*, ...) @__isoc99_scanf(i8* getelementptr  ([3 x i8], [3 x i8]* @.str.str, i64 0, i64 0), i8* %x)
-      ret void
-    }
+    declare i32 @__isoc99_scanf(i8*, ...)
 
-    @.str.strln = constant [4 x i8] c"%s\0A\00"
-    define void @writeln_string(i8* %x) {
-      call i32 (i8*, ...) @printf(i8* getelementptr ([4 x i8], [4 x i8]* @.str.strln, i64 0, i64 0), i8* %x)
-      ret void
-    }
+    declare i8* @strcpy(i8*, i8*)
 
-    @.str.5 = constant [21 x i8] c"Enter first string: \00"
-    @.str.8 = constant [22 x i8] c"Enter second string: \00"
-    @.str.30 = constant [5 x i8] c"abcd\00"
+    declare i8* @strcat(i8*, i8*))"));
+}
 
-    define i32 @main() {
-    start:
-      %.1 = alloca [255 x i8]
-      call void @strinit([255 x i8]* %.1)
-      %.2 = alloca [255 x i8]
-      call void @strinit([255 x i8]* %.2)
-      %.3 = alloca [255 x i8]
-      call void @strinit([255 x i8]* %.3)
-      %.4 = alloca i8
+TEST_P(CodegenSuite, Optimize) {
+  std::stringstream in(R"(
+    program Square;
+    var
+        a, b: integer;
+    begin
+        a := 7;
+        b := a * a;
+        writeln(b);
+    end.
+    )");
 
-      %.6 = getelementptr [21 x i8], [21 x i8]* @.str.5, i64 0, i64 0
-      call void @writeln_string(i8* %.6)
+  auto parse_result = parse_with(GetParam(), in.str());
+  EXPECT_TRUE(parse_result.errors_.empty());
 
-      %.7 = getelementptr [255 x i8], [255 x i8]* %.1, i64 0, i64 0
+  std::stringstream error_stream;
+  pascal::ast::SymbolTable symbol_table;
+  EXPECT_TRUE(pascal::semantic_analyse(
+      parse_result.program_, symbol_table, error_stream));
 
-      call void @read_string(i8* %.7)
+  llvm::LLVMContext context;
+  auto module =
+      pascal::code_generate(parse_result.program_, symbol_table, context);
+  EXPECT_TRUE(pascal::optimize(
+      *module, pascal::backend::OptLevel::O2, "", error_stream));
+  EXPECT_TRUE(error_stream.str().empty());
 
-      %.9 = getelementptr [22 x i8], [22 x i8]* @.str.8, i64 0, i64 0
-      call void @writeln_string(i8* %.9)
+  std::stringstream llvm_ir_str;
+  pascal::dump_asm(*module, llvm_ir_str);
+  const auto llvm_ir = llvm_ir_str.str();
+  EXPECT_EQ(llvm_ir.find("alloca"), std::string::npos);
+  EXPECT_NE(llvm_ir.find("i32 49)"), std::string::npos);
+}
 
-      %.10 = getelementptr [255 x i8], [255 x i8]* %.2, i64 0, i64 0
+TEST_P(CodegenSuite, Precedence) {
+  std::stringstream in(R"(
+    program Precedence;
+    var
+        a, b: integer;
+    begin
+        a := 7;
+        b := a - a * 2 + a div 2 mod 3 - 10 mod 4 * a;
+        writeln(b);
+    end.
+    )");
 
-      call void @read_string(i8* %.10)
+  auto parse_result = parse_with(GetParam(), in.str());
+  EXPECT_TRUE(parse_result.errors_.empty());
 
-      %.11 = alloca i8
-      store i8 88, i8* %.11
-      %.12 = load i8, i8* %.11
+  std::stringstream error_stream;
+  pascal::ast::SymbolTable symbol_table;
+  EXPECT_TRUE(pascal::semantic_analyse(
+      parse_result.program_, symbol_table, error_stream));
 
-      store i8 %.12, i8* %.4
-      %.13 = alloca i8
-      store i8 97, i8* %.13
-      %.14 = load i8, i8* %.13
+  llvm::LLVMContext context;
+  auto module =
+      pascal::code_generate(parse_result.program_, symbol_table, context);
+  EXPECT_TRUE(pascal::optimize(
+      *module, pascal::backend::OptLevel::O2, "", error_stream));
+  EXPECT_TRUE(error_stream.str().empty());
 
-      %.15 = alloca [255 x i8]
-      %.16 = call i8* @tostr(i8 %.14, [255 x i8]* %.15)
+  std::stringstream llvm_ir_str;
+  pascal::dump_asm(*module, llvm_ir_str);
+  EXPECT_NE(llvm_ir_str.str().find("i32 -21)"), std::string::npos);
+}
 
-      %.17 = getelementptr [255 x i8], [255 x i8]* %.3, i64 0, i64 0
-      call i8* @strcpy(i8* %.17, i8* %.16)
-      %.18 = getelementptr [255 x i8], [255 x i8]* %.1, i64 0, i64 0
+TEST_P(CodegenSuite, InvalidPassPipeline) {
+  std::stringstream in(R"(
+    program HelloWorld;
+    begin
+        writeln('Hello world!');
+    end.
+    )");
 
-      %.19 = getelementptr [255 x i8], [255 x i8]* %.3, i64 0, i64 0
-      call i8* @strcat(i8* %.19, i8* %.18)
-      %.20 = alloca i8
-      store i8 32, i8* %.20
-      %.21 = load i8, i8* %.20
+  auto parse_result = parse_with(GetParam(), in.str());
+  EXPECT_TRUE(parse_result.errors_.empty());
 
-      %.22 = alloca [255 x i8]
-      %.23 = call i8* @tostr(i8 %.21, [255 x i8]* %.22)
+  std::stringstream error_stream;
+  pascal::ast::SymbolTable symbol_table;
+  EXPECT_TRUE(pascal::semantic_analyse(
+      parse_result.program_, symbol_table, error_stream));
 
-      %.24 = getelementptr [255 x i8], [255 x i8]* %.3, i64 0, i64 0
-      call i8* @strcat(i8* %.24, i8* %.23)
-      %.25 = getelementptr [255 x i8], [255 x i8]* %.2, i64 0, i64 0
+  llvm::LLVMContext context;
+  auto module =
+      pascal::code_generate(parse_result.program_, symbol_table, context);
+  EXPECT_FALSE(pascal::optimize(
+      *module, pascal::backend::OptLevel::O0, "no-such-pass", error_stream));
+  EXPECT_EQ(
+      error_stream.str(),
+      "Error: Invalid pass pipeline 'no-such-pass': "
+      "unknown pass name 'no-such-pass'\n");
+}
 
-      %.26 = getelementptr [255 x i8], [255 x i8]* %.3, i64 0, i64 0
-      call i8* @strcat(i8* %.26, i8* %.25)
-      %.27 = getelementptr [255 x i8], [255 x i8]* %.1, i64 0, i64 0
+TEST_P(CodegenSuite, TargetCpu) {
+  std::stringstream in(R"(
+    program HelloWorld;
+    begin
+        writeln('Hello world!');
+    end.
+    )");
 
-      %.28 = getelementptr [255 x i8], [255 x i8]* %.3, i64 0, i64 0
-      call i8* @strcat(i8* %.28, i8* %.27)
-      %.29 = getelementptr [255 x i8], [255 x i8]* %.3, i64 0, i64 0
+  auto parse_result = parse_with(GetParam(), in.str());
+  EXPECT_TRUE(parse_result.errors_.empty());
 
-      call void @writeln_string(i8* %.29)
+  std::stringstream error_stream;
+  pascal::ast::SymbolTable symbol_table;
+  EXPECT_TRUE(pascal::semantic_analyse(
+      parse_result.program_, symbol_table, error_stream));
 
-      %.31 = getelementptr [5 x i8], [5 x i8]* @.str.30, i64 0, i64 0
-      %.32 = getelementptr [255 x i8], [255 x i8]* %.3, i64 0, i64 0
-      call i8* @strcpy(i8* %.32, i8* %.31)
-      %.33 = load i8, i8* %.4
+  llvm::LLVMContext context;
+  auto module =
+      pascal::code_generate(parse_result.program_, symbol_table, context);
+  for (const auto cpu :
+       {pascal::backend::generic_cpu, pascal::backend::native_cpu}) {
+    std::stringstream object;
+    EXPECT_TRUE(pascal::dump_object(
+        *module, object, error_stream, pascal::backend::OptLevel::O0, cpu));
+    EXPECT_FALSE(object.str().empty());
+  }
+  EXPECT_TRUE(error_stream.str().empty());
 
-      %.34 = alloca i32
-      store i32 3, i32* %.34
-      %.35 = load i32, i32* %.34
+  std::stringstream object;
+  EXPECT_FALSE(pascal::dump_object(
+      *module,
+      object,
+      error_stream,
+      pascal::backend::OptLevel::O0,
+      "no-such-cpu"));
+  EXPECT_EQ(
+      error_stream.str().rfind("Error: Unknown CPU 'no-such-cpu'", 0), 0U);
+}
 
-      %.36 = sub nsw i32 %.35, 1
-      %.37 = sext i32 %.36 to i64
-      %.38 = getelementptr [255 x i8], [255 x i8]* %.3, i64 0, i64 %.37
-      store i8 %.33, i8* %.38
-      %.39 = getelementptr [255 x i8], [255 x i8]* %.3, i64 0, i64 0
+TEST_P(CodegenSuite, FlatAst) {
+  auto examples = 0;
+  for (const auto& entry :
+       std::filesystem::directory_iterator(PASCAL_EXAMPLES_DIR)) {
+    if (entry.path().extension() != ".pas") {
+      continue;
+    }
+    std::ifstream file(entry.path());
+    std::stringstream source;
+    source << file.rdbuf();
+
+    // min.pas calls read, which the grammar does not have.
+    auto parse_result = parse_with(GetParam(), source.str());
+    if (!parse_result.errors_.empty()) {
+      continue;
+    }
+    std::stringstream error_stream;
+    pascal::ast::SymbolTable symbol_table;
+    EXPECT_TRUE(pascal::semantic_analyse(
+        parse_result.program_, symbol_table, error_stream));
+    std::stringstream llvm_ir_str;
+    pascal::code_generate(parse_result.program_, symbol_table, llvm_ir_str);
+
+    auto flat_ast = pascal::ast::FlatAst::flatten(parse_result.program_);
+    pascal::ast::SymbolTable flat_symbol_table;
+    EXPECT_TRUE(
+        pascal::semantic_analyse(flat_ast, flat_symbol_table, error_stream));
+    llvm::LLVMContext context;
+    auto module = pascal::code_generate(flat_ast, flat_symbol_table, context);
+    std::stringstream flat_llvm_ir_str;
+    pascal::dump_asm(*module, flat_llvm_ir_str);
+    EXPECT_TRUE(error_stream.str().empty());
+    EXPECT_EQ(flat_llvm_ir_str.str(), llvm_ir_str.str()) << entry.path();
+    ++examples;
+  }
+  EXPECT_GT(examples, 0);
+}
 
-      call void @writeln_string(i8* %.39)
+TEST_P(CodegenSuite, BinaryAst) {
+  auto examples = 0;
+  for (const auto& entry :
+       std::filesystem::directory_iterator(PASCAL_EXAMPLES_DIR)) {
+    if (entry.path().extension() != ".pas") {
+      continue;
+    }
+    std::ifstream file(entry.path());
+    std::stringstream source;
+    source << file.rdbuf();
 
-      ret i32 0
-    })"));
+    auto parse_result = parse_with(GetParam(), source.str());
+    if (!parse_result.errors_.empty()) {
+      continue;
+    }
+    std::stringstream error_stream;
+    pascal::ast::SymbolTable symbol_table;
+    EXPECT_TRUE(pascal::semantic_analyse(
+        parse_result.program_, symbol_table, error_stream));
+    std::ostringstream bytes;
+    EXPECT_TRUE(pascal::dump_binary_ast(
+        parse_result.program_, &symbol_table, bytes, error_stream));
+    std::stringstream llvm_ir_str;
+    pascal::code_generate(parse_result.program_, symbol_table, llvm_ir_str);
+
+    // Loaded with its types and symbol table, the program is analysed again,
+    // as the driver does, and gives the same module as a tree or flattened.
+    pascal::ast::Program program;
+    std::optional<pascal::ast::SymbolTable> loaded_symbol_table;
+    ASSERT_TRUE(pascal::load_binary_ast(
+        bytes.str(), program, loaded_symbol_table, error_stream));
+    ASSERT_TRUE(loaded_symbol_table.has_value());
+    EXPECT_EQ(loaded_symbol_table->size(), symbol_table.size());
+    pascal::ast::SymbolTable analysed_symbol_table;
+    EXPECT_TRUE(pascal::semantic_analyse(
+        program, analysed_symbol_table, error_stream));
+    auto flat_symbol_table = analysed_symbol_table;
+    std::stringstream loaded_llvm_ir_str;
+    pascal::code_generate(program, analysed_symbol_table, loaded_llvm_ir_str);
+    EXPECT_EQ(loaded_llvm_ir_str.str(), llvm_ir_str.str()) << entry.path();
+
+    llvm::LLVMContext context;
+    auto module = pascal::code_generate(
+        pascal::ast::FlatAst::flatten(program), flat_symbol_table, context);
+    std::stringstream flat_llvm_ir_str;
+    pascal::dump_asm(*module, flat_llvm_ir_str);
+    EXPECT_EQ(flat_llvm_ir_str.str(), llvm_ir_str.str()) << entry.path();
+    EXPECT_TRUE(error_stream.str().empty());
+    ++examples;
+  }
+  EXPECT_GT(examples, 0);
 }
 
+INSTANTIATE_TEST_SUITE_P(
+    FrontEnds,
+    CodegenSuite,
+    testing::Values(
+        FrontEnd::Antlr,
+        FrontEnd::AntlrArena,
+        FrontEnd::Descent),
+    front_end_name);
+
 }  // namespace pascal::test
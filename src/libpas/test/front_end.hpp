@@ -0,0 +1,58 @@
+#pragma once
+
+#include <libpas/compiler.hpp>
+#include <libpas/descent_parser.hpp>
+#include <libpas/input_stream.hpp>
+#include <libpas/token_arena.hpp>
+
+#include <PascalLexer.h>
+#include <antlr4-runtime.h>
+#include <gtest/gtest.h>
+
+#include <ostream>
+#include <string>
+
+namespace pascal::test {
+
+// The parsers the parser, semantic and codegen suites run through.
+// AntlrArena is PascalParser over an ArenaTokenStream.
+enum class FrontEnd { Antlr, AntlrArena, Descent };
+
+inline ParseResult parse_with(FrontEnd front_end, const std::string& text) {
+  if (front_end == FrontEnd::Descent) {
+    DescentParser parser(text);
+    return pascal::parse(parser);
+  }
+  if (front_end == FrontEnd::AntlrArena) {
+    ByteStream input(text);
+    ArenaTokenStream tokens(input);
+    return pascal::parse(tokens);
+  }
+  antlr4::ANTLRInputStream stream(text);
+  PascalLexer lexer(&stream);
+  return pascal::parse(lexer);
+}
+
+inline std::string to_string(FrontEnd front_end) {
+  switch (front_end) {
+    case FrontEnd::Antlr:
+      return "Antlr";
+    case FrontEnd::AntlrArena:
+      return "AntlrArena";
+    case FrontEnd::Descent:
+      return "Descent";
+  }
+  return "";
+}
+
+inline std::string front_end_name(
+    const testing::TestParamInfo<FrontEnd>& info) {
+  return to_string(info.param);
+}
+
+inline void PrintTo(FrontEnd front_end, std::ostream* out) {
+  *out << to_string(front_end);
+}
+
+}  // namespace pascal::test
+
@@ -1,14 +1,61 @@
+#include <libpas/dfa_lexer.hpp>
 #include <libpas/dump_tokens.hpp>
+#include <libpas/input_stream.hpp>
+#include <libpas/scan.hpp>
+#include <libpas/token_arena.hpp>
 
 #include <PascalLexer.h>
 #include <antlr4-runtime.h>
 #include <gtest/gtest.h>
 
+#include <filesystem>
+#include <fstream>
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace pascal::test {
 
+static std::string dump_antlr_tokens(const std::string& text) {
+  std::stringstream out;
+  ByteStream stream(text);
+  dump_tokens(stream, out);
+  return out.str();
+}
+
+static std::string dump_dfa_tokens(
+    const std::string& text,
+    scan::Isa isa = scan::best_isa()) {
+  std::stringstream out;
+  DfaLexer lexer(text, isa);
+  dump_tokens(lexer, out);
+  return out.str();
+}
+
+static std::vector<scan::Isa> supported_isas() {
+  std::vector<scan::Isa> isas;
+  for (const auto isa : {scan::Isa::Scalar, scan::Isa::Sse2, scan::Isa::Avx2}) {
+    if (scan::is_supported(isa)) {
+      isas.push_back(isa);
+    }
+  }
+  return isas;
+}
+
+static std::vector<std::string> read_examples() {
+  std::vector<std::string> sources;
+  for (const auto& entry :
+       std::filesystem::directory_iterator(PASCAL_EXAMPLES_DIR)) {
+    if (entry.path().extension() == ".pas") {
+      std::ifstream file(entry.path());
+      std::stringstream source;
+      source << file.rdbuf();
+      sources.push_back(source.str());
+    }
+  }
+  return sources;
+}
+
 TEST(LexerSuite, IDTest) {
   std::stringstream in;
   std::stringstream out;
@@ -162,4 +209,141 @@ TEST(LexerSuite, KeywordTest3) {
       "Loc=<1:45>\tLCURLY '{'\n");
 }
 
+TEST(LexerSuite, ByteStreamTest) {
+  const std::string text =
+      "program Test;\n"
+      "var a : array[1..3] of integer; s : string;\n"
+      "(* comment *) { comment }\n"
+      "begin a[1] := -2 + 3 div 4; s := 'it''s'; write(s, 'c'); end.";
+  std::stringstream in(text);
+  std::stringstream expected;
+  std::stringstream out;
+
+  antlr4::ANTLRInputStream input_stream(in);
+  PascalLexer lexer(&input_stream);
+  dump_tokens(lexer, expected);
+
+  ByteStream byte_stream(text);
+  dump_tokens(byte_stream, out);
+  EXPECT_EQ(out.str(), expected.str());
+}
+
+TEST(LexerSuite, ByteStreamUtf8Test) {
+  std::stringstream out;
+
+  ByteStream stream("'\xd0\xbf\xd1\x80\xd0\xb8' {\xd0\xbf} x");
+  dump_tokens(stream, out);
+  EXPECT_EQ(
+      out.str(),
+      "Loc=<1:0>\tSTRINGLITERAL ''\xd0\xbf\xd1\x80\xd0\xb8''\n"
+      "Loc=<1:14>\tID 'x'\n");
+}
+
+TEST(LexerSuite, DumpTokensChunksTest) {
+  // Several times the output buffer, through every dump_tokens overload.
+  std::string text;
+  for (size_t i = 0; i < 20000; ++i) {
+    text += "a" + std::to_string(i) + " := 'it''s' + b[" +
+        std::to_string(i % 7) + "];\n";
+  }
+  std::stringstream expected;
+  antlr4::ANTLRInputStream input_stream(text);
+  PascalLexer lexer(&input_stream);
+  dump_tokens(lexer, expected);
+  ASSERT_GT(expected.str().size(), size_t{1} << 20);
+
+  EXPECT_EQ(dump_antlr_tokens(text), expected.str());
+  EXPECT_EQ(dump_dfa_tokens(text), expected.str());
+}
+
+TEST(LexerSuite, DfaLexerTest) {
+  const std::vector<std::string> inputs = {
+      "abc ABC ab_c _abc 123 a123",
+      "(*comment1*) (*comment\n2*) {comment3} {comment\n4}"
+      "comment5} {comment6 comment7*) (*comment8",
+      "0123 4567 'str' 'str2",
+      "Program bEgin enD VAR const integer char string "
+      "of readln write writeln",
+      "+-*div mod if then else := += -= *= = > < <> <= >=",
+      "while do continue array ,:;. )( [] .) (. .. }{",
+      "not and or xor break Div2 continue_ 0009",
+      "(*) (**) (***) (* a *) b *) {} { (* } *)",
+      "'' ''' '''' 'a''b' 'a' '\n' x := 'it''s';\r\n",
+      "'\xd0\xbf\xd1\x80\xd0\xb8' {\xd0\xbf} x \xd0 #!",
+      "x" + std::string(100, ' ') + "\n\t\r\n" + std::string(40, '\n') + "y",
+      "(*" + std::string(70, '*') + "\n)" + std::string(50, ')') + "*) z",
+      "{" + std::string(90, '\n') + "} " + "(*" + std::string(90, 'a'),
+  };
+  for (const auto isa : supported_isas()) {
+    for (const auto& input : inputs) {
+      EXPECT_EQ(dump_dfa_tokens(input, isa), dump_antlr_tokens(input))
+          << input;
+    }
+  }
+}
+
+TEST(LexerSuite, DfaLexerExamplesTest) {
+  const auto sources = read_examples();
+  ASSERT_FALSE(sources.empty());
+  for (const auto& source : sources) {
+    EXPECT_EQ(dump_dfa_tokens(source), dump_antlr_tokens(source));
+  }
+}
+
+TEST(LexerSuite, TokenArenaTest) {
+  const auto sources = read_examples();
+  ASSERT_FALSE(sources.empty());
+  for (const auto& source : sources) {
+    const TokenArena arena(source);
+    DfaLexer lexer(source);
+    ASSERT_GT(arena.size(), size_t{0});
+    for (const auto& token : arena) {
+      const auto expected = lexer.next();
+      EXPECT_EQ(token.type(), expected.type());
+      EXPECT_EQ(token.line_, expected.line_);
+      EXPECT_EQ(token.column_, expected.column_);
+      EXPECT_EQ(arena.text(token), lexer.text(expected));
+      // A view of the source, not a copy.
+      EXPECT_EQ(arena.text(token).data(), source.data() + token.start_);
+    }
+    EXPECT_EQ(arena[arena.size() - 1].type(), antlr4::Token::EOF);
+  }
+}
+
+TEST(LexerSuite, ScannerTest) {
+  // Targets at every offset around the vector widths, and inputs where the
+  // first byte of "*)" ends a block.
+  const auto& reference = scan::scanner(scan::Isa::Scalar);
+  for (const auto isa : supported_isas()) {
+    const auto& scanner = scan::scanner(isa);
+    for (size_t size = 0; size < 80; ++size) {
+      for (size_t target = 0; target <= size; ++target) {
+        std::string input(size, ' ');
+        input.replace(0, target, std::string(target, '\n'));
+        if (target < size) {
+          input[target] = '*';
+        }
+        if (target + 1 < size) {
+          input[target + 1] = ')';
+        }
+        const auto* begin = input.data();
+        const auto* end = input.data() + input.size();
+        EXPECT_EQ(
+            scanner.skip_whitespace_(begin, end),
+            reference.skip_whitespace_(begin, end));
+        EXPECT_EQ(
+            scanner.find_(begin, end, '*'),
+            reference.find_(begin, end, '*'));
+        EXPECT_EQ(
+            scanner.find_comment_end_(begin, end),
+            reference.find_comment_end_(begin, end));
+        const auto lines = scanner.count_lines_(begin, end);
+        const auto expected = reference.count_lines_(begin, end);
+        EXPECT_EQ(lines.count_, expected.count_);
+        EXPECT_EQ(lines.last_, expected.last_);
+      }
+    }
+  }
+}
+
 }  // namespace pascal::test
@@ -1,18 +1,34 @@
+#include <libpas/allocations.hpp>
 #include <libpas/compiler.hpp>
+#include <libpas/descent_parser.hpp>
+#include <libpas/dfa_lexer.hpp>
+#include <libpas/input_stream.hpp>
+#include <libpas/token_arena.hpp>
 
-#include <PascalLexer.h>
-#include <antlr4-runtime.h>
+#include <WarmupCorpus.hpp>
 #include <gtest/gtest.h>
 
+#include "front_end.hpp"
+
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <exception>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <iterator>
+#include <optional>
+#include <random>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 namespace pascal::test {
 
+class ParserSuite : public testing::TestWithParam<FrontEnd> {};
+
 static size_t count_indentation(const std::string& str) {
   const auto it = std::find_if_not(
       str.begin(), str.end(), [](char ch) { return std::isspace(ch); });
@@ -37,7 +53,7 @@ static std::string dedent(const std::string& str) {
   return out.str();
 }
 
-TEST(ParserSuite, ValidProgram) {
+TEST_P(ParserSuite, ValidProgram) {
   std::stringstream in(R"(
     {Test HelloWorld program}
     Program HelloWorld;
@@ -46,10 +62,7 @@ TEST(ParserSuite, ValidProgram) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
 
   std::stringstream ast_str;
@@ -71,7 +84,7 @@ TEST(ParserSuite, ValidProgram) {
     </pascal>)"));
 }
 
-TEST(ParserSuite, ValidProgram2) {
+TEST_P(ParserSuite, ValidProgram2) {
   std::stringstream in(R"(
     {Test HelloWorld program with variables}
     program HelloWorld;
@@ -85,10 +98,7 @@ TEST(ParserSuite, ValidProgram2) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
 
   std::stringstream ast_str;
@@ -152,7 +162,7 @@ TEST(ParserSuite, ValidProgram2) {
     </pascal>)"));
 }
 
-TEST(ParserSuite, ValidProgram3) {
+TEST_P(ParserSuite, ValidProgram3) {
   std::stringstream in(R"(
     {Test HelloWorld program with assignments}
     program HelloWorld;
@@ -170,10 +180,7 @@ TEST(ParserSuite, ValidProgram3) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
 
   std::stringstream ast_str;
@@ -290,7 +297,7 @@ TEST(ParserSuite, ValidProgram3) {
     </pascal>)"));
 }
 
-TEST(ParserSuite, ValidProgram4) {
+TEST_P(ParserSuite, ValidProgram4) {
   std::stringstream in(R"(
     {Test HelloWorld program with while loop}
     program HelloWorld;
@@ -306,10 +313,7 @@ TEST(ParserSuite, ValidProgram4) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
 
   std::stringstream ast_str;
@@ -370,7 +374,7 @@ TEST(ParserSuite, ValidProgram4) {
     </pascal>)"));
 }
 
-TEST(ParserSuite, ValidProgram5) {
+TEST_P(ParserSuite, ValidProgram5) {
   std::stringstream in(R"(
     {Test HelloWorld program with branch}
     program HelloWorld;
@@ -394,10 +398,7 @@ TEST(ParserSuite, ValidProgram5) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
 
   std::stringstream ast_str;
@@ -513,16 +514,14 @@ TEST(ParserSuite, ValidProgram5) {
     </pascal>)"));
 }
 
-TEST(ParserSuite, InvalidProgram) {
+TEST_P(ParserSuite, InvalidProgram) {
   std::stringstream in(R"(
     program HelloWorld;
     begin
         writeln('Hello world!');
     end
     )");
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
 
   EXPECT_FALSE(parse_result.errors_.empty());
 
@@ -531,7 +530,7 @@ TEST(ParserSuite, InvalidProgram) {
   EXPECT_EQ(errors.str(), "6:4 missing '.' at '<EOF>'\n");
 }
 
-TEST(ParserSuite, InvalidProgram2) {
+TEST_P(ParserSuite, InvalidProgram2) {
   std::stringstream in(R"(
     program HelloWorld;
     begin
@@ -539,9 +538,7 @@ TEST(ParserSuite, InvalidProgram2) {
         writeln('Hello world!')
     end.
     )");
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
 
   EXPECT_FALSE(parse_result.errors_.empty());
 
@@ -551,7 +548,7 @@ TEST(ParserSuite, InvalidProgram2) {
       errors.str(), "5:8 mismatched input 'writeln' expecting {'end', ';'}\n");
 }
 
-TEST(ParserSuite, InvalidProgram3) {
+TEST_P(ParserSuite, InvalidProgram3) {
   std::stringstream in(R"(
     program HelloWorld;
     begin
@@ -560,9 +557,7 @@ TEST(ParserSuite, InvalidProgram3) {
     var
        a : integer;
     )");
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
 
   EXPECT_FALSE(parse_result.errors_.empty());
 
@@ -571,7 +566,7 @@ TEST(ParserSuite, InvalidProgram3) {
   EXPECT_EQ(errors.str(), "6:4 mismatched input 'var' expecting '.'\n");
 }
 
-TEST(ParserSuite, InvalidProgram4) {
+TEST_P(ParserSuite, InvalidProgram4) {
   std::stringstream in(R"(
     program HelloWorld;
     const
@@ -580,9 +575,7 @@ TEST(ParserSuite, InvalidProgram4) {
         writeln('Hello world!')
     end
     )");
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
 
   EXPECT_FALSE(parse_result.errors_.empty());
 
@@ -592,7 +585,7 @@ TEST(ParserSuite, InvalidProgram4) {
       errors.str(), "4:21 no viable alternative at input 'consta=(3+2)+;'\n");
 }
 
-TEST(ParserSuite, InvalidProgram5) {
+TEST_P(ParserSuite, InvalidProgram5) {
   std::stringstream in(R"(
     program HelloWorld;
     const
@@ -601,9 +594,7 @@ TEST(ParserSuite, InvalidProgram5) {
         writeln('Hello world!')
     end
     )");
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
 
   EXPECT_FALSE(parse_result.errors_.empty());
 
@@ -613,16 +604,14 @@ TEST(ParserSuite, InvalidProgram5) {
       errors.str(), "5:4 no viable alternative at input 'consta=(3+2)begin'\n");
 }
 
-TEST(ParserSuite, InvalidProgram6) {
+TEST_P(ParserSuite, InvalidProgram6) {
   std::stringstream in(R"(
     program HelloWorld;
     begin
         a[] := 5 + 5;
     end.
     )");
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
 
   EXPECT_FALSE(parse_result.errors_.empty());
 
@@ -634,16 +623,14 @@ TEST(ParserSuite, InvalidProgram6) {
       "expecting {'+', '-', '(', CHARACTER, STRINGLITERAL, INT, ID}\n");
 }
 
-TEST(ParserSuite, InvalidProgram7) {
+TEST_P(ParserSuite, InvalidProgram7) {
   std::stringstream in(R"(
     program HelloWorld;
     begin
         a = 5 + 5;
     end.
     )");
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
 
   EXPECT_FALSE(parse_result.errors_.empty());
 
@@ -652,4 +639,758 @@ TEST(ParserSuite, InvalidProgram7) {
   EXPECT_EQ(errors.str(), "4:10 no viable alternative at input 'a='\n");
 }
 
+TEST(ParserSuite, ByteStreamProgram) {
+  ByteStream stream(R"(
+    program HelloWorld;
+    const
+        greeting = 'Hello world!';
+    begin
+        writeln('Hi');
+    end.
+    )");
+
+  auto parse_result = pascal::parse(stream);
+  EXPECT_TRUE(parse_result.errors_.empty());
+
+  std::stringstream ast_str;
+  pascal::dump_ast(parse_result.program_, ast_str);
+  EXPECT_EQ(ast_str.str(), dedent(R"(
+    <?xml version="1.0"?>
+    <pascal>
+      <progname>
+        <id>helloworld</id>
+      </progname>
+      <constdecl>
+        <constdeclaration>
+          <constname>
+            <id>greeting</id>
+          </constname>
+          <value>
+            <string>Hello world!</string>
+          </value>
+        </constdeclaration>
+      </constdecl>
+      <block>
+        <functioncall>
+          <functionname>writeln</functionname>
+          <argument>
+            <string>Hi</string>
+          </argument>
+        </functioncall>
+      </block>
+    </pascal>)"));
+}
+
+TEST(ParserSuite, ByteStreamInvalidProgram) {
+  ByteStream stream(R"(
+    program HelloWorld;
+    begin
+        writeln('Hello world!');
+    end
+    )");
+  auto parse_result = pascal::parse(stream);
+
+  EXPECT_FALSE(parse_result.errors_.empty());
+
+  std::stringstream errors;
+  pascal::dump_errors(parse_result.errors_, errors);
+  EXPECT_EQ(errors.str(), "6:4 missing '.' at '<EOF>'\n");
+}
+
+static std::string dump_parse_result(ParseResult& result) {
+  std::stringstream out;
+  pascal::dump_errors(result.errors_, out);
+  if (result.errors_.empty()) {
+    pascal::dump_ast(result.program_, out);
+  }
+  return out.str();
+}
+
+TEST(ParserSuite, DfaLexerExamples) {
+  auto examples = 0;
+  for (const auto& entry :
+       std::filesystem::directory_iterator(PASCAL_EXAMPLES_DIR)) {
+    if (entry.path().extension() != ".pas") {
+      continue;
+    }
+    std::ifstream file(entry.path());
+    std::stringstream source;
+    source << file.rdbuf();
+    const auto text = source.str();
+
+    ByteStream antlr_stream(text);
+    auto antlr_result = pascal::parse(antlr_stream);
+    ByteStream dfa_stream(text);
+    DfaTokenSource dfa_lexer(dfa_stream);
+    auto dfa_result = pascal::parse(dfa_lexer);
+
+    EXPECT_EQ(dump_parse_result(dfa_result), dump_parse_result(antlr_result))
+        << entry.path();
+    ++examples;
+  }
+  EXPECT_GT(examples, 0);
+}
+
+TEST(ParserSuite, DfaLexerInvalidProgram) {
+  ByteStream stream(R"(
+    program HelloWorld;
+    begin
+        writeln('Hello world!');
+    end
+    )");
+  DfaTokenSource lexer(stream);
+  auto parse_result = pascal::parse(lexer);
+
+  EXPECT_FALSE(parse_result.errors_.empty());
+
+  std::stringstream errors;
+  pascal::dump_errors(parse_result.errors_, errors);
+  EXPECT_EQ(errors.str(), "6:4 missing '.' at '<EOF>'\n");
+}
+
+TEST(ParserSuite, DfaLexerErrorsMatch) {
+  const std::string text = "program p; var _x : integer; begin x := 'a; end.";
+
+  ByteStream antlr_stream(text);
+  auto antlr_result = pascal::parse(antlr_stream);
+  ByteStream dfa_stream(text);
+  DfaTokenSource dfa_lexer(dfa_stream);
+  auto dfa_result = pascal::parse(dfa_lexer);
+
+  EXPECT_FALSE(dfa_result.errors_.empty());
+  EXPECT_EQ(dump_parse_result(dfa_result), dump_parse_result(antlr_result));
+}
+
+TEST(ParserSuite, ArenaTokensErrorsMatch) {
+  // Errors quote tokens, spans of tokens and the conjured missing ones.
+  const std::vector<std::string> texts = {
+      "program p; var _x : integer; begin x := 'a; end.",
+      "program p; begin x y z := 1; end.",
+      "program p; begin if a then end.",
+      "program p begin writeln(1) end",
+      "program p; var a : array[1..] of integer; begin end.",
+      "",
+  };
+  for (const auto& text : texts) {
+    ByteStream antlr_stream(text);
+    auto antlr_result = pascal::parse(antlr_stream);
+    ByteStream arena_stream(text);
+    ArenaTokenStream tokens(arena_stream);
+    auto arena_result = pascal::parse(tokens);
+
+    EXPECT_FALSE(arena_result.errors_.empty()) << text;
+    EXPECT_EQ(dump_parse_result(arena_result), dump_parse_result(antlr_result))
+        << text;
+  }
+}
+
+TEST(ParserSuite, LlFallback) {
+  auto stats = pascal::parse_stats();
+  ByteStream valid_stream("program p; begin writeln(1 + 2 * 3); end.");
+  auto valid_result = pascal::parse(valid_stream);
+  EXPECT_TRUE(valid_result.errors_.empty());
+  EXPECT_EQ(pascal::parse_stats().parses_, stats.parses_ + 1);
+  EXPECT_EQ(pascal::parse_stats().ll_fallbacks_, stats.ll_fallbacks_);
+
+  // Errors come from the full LL parse, with the usual recovery.
+  stats = pascal::parse_stats();
+  ByteStream invalid_stream("program p; begin writeln(1) end");
+  auto invalid_result = pascal::parse(invalid_stream);
+  std::stringstream errors;
+  pascal::dump_errors(invalid_result.errors_, errors);
+  EXPECT_EQ(errors.str(), "1:31 missing '.' at '<EOF>'\n");
+  EXPECT_EQ(pascal::parse_stats().parses_, stats.parses_ + 1);
+  EXPECT_EQ(pascal::parse_stats().ll_fallbacks_, stats.ll_fallbacks_ + 1);
+}
+
+TEST(ParserSuite, ProgramArena) {
+  const std::string text =
+      "program p; var a: integer; begin a := 1 + 2 * 3; writeln(a); end.";
+  auto parsed = DescentParser(text).parse();
+  ASSERT_TRUE(parsed.has_value());
+  std::stringstream expected;
+  pascal::dump_ast(*parsed, expected);
+  const auto nodes = parsed->node_count();
+  EXPECT_GT(nodes, 0U);
+  EXPECT_EQ(parsed->chunk_count(), 1U);
+
+  auto program = std::move(*parsed);
+  EXPECT_EQ(parsed->node_count(), 0U);
+  EXPECT_EQ(parsed->get_block(), nullptr);
+  EXPECT_EQ(program.node_count(), nodes);
+
+  // Move assignment destroys the nodes it replaces.
+  auto other = DescentParser(text).parse();
+  ASSERT_TRUE(other.has_value());
+  *other = std::move(program);
+  std::stringstream actual;
+  pascal::dump_ast(*other, actual);
+  EXPECT_EQ(actual.str(), expected.str());
+}
+
+TEST(ParserSuite, ExpressionAllocations) {
+  // Expressions hold their operands and signs without a heap allocation of
+  // their own, so the parse allocates only as its arena and its lists grow.
+  std::string text = "program p; var a, b, c: integer; begin\n";
+  for (size_t i = 0; i < 4096; ++i) {
+    text += "a := -a + b * (3 - +c) div - - 2;\n";
+  }
+  text += "end.";
+  DescentParser parser(text);
+  const auto before = pascal::allocation_count();
+  auto parsed = parser.parse();
+  const auto allocations = pascal::allocation_count() - before;
+  ASSERT_TRUE(parsed.has_value());
+  EXPECT_GT(parsed->node_count(), 4096U * 20);
+  EXPECT_LT(allocations, parsed->node_count() / 256);
+}
+
+TEST(ParserSuite, InternedSymbols) {
+  const std::string text =
+      "program p; var Abc: integer; begin abc := ABC + 1; end.";
+  auto parsed = DescentParser(text).parse();
+  ASSERT_TRUE(parsed.has_value());
+  auto* declaration = parsed->get_vardecl()->declarations().front();
+  auto* assignment = static_cast<ast::Assignment*>(
+      parsed->get_block()->components().front());
+  const auto symbol = declaration->varnames().front()->symbol();
+  EXPECT_EQ(assignment->varname()->symbol(), symbol);
+  EXPECT_EQ(assignment->expression()->lhs()->atom()->symbol(), symbol);
+
+  auto& interner = parsed->symbols();
+  EXPECT_EQ(interner.text(symbol), "abc");
+  EXPECT_EQ(interner.intern_lowercase("aBC"), symbol);
+  EXPECT_EQ(
+      assignment->expression()->rhs()->atom()->symbol(),
+      interner.intern("1"));
+  EXPECT_EQ(assignment->modification()->symbol(), ast::Interner::fixed(":="));
+
+  // Each program has its own symbols, past the fixed ones that all share.
+  const auto fixed = ast::Interner::global().size();
+  EXPECT_GE(symbol, fixed);
+  auto other = DescentParser("program q; begin end.").parse();
+  ASSERT_TRUE(other.has_value());
+  EXPECT_EQ(other->symbols().size(), fixed + 1);
+  EXPECT_EQ(other->symbols().text(fixed), "q");
+  EXPECT_EQ(ast::Interner::global().size(), fixed);
+  EXPECT_THROW(ast::Interner::fixed("abc"), std::logic_error);
+
+  // Ids and their strings stay valid as the interner grows new chunks.
+  std::vector<ast::SymbolId> ids;
+  for (int i = 0; i < 5000; ++i) {
+    ids.push_back(interner.intern("interned" + std::to_string(i)));
+  }
+  for (int i = 0; i < 5000; ++i) {
+    EXPECT_EQ(interner.text(ids[i]), "interned" + std::to_string(i));
+  }
+  EXPECT_EQ(interner.intern("interned0"), ids[0]);
+}
+
+TEST(ParserSuite, FlatAst) {
+  const std::string text =
+      "program p; var a: integer; begin a := (1 + 2) * -a; end.";
+  auto parsed = DescentParser(text).parse();
+  ASSERT_TRUE(parsed.has_value());
+  const auto ast = ast::FlatAst::flatten(*parsed);
+
+  using ast::Kind;
+  // a := (1 + 2) * -a is Binary(Brackets(Binary(1, +, 2)), *, Atom(-, a)).
+  const std::vector<Kind> kinds = {
+      Kind::Program, Kind::Header, Kind::Id, Kind::Vardecl, Kind::Declaration,
+      Kind::Id, Kind::Simpletype, Kind::Block, Kind::Assignment, Kind::Id,
+      Kind::Modification, Kind::Binary, Kind::Brackets, Kind::Binary,
+      Kind::Atom, Kind::Int, Kind::Operation, Kind::Atom, Kind::Int,
+      Kind::Operation, Kind::Atom, Kind::Operation, Kind::Id};
+  ASSERT_EQ(ast.size(), kinds.size());
+  EXPECT_EQ(ast.size(), parsed->node_count() + 1);
+  for (ast::NodeId node = 0; node < ast.size(); ++node) {
+    EXPECT_EQ(ast.kind(node), kinds[node]) << node;
+    // Pre-order: the first child follows its parent.
+    const auto children = ast.children(node);
+    if (children.size() > 0) {
+      EXPECT_EQ(children[0], node + 1) << node;
+    }
+  }
+  EXPECT_EQ(ast.text(2), "p");
+  EXPECT_EQ(ast.text(6), "integer");
+
+  EXPECT_EQ(ast.child(8, 2), 11u);
+  EXPECT_EQ(ast.children(11).size(), 3u);
+  EXPECT_EQ(ast.text(ast.child(11, 1)), "*");
+  EXPECT_EQ(ast.child(11, 2), 20u);
+  EXPECT_EQ(ast.text(ast.children(20).back()), "a");
+}
+
+TEST(ParserSuite, BinaryAst) {
+  const std::string text =
+      "program p; const n = 10; var a: integer; s: array [1..10] of char; "
+      "begin a := (1 + 2) * -a; s[a] := 'x'; writeln(s[2], 'ab'); "
+      "while a > 0 do begin a -= 1; if a = 3 then readln(a) else a := 1; "
+      "end; end.";
+  auto parsed = DescentParser(text).parse();
+  ASSERT_TRUE(parsed.has_value());
+  std::ostringstream bytes;
+  ast::BinaryAst::write(*parsed, nullptr, bytes);
+  const auto written = bytes.str();
+  ASSERT_TRUE(ast::BinaryAst::is_binary_ast(written));
+  EXPECT_FALSE(ast::BinaryAst::is_binary_ast(text));
+
+  const ast::BinaryAst binary_ast(written);
+  EXPECT_FALSE(binary_ast.analysed());
+  EXPECT_EQ(binary_ast.node_count(), parsed->node_count() + 1);
+  auto loaded = binary_ast.program();
+  EXPECT_TRUE(binary_ast.symbol_table(loaded).empty());
+  std::ostringstream xml;
+  std::ostringstream loaded_xml;
+  dump_ast(*parsed, xml);
+  dump_ast(loaded, loaded_xml);
+  EXPECT_EQ(loaded_xml.str(), xml.str());
+
+  // A copy that is not 8-byte aligned is read as well.
+  std::string unaligned = " " + written;
+  const ast::BinaryAst shifted(std::string_view(unaligned).substr(1));
+  EXPECT_EQ(shifted.node_count(), binary_ast.node_count());
+
+  const auto rejects = [](const std::string& bytes) {
+    std::optional<ast::SymbolTable> symbol_table;
+    ast::Program program;
+    std::ostringstream errors;
+    EXPECT_FALSE(load_binary_ast(bytes, program, symbol_table, errors));
+    return errors.str();
+  };
+  EXPECT_EQ(rejects(text), "Error: Not a binary AST\n");
+  EXPECT_EQ(
+      rejects(written.substr(0, written.size() - 8)),
+      "Error: Invalid binary AST: its size does not match its header\n");
+  // The version follows the 8-byte magic number.
+  auto version = written;
+  version[8] = 2;
+  EXPECT_EQ(rejects(version), "Error: Binary AST version 2 is not supported\n");
+  // The kinds follow the 40-byte header: make the Header a Block.
+  auto kinds = written;
+  kinds[41] = static_cast<char>(ast::Kind::Block);
+  EXPECT_EQ(rejects(kinds), "Error: Invalid binary AST: unexpected node 1\n");
+  // The children follow the kinds, types, symbols and child offsets, each
+  // padded to 8 bytes: make the Header the Program's second child as well.
+  uint32_t nodes = 0;
+  std::memcpy(&nodes, written.data() + 20, sizeof(nodes));
+  const auto padded = [](size_t size) { return (size + 7) & ~size_t{7}; };
+  const auto children = 40 + 2 * padded(nodes) + padded(4 * nodes) +
+      padded(4 * (size_t{nodes} + 1));
+  auto shared = written;
+  std::memcpy(&shared[children + 4], &shared[children], sizeof(uint32_t));
+  EXPECT_EQ(
+      rejects(shared),
+      "Error: Invalid binary AST: node 0 is not in pre-order\n");
+
+  // Operators and numbers must be ones the parsers accept. The strings are
+  // at the end of the file.
+  auto division =
+      DescentParser("program p; var a: integer; begin a := a div 12; end.")
+          .parse();
+  ASSERT_TRUE(division.has_value());
+  std::ostringstream operations;
+  ast::BinaryAst::write(*division, nullptr, operations);
+  const auto misspelt = [&operations](std::string_view from, const char* to) {
+    auto bytes = operations.str();
+    bytes.replace(bytes.rfind(from), from.size(), to);
+    return bytes;
+  };
+  const std::string unexpected = "Error: Invalid binary AST: unexpected node";
+  EXPECT_EQ(rejects(misspelt("div", "dvi")).rfind(unexpected, 0), 0U);
+  EXPECT_EQ(rejects(misspelt("12", "1x")).rfind(unexpected, 0), 0U);
+
+  // Nesting is limited, since loading recurses once per level, and only
+  // programs that load again are written. `a + a + ...` groups to the left,
+  // so each term nests one level deeper, under Program, Block and
+  // Assignment.
+  const auto sum = [](size_t terms) {
+    std::string text = "program p; var a: integer; begin a := a";
+    for (size_t i = 1; i < terms; ++i) {
+      text += " + a";
+    }
+    auto parsed = DescentParser(text + "; end.").parse();
+    EXPECT_TRUE(parsed.has_value());
+    return std::move(*parsed);
+  };
+  auto deepest = sum(ast::BinaryAst::max_depth - 3);
+  std::ostringstream deepest_bytes;
+  std::ostringstream errors;
+  ASSERT_TRUE(dump_binary_ast(deepest, nullptr, deepest_bytes, errors));
+  auto deepest_loaded = ast::BinaryAst(deepest_bytes.str()).program();
+  std::ostringstream deepest_xml;
+  std::ostringstream deepest_loaded_xml;
+  dump_ast(deepest, deepest_xml);
+  dump_ast(deepest_loaded, deepest_loaded_xml);
+  EXPECT_EQ(deepest_loaded_xml.str(), deepest_xml.str());
+
+  auto deeper = sum(ast::BinaryAst::max_depth - 2);
+  std::ostringstream deeper_bytes;
+  EXPECT_FALSE(dump_binary_ast(deeper, nullptr, deeper_bytes, errors));
+  EXPECT_TRUE(deeper_bytes.str().empty());
+  EXPECT_EQ(
+      errors.str(),
+      "Error: Binary AST: the program is nested deeper than 1024 levels\n");
+
+  // A file nested deeper is still rejected: a chain of nodes, each the only
+  // child of the one before, after the header `written` starts with.
+  const uint32_t chain = ast::BinaryAst::max_depth + 2;
+  auto crafted = written.substr(0, 40);
+  const auto set = [&crafted](size_t offset, uint32_t value) {
+    std::memcpy(&crafted[offset], &value, sizeof(value));
+  };
+  set(20, chain);
+  set(24, chain - 1);
+  set(28, 1);
+  set(32, 0);
+  set(36, 0);
+  const auto append = [&crafted, &padded](const void* data, size_t size) {
+    crafted.append(static_cast<const char*>(data), size);
+    crafted.append(padded(size) - size, '\0');
+  };
+  const std::vector<uint8_t> kinds_and_types(chain);
+  append(kinds_and_types.data(), chain);
+  append(kinds_and_types.data(), chain);
+  const std::vector<uint32_t> symbols(chain);
+  append(symbols.data(), sizeof(uint32_t) * chain);
+  std::vector<uint32_t> first_child(chain + 1, chain - 1);
+  std::vector<ast::NodeId> chained(chain - 1);
+  for (uint32_t i = 0; i + 1 < chain; ++i) {
+    first_child[i] = i;
+    chained[i] = i + 1;
+  }
+  append(first_child.data(), sizeof(uint32_t) * first_child.size());
+  append(chained.data(), sizeof(ast::NodeId) * chained.size());
+  const uint32_t string_end = 0;
+  append(&string_end, sizeof(string_end));
+  EXPECT_EQ(
+      rejects(crafted),
+      "Error: Invalid binary AST: nested deeper than 1024\n");
+}
+
+TEST(ParserSuite, ProfileParser) {
+  const std::string text =
+      "program p; var a: integer; begin a := 1 + 2 * 3; writeln(a); end.";
+  ByteStream plain_stream(text);
+  auto plain_result = pascal::parse(plain_stream);
+
+  ParserProfile profile;
+  ByteStream profiled_stream(text);
+  PascalLexer lexer(&profiled_stream);
+  antlr4::CommonTokenStream tokens(&lexer);
+  auto profiled_result = pascal::parse(tokens, profile);
+  EXPECT_TRUE(profiled_result.errors_.empty());
+  EXPECT_EQ(
+      dump_parse_result(profiled_result), dump_parse_result(plain_result));
+
+  ASSERT_FALSE(profile.empty());
+  uint64_t invocations = 0;
+  for (size_t i = 0; i < profile.size(); ++i) {
+    if (profile[i].invocations_ > 0) {
+      EXPECT_EQ(profile[i].decision_, i);
+      EXPECT_FALSE(profile[i].rule_.empty());
+    }
+    invocations += profile[i].invocations_;
+  }
+  EXPECT_GT(invocations, 0U);
+
+  std::stringstream table;
+  pascal::dump_parser_profile(profile, table);
+  std::string header;
+  std::getline(table, header);
+  EXPECT_EQ(header.find("Decision"), 0U);
+  EXPECT_NE(header.find("Ambiguities"), std::string::npos);
+}
+
+TEST(ParserSuite, PreloadParser) {
+  const auto& corpus = grammar::warmup_corpus();
+  ASSERT_FALSE(corpus.empty());
+  EXPECT_EQ(corpus.front().name_, "warmup.pas");
+  for (const auto& source : corpus) {
+    ByteStream input(source.text_);
+    EXPECT_TRUE(pascal::parse(input).errors_.empty()) << source.name_;
+  }
+
+  // The corpus is parsed once, and without falling back to full LL, which
+  // would leave the SLL states it needs out of the DFA caches.
+  const auto stats = pascal::parse_stats();
+  pascal::preload_parser();
+  pascal::preload_parser();
+  EXPECT_EQ(pascal::parse_stats().parses_, stats.parses_ + corpus.size());
+  EXPECT_EQ(pascal::parse_stats().ll_fallbacks_, stats.ll_fallbacks_);
+}
+
+static std::string dump_descent_result(const std::string& text) {
+  DescentParser parser(text);
+  auto result = pascal::parse(parser);
+  return dump_parse_result(result);
+}
+
+TEST(ParserSuite, DescentExamples) {
+  auto examples = 0;
+  for (const auto& entry :
+       std::filesystem::directory_iterator(PASCAL_EXAMPLES_DIR)) {
+    if (entry.path().extension() != ".pas") {
+      continue;
+    }
+    std::ifstream file(entry.path());
+    std::stringstream source;
+    source << file.rdbuf();
+    const auto text = source.str();
+
+    ByteStream antlr_stream(text);
+    auto antlr_result = pascal::parse(antlr_stream);
+    EXPECT_EQ(dump_descent_result(text), dump_parse_result(antlr_result))
+        << entry.path();
+    ++examples;
+  }
+  EXPECT_GT(examples, 0);
+}
+
+TEST(ParserSuite, DescentAmbiguities) {
+  // Conditions with an empty booloperation, conditions in parentheses and
+  // calls whose arguments are also variables.
+  const std::vector<std::string> statements = {
+      "if a - b - c then a := 1",
+      "if a - -b then a := 1",
+      "if a * b - c + d then a := 1",
+      "if a - (b) c then a := 1",
+      "if a b - c then a := 1",
+      "if a (b) then a := 1",
+      "while (a) - b do a := 1",
+      "while (a -b) do a := 1",
+      "while (a -b) c do a := 1",
+      "while ((a) (b)) do a := 1",
+      "while (a < b) do a := 1",
+      "while (a) < (b) do a := 1",
+      "if a = b then if a < b then a := 1 else a := 2",
+      "writeln(a, b[1], c(.1.))",
+      "writeln(a, b[1] + 1)",
+      "readln(a[b[1]])",
+      "writeln(-a)",
+  };
+  for (const auto& statement : statements) {
+    const auto text = "program p; begin " + statement + "; end.";
+    ByteStream antlr_stream(text);
+    auto antlr_result = pascal::parse(antlr_stream);
+    EXPECT_TRUE(antlr_result.errors_.empty()) << statement;
+    EXPECT_TRUE(DescentParser(text).parse().has_value()) << statement;
+    EXPECT_EQ(dump_descent_result(text), dump_parse_result(antlr_result))
+        << statement;
+  }
+}
+
+// Random programs that lean on the choices DescentParser makes by
+// lookahead: conditions with an empty booloperation or in parentheses,
+// signs after operations and call arguments that are also variables. They
+// are all syntactically valid.
+class ProgramGenerator {
+ public:
+  explicit ProgramGenerator(uint32_t seed) : random_(seed) {}
+
+  std::string program() {
+    std::string text = "program p;";
+    if (chance(2)) {
+      text += " const c = " + expression(2) + ";";
+    }
+    if (chance(2)) {
+      text += " var a, b: integer; s: array [1..3] of char;";
+    }
+    return text + " " + block(3) + ".";
+  }
+
+ private:
+  bool chance(uint32_t n) { return random_() % n == 0; }
+
+  template <size_t Size>
+  std::string pick(const char* const (&items)[Size]) {
+    return items[random_() % Size];
+  }
+
+  std::string id() { return pick({"a", "b", "B", "x"}); }
+
+  std::string cell(int depth) {
+    if (chance(4)) {
+      return id() + "(." + expression(depth - 1) + ".)";
+    }
+    return id() + "[" + expression(depth - 1) + "]";
+  }
+
+  std::string variable(int depth) {
+    return depth > 0 && chance(3) ? cell(depth) : id();
+  }
+
+  std::string value(int depth) {
+    switch (random_() % 5) {
+      case 0:
+        return std::to_string(random_() % 10);
+      case 1:
+        return pick({"'q'", "'str'"});
+      default:
+        return variable(depth);
+    }
+  }
+
+  std::string primary(int depth) {
+    if (depth > 0 && chance(4)) {
+      return "(" + expression(depth - 1) + ")";
+    }
+    std::string signs;
+    while (chance(4)) {
+      signs += pick({"+", "-"});
+    }
+    return signs + value(depth);
+  }
+
+  std::string expression(int depth) {
+    auto text = primary(depth);
+    while (chance(2)) {
+      text += " " + pick({"+", "-", "-", "*", "div", "mod"}) + " " +
+          primary(depth);
+    }
+    return text;
+  }
+
+  std::string condition(int depth) {
+    const auto text = expression(depth) + " " +
+        pick({"", "", "=", "<>", "<", ">", "<=", ">="}) + " " +
+        expression(depth);
+    return chance(3) ? "(" + text + ")" : text;
+  }
+
+  std::string block(int depth) {
+    const auto count = depth > 0 ? random_() % 4 : 0;
+    std::string text = "begin";
+    for (uint32_t i = 0; i < count; ++i) {
+      text += " " + statement(depth - 1) + (i + 1 < count ? ";" : "");
+    }
+    if (count > 1 || (count == 1 && chance(2))) {
+      text += ";";
+    }
+    return text + " end";
+  }
+
+  std::string statement(int depth) {
+    switch (random_() % 5) {
+      case 0:
+        return block(depth);
+      case 1: {
+        const auto variables = chance(2);
+        const auto argument = [&] {
+          return variables ? variable(depth) : expression(depth);
+        };
+        auto text = pick({"writeln", "write", "readln"}) + "(" + argument();
+        while (chance(2)) {
+          text += ", " + argument();
+        }
+        return text + ")";
+      }
+      case 2:
+        return variable(depth) + " " + pick({":=", "+=", "-=", "*="}) + " " +
+            expression(depth);
+      case 3:
+        return "while " + condition(depth) + " do " + statement(depth - 1);
+      default:
+        return "if " + condition(depth) + " then " + statement(depth - 1) +
+            (chance(2) ? " else " + statement(depth - 1) : "");
+    }
+  }
+
+  std::mt19937 random_;
+};
+
+// Signs a token, puts it in parentheses, deletes or duplicates it, or swaps
+// it with the next one, once or twice. Signs and parentheses keep many
+// programs valid but change what DescentParser has to decide.
+static std::string mutate(
+    const std::vector<std::string>& tokens,
+    std::mt19937& random) {
+  auto mutated = tokens;
+  for (auto edits = random() % 2 + 1; edits > 0 && mutated.size() > 1;
+       --edits) {
+    const auto i = random() % (mutated.size() - 1);
+    switch (random() % 6) {
+      case 0:
+      case 1:
+        mutated.insert(mutated.begin() + i, random() % 2 == 0 ? "-" : "+");
+        break;
+      case 2:
+        mutated.insert(mutated.begin() + i + 1, ")");
+        mutated.insert(mutated.begin() + i, "(");
+        break;
+      case 3:
+        mutated.erase(mutated.begin() + i);
+        break;
+      case 4:
+        mutated.insert(mutated.begin() + i, mutated[i]);
+        break;
+      default:
+        std::swap(mutated[i], mutated[i + 1]);
+        break;
+    }
+  }
+  std::string text;
+  for (const auto& token : mutated) {
+    text += token + " ";
+  }
+  return text;
+}
+
+TEST(ParserSuite, DescentDifferential) {
+  // parse(DescentParser&) falls back to ANTLR only when DescentParser
+  // rejects a program, so every program it accepts must be one ANTLR
+  // accepts too, with the same AST.
+  size_t accepted = 0;
+  const auto check = [&accepted](const std::string& text) {
+    auto program = DescentParser(text).parse();
+    if (!program) {
+      return;
+    }
+    ++accepted;
+    auto descent_result = ParseResult::program(std::move(*program));
+    ByteStream antlr_stream(text);
+    auto antlr_result = pascal::parse(antlr_stream);
+    EXPECT_EQ(
+        dump_parse_result(descent_result), dump_parse_result(antlr_result))
+        << text;
+  };
+
+  ProgramGenerator generator(1);
+  for (auto i = 0; i < 2000; ++i) {
+    check(generator.program());
+  }
+  EXPECT_GT(accepted, 1000U);
+
+  std::mt19937 random(1);
+  for (const auto& source : grammar::warmup_corpus()) {
+    DfaLexer lexer(source.text_);
+    std::vector<std::string> tokens;
+    for (auto token = lexer.next(); token.type() != antlr4::Token::EOF;
+         token = lexer.next()) {
+      tokens.emplace_back(lexer.text(token));
+    }
+    for (auto i = 0; i < 200; ++i) {
+      check(mutate(tokens, random));
+    }
+  }
+}
+
+TEST(ParserSuite, DescentTrailingTokens) {
+  // The grammar has no EOF, so ANTLR ignores anything after the dot.
+  const std::string text = "program p; begin end. begin";
+  ByteStream antlr_stream(text);
+  auto antlr_result = pascal::parse(antlr_stream);
+  EXPECT_TRUE(antlr_result.errors_.empty());
+  EXPECT_EQ(dump_descent_result(text), dump_parse_result(antlr_result));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    FrontEnds,
+    ParserSuite,
+    testing::Values(
+        FrontEnd::Antlr,
+        FrontEnd::AntlrArena,
+        FrontEnd::Descent),
+    front_end_name);
+
 }  // namespace pascal::test
@@ -1,15 +1,18 @@
 #include <libpas/compiler.hpp>
 
-#include <PascalLexer.h>
-#include <antlr4-runtime.h>
 #include <gtest/gtest.h>
 
+#include "front_end.hpp"
+
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace pascal::test {
 
-TEST(SemanticSuite, ValidProgram) {
+class SemanticSuite : public testing::TestWithParam<FrontEnd> {};
+
+TEST_P(SemanticSuite, ValidProgram) {
   std::stringstream in(R"(
     {Test Helloworld program}
     Program HelloWorld;
@@ -18,10 +21,7 @@ TEST(SemanticSuite, ValidProgram) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
   std::stringstream error_stream;
   pascal::ast::SymbolTable symbol_table;
@@ -30,7 +30,7 @@ TEST(SemanticSuite, ValidProgram) {
   EXPECT_TRUE(error_stream.str().empty());
 }
 
-TEST(SemanticSuite, ValidProgram2) {
+TEST_P(SemanticSuite, ValidProgram2) {
   std::stringstream in(R"(
     {Test ArrMin program}
     program ArrMin;
@@ -58,10 +58,7 @@ TEST(SemanticSuite, ValidProgram2) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
   std::stringstream error_stream;
   pascal::ast::SymbolTable symbol_table;
@@ -70,7 +67,7 @@ TEST(SemanticSuite, ValidProgram2) {
   EXPECT_TRUE(error_stream.str().empty());
 }
 
-TEST(SemanticSuite, ValidProgram3) {
+TEST_P(SemanticSuite, ValidProgram3) {
   std::stringstream in(R"(
     {Test GCD program}
     program GCD;
@@ -95,10 +92,7 @@ TEST(SemanticSuite, ValidProgram3) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
   std::stringstream error_stream;
   pascal::ast::SymbolTable symbol_table;
@@ -107,7 +101,7 @@ TEST(SemanticSuite, ValidProgram3) {
   EXPECT_TRUE(error_stream.str().empty());
 }
 
-TEST(SemanticSuite, InvalidProgram) {
+TEST_P(SemanticSuite, InvalidProgram) {
   std::stringstream in(R"(
     program TEST;
     const
@@ -117,10 +111,7 @@ TEST(SemanticSuite, InvalidProgram) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
   std::stringstream error_stream;
   pascal::ast::SymbolTable symbol_table;
@@ -131,7 +122,7 @@ TEST(SemanticSuite, InvalidProgram) {
       "Error: Repeat declaration of const identifier 'a'\n");
 }
 
-TEST(SemanticSuite, InvalidProgram2) {
+TEST_P(SemanticSuite, InvalidProgram2) {
   std::stringstream in(R"(
     program TEST;
     var
@@ -141,10 +132,7 @@ TEST(SemanticSuite, InvalidProgram2) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
   std::stringstream error_stream;
   pascal::ast::SymbolTable symbol_table;
@@ -154,7 +142,7 @@ TEST(SemanticSuite, InvalidProgram2) {
       error_stream.str(), "Error: Repeat declaration of identifier 'a'\n");
 }
 
-TEST(SemanticSuite, InvalidProgram3) {
+TEST_P(SemanticSuite, InvalidProgram3) {
   std::stringstream in(R"(
     program TEST;
     const
@@ -164,10 +152,7 @@ TEST(SemanticSuite, InvalidProgram3) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
   std::stringstream error_stream;
   pascal::ast::SymbolTable symbol_table;
@@ -177,7 +162,7 @@ TEST(SemanticSuite, InvalidProgram3) {
       error_stream.str(), "Error: Cannot assign new value to constant 'a'\n");
 }
 
-TEST(SemanticSuite, InvalidProgram4) {
+TEST_P(SemanticSuite, InvalidProgram4) {
   std::stringstream in(R"(
     program TEST;
     var
@@ -187,10 +172,7 @@ TEST(SemanticSuite, InvalidProgram4) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
   std::stringstream error_stream;
   pascal::ast::SymbolTable symbol_table;
@@ -201,7 +183,7 @@ TEST(SemanticSuite, InvalidProgram4) {
       "Error: Incompatible operation for string expression\n");
 }
 
-TEST(SemanticSuite, InvalidProgram5) {
+TEST_P(SemanticSuite, InvalidProgram5) {
   std::stringstream in(R"(
     program TEST;
     var
@@ -211,10 +193,7 @@ TEST(SemanticSuite, InvalidProgram5) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
   std::stringstream error_stream;
   pascal::ast::SymbolTable symbol_table;
@@ -225,7 +204,7 @@ TEST(SemanticSuite, InvalidProgram5) {
       "Error: Incompatible operation for char expression\n");
 }
 
-TEST(SemanticSuite, InvalidProgram6) {
+TEST_P(SemanticSuite, InvalidProgram6) {
   std::stringstream in(R"(
     program TEST;
     var
@@ -235,10 +214,7 @@ TEST(SemanticSuite, InvalidProgram6) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
   std::stringstream error_stream;
   pascal::ast::SymbolTable symbol_table;
@@ -249,7 +225,7 @@ TEST(SemanticSuite, InvalidProgram6) {
       "Error: Incompatible operation for char expression\n");
 }
 
-TEST(SemanticSuite, ValidProgram4) {
+TEST_P(SemanticSuite, ValidProgram4) {
   std::stringstream in(R"(
     program TEST;
     var
@@ -261,10 +237,7 @@ TEST(SemanticSuite, ValidProgram4) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
   std::stringstream error_stream;
   pascal::ast::SymbolTable symbol_table;
@@ -273,7 +246,7 @@ TEST(SemanticSuite, ValidProgram4) {
   EXPECT_TRUE(error_stream.str().empty());
 }
 
-TEST(SemanticSuite, InvalidProgram7) {
+TEST_P(SemanticSuite, InvalidProgram7) {
   std::stringstream in(R"(
     program TEST;
     var
@@ -283,10 +256,7 @@ TEST(SemanticSuite, InvalidProgram7) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
   std::stringstream error_stream;
   pascal::ast::SymbolTable symbol_table;
@@ -297,7 +267,7 @@ TEST(SemanticSuite, InvalidProgram7) {
       "Error: Incompatible operation for char expression\n");
 }
 
-TEST(SemanticSuite, InvalidProgram8) {
+TEST_P(SemanticSuite, InvalidProgram8) {
   std::stringstream in(R"(
     program TEST;
     var
@@ -307,10 +277,7 @@ TEST(SemanticSuite, InvalidProgram8) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
   std::stringstream error_stream;
   pascal::ast::SymbolTable symbol_table;
@@ -322,7 +289,7 @@ TEST(SemanticSuite, InvalidProgram8) {
       "arguments\n");
 }
 
-TEST(SemanticSuite, InvalidProgram9) {
+TEST_P(SemanticSuite, InvalidProgram9) {
   std::stringstream in(R"(
     program TEST;
     begin
@@ -330,10 +297,7 @@ TEST(SemanticSuite, InvalidProgram9) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
   std::stringstream error_stream;
   pascal::ast::SymbolTable symbol_table;
@@ -342,7 +306,7 @@ TEST(SemanticSuite, InvalidProgram9) {
   EXPECT_EQ(error_stream.str(), "Error: Unknown identifier 'a'\n");
 }
 
-TEST(SemanticSuite, InvalidProgram10) {
+TEST_P(SemanticSuite, InvalidProgram10) {
   std::stringstream in(R"(
     program TEST;
     const
@@ -352,10 +316,7 @@ TEST(SemanticSuite, InvalidProgram10) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
   std::stringstream error_stream;
   pascal::ast::SymbolTable symbol_table;
@@ -365,7 +326,7 @@ TEST(SemanticSuite, InvalidProgram10) {
       error_stream.str(), "Error: Cannot assign new value to constant 'a'\n");
 }
 
-TEST(SemanticSuite, InvalidProgram11) {
+TEST_P(SemanticSuite, InvalidProgram11) {
   std::stringstream in(R"(
     program TEST;
     const
@@ -374,10 +335,7 @@ TEST(SemanticSuite, InvalidProgram11) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
   std::stringstream error_stream;
   pascal::ast::SymbolTable symbol_table;
@@ -387,7 +345,7 @@ TEST(SemanticSuite, InvalidProgram11) {
       error_stream.str(), "Error: Only integer expression can be signed\n");
 }
 
-TEST(SemanticSuite, InvalidProgram12) {
+TEST_P(SemanticSuite, InvalidProgram12) {
   std::stringstream in(R"(
     program TEST;
     var
@@ -398,10 +356,7 @@ TEST(SemanticSuite, InvalidProgram12) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
   std::stringstream error_stream;
   pascal::ast::SymbolTable symbol_table;
@@ -412,7 +367,7 @@ TEST(SemanticSuite, InvalidProgram12) {
       "Error: Incompatible operands types for expression\n");
 }
 
-TEST(SemanticSuite, InvalidProgram13) {
+TEST_P(SemanticSuite, InvalidProgram13) {
   std::stringstream in(R"(
     program TEST;
     var
@@ -423,10 +378,7 @@ TEST(SemanticSuite, InvalidProgram13) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
   std::stringstream error_stream;
   pascal::ast::SymbolTable symbol_table;
@@ -437,7 +389,7 @@ TEST(SemanticSuite, InvalidProgram13) {
       "Error: Incompatible operands types for expression\n");
 }
 
-TEST(SemanticSuite, InvalidProgram14) {
+TEST_P(SemanticSuite, InvalidProgram14) {
   std::stringstream in(R"(
     program TEST;
     var
@@ -448,10 +400,7 @@ TEST(SemanticSuite, InvalidProgram14) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
   std::stringstream error_stream;
   pascal::ast::SymbolTable symbol_table;
@@ -462,7 +411,7 @@ TEST(SemanticSuite, InvalidProgram14) {
       "Error: Incompatible operands types for expression\n");
 }
 
-TEST(SemanticSuite, InvalidProgram15) {
+TEST_P(SemanticSuite, InvalidProgram15) {
   std::stringstream in(R"(
     program TEST;
     var
@@ -472,10 +421,7 @@ TEST(SemanticSuite, InvalidProgram15) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
   std::stringstream error_stream;
   pascal::ast::SymbolTable symbol_table;
@@ -486,7 +432,7 @@ TEST(SemanticSuite, InvalidProgram15) {
       "Error: Incompatible operation for string expression\n");
 }
 
-TEST(SemanticSuite, InvalidProgram16) {
+TEST_P(SemanticSuite, InvalidProgram16) {
   std::stringstream in(R"(
     program TEST;
     var
@@ -496,10 +442,7 @@ TEST(SemanticSuite, InvalidProgram16) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
   std::stringstream error_stream;
   pascal::ast::SymbolTable symbol_table;
@@ -510,7 +453,7 @@ TEST(SemanticSuite, InvalidProgram16) {
       "Error: Incompatible operation for char expression\n");
 }
 
-TEST(SemanticSuite, InvalidProgram17) {
+TEST_P(SemanticSuite, InvalidProgram17) {
   std::stringstream in(R"(
     program TEST;
     begin
@@ -519,10 +462,7 @@ TEST(SemanticSuite, InvalidProgram17) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
   std::stringstream error_stream;
   pascal::ast::SymbolTable symbol_table;
@@ -533,7 +473,7 @@ TEST(SemanticSuite, InvalidProgram17) {
       "Error: Different types of boolean expression operands\n");
 }
 
-TEST(SemanticSuite, InvalidProgram18) {
+TEST_P(SemanticSuite, InvalidProgram18) {
   std::stringstream in(R"(
     program TEST;
     begin
@@ -542,10 +482,7 @@ TEST(SemanticSuite, InvalidProgram18) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
   std::stringstream error_stream;
   pascal::ast::SymbolTable symbol_table;
@@ -556,7 +493,7 @@ TEST(SemanticSuite, InvalidProgram18) {
       "Error: Different types of boolean expression operands\n");
 }
 
-TEST(SemanticSuite, InvalidProgram19) {
+TEST_P(SemanticSuite, InvalidProgram19) {
   std::stringstream in(R"(
     program TEST;
     begin
@@ -564,10 +501,7 @@ TEST(SemanticSuite, InvalidProgram19) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
   std::stringstream error_stream;
   pascal::ast::SymbolTable symbol_table;
@@ -577,7 +511,7 @@ TEST(SemanticSuite, InvalidProgram19) {
       error_stream.str(), "Error: Unknown identifier 'a' in array name\n");
 }
 
-TEST(SemanticSuite, InvalidProgram20) {
+TEST_P(SemanticSuite, InvalidProgram20) {
   std::stringstream in(R"(
     program TEST;
     var
@@ -587,10 +521,7 @@ TEST(SemanticSuite, InvalidProgram20) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
   std::stringstream error_stream;
   pascal::ast::SymbolTable symbol_table;
@@ -601,7 +532,7 @@ TEST(SemanticSuite, InvalidProgram20) {
       "Error: Identifier 'a' is not an array or string name\n");
 }
 
-TEST(SemanticSuite, InvalidProgram21) {
+TEST_P(SemanticSuite, InvalidProgram21) {
   std::stringstream in(R"(
     program TEST;
     var
@@ -611,10 +542,7 @@ TEST(SemanticSuite, InvalidProgram21) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
   std::stringstream error_stream;
   pascal::ast::SymbolTable symbol_table;
@@ -623,7 +551,7 @@ TEST(SemanticSuite, InvalidProgram21) {
   EXPECT_EQ(error_stream.str(), "Error: Invalid index type of 'a'\n");
 }
 
-TEST(SemanticSuite, InvalidProgram22) {
+TEST_P(SemanticSuite, InvalidProgram22) {
   std::stringstream in(R"(
     program TEST;
     var
@@ -633,10 +561,7 @@ TEST(SemanticSuite, InvalidProgram22) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
   std::stringstream error_stream;
   pascal::ast::SymbolTable symbol_table;
@@ -645,7 +570,7 @@ TEST(SemanticSuite, InvalidProgram22) {
   EXPECT_EQ(error_stream.str(), "Error: Unknown identifier 'b'\n");
 }
 
-TEST(SemanticSuite, InvalidProgram23) {
+TEST_P(SemanticSuite, InvalidProgram23) {
   std::stringstream in(R"(
     program TEST;
     var
@@ -656,10 +581,7 @@ TEST(SemanticSuite, InvalidProgram23) {
     end.
     )");
 
-  antlr4::ANTLRInputStream stream(in);
-  PascalLexer lexer(&stream);
-
-  auto parse_result = pascal::parse(lexer);
+  auto parse_result = parse_with(GetParam(), in.str());
   EXPECT_TRUE(parse_result.errors_.empty());
   std::stringstream error_stream;
   pascal::ast::SymbolTable symbol_table;
@@ -668,4 +590,68 @@ TEST(SemanticSuite, InvalidProgram23) {
   EXPECT_EQ(error_stream.str(), "Error: Identifier 'b' is an array name\n");
 }
 
+TEST_P(SemanticSuite, FlatAst) {
+  const std::string declarations =
+      "program p; const c = 1; var i : integer; s : string; ch : char; "
+      "arr : array[1..10] of integer; begin ";
+  // A program per check, then programs with two errors, where the first
+  // one found has to be the same.
+  const std::vector<std::string> statements = {
+      "x := 1",
+      "c := 2",
+      "s -= 'ab'",
+      "ch += 'a'",
+      "i := 'a'",
+      "readln(i + 1)",
+      "readln(c)",
+      "i := -ch",
+      "i := ch + 1",
+      "i := 1 + ch",
+      "if i = 'a' then i := 1",
+      "i := x[1]",
+      "i := i[1]",
+      "i := arr['a']",
+      "i := arr",
+      "i := p",
+      "c := 'a'",
+      "i := x + y",
+      "while i < 1 do s := i; i := 'a'",
+      "writeln(i, ch, s); readln(arr[1], s, ch); i := 'a'",
+  };
+  std::vector<std::string> programs = {
+      "program p; const c = 1; c = 2; begin end.",
+      "program p; var a, a : integer; begin end.",
+      "program p; var a : array[1..2] of string; begin end.",
+      "program p; const c = x; var c : integer; begin end.",
+  };
+  for (const auto& statement : statements) {
+    programs.push_back(declarations + statement + "; end.");
+  }
+
+  for (const auto& text : programs) {
+    auto parse_result = parse_with(GetParam(), text);
+    EXPECT_TRUE(parse_result.errors_.empty()) << text;
+    std::stringstream error_stream;
+    pascal::ast::SymbolTable symbol_table;
+    EXPECT_FALSE(pascal::semantic_analyse(
+        parse_result.program_, symbol_table, error_stream));
+
+    auto flat_ast = pascal::ast::FlatAst::flatten(parse_result.program_);
+    std::stringstream flat_error_stream;
+    pascal::ast::SymbolTable flat_symbol_table;
+    EXPECT_FALSE(pascal::semantic_analyse(
+        flat_ast, flat_symbol_table, flat_error_stream));
+    EXPECT_EQ(flat_error_stream.str(), error_stream.str()) << text;
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    FrontEnds,
+    SemanticSuite,
+    testing::Values(
+        FrontEnd::Antlr,
+        FrontEnd::AntlrArena,
+        FrontEnd::Descent),
+    front_end_name);
+
 }  // namespace pascal::test
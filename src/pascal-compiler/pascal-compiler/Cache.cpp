@@ -0,0 +1,241 @@
+#include <pascal-compiler/Cache.hpp>
+
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Support/SHA256.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+namespace pascal::driver {
+
+namespace {
+
+constexpr std::string_view entry_magic = "PASCACHE";
+constexpr uint32_t entry_version = 1;
+const char* const stats_file = "stats";
+const char* const entry_extension = ".entry";
+
+class Hasher {
+ public:
+  void add(std::string_view data) {
+    add_size(data.size());
+    sha_.update(llvm::StringRef(data.data(), data.size()));
+  }
+  void add(uint64_t value) { add_size(value); }
+  std::string hex() { return llvm::toHex(sha_.final(), /*LowerCase=*/true); }
+
+ private:
+  void add_size(uint64_t value) {
+    std::array<uint8_t, sizeof(value)> bytes{};
+    std::memcpy(bytes.data(), &value, sizeof(value));
+    sha_.update(bytes);
+  }
+
+  llvm::SHA256 sha_;
+};
+
+// Identifies this build of the compiler, so that rebuilding it invalidates
+// the entries even when the version number stays the same.
+void add_compiler_identity(Hasher& hasher) {
+  hasher.add("pascal-compiler " PASCAL_COMPILER_VERSION);
+  hasher.add("LLVM " LLVM_VERSION_STRING);
+  std::error_code ec;
+  const std::filesystem::path executable("/proc/self/exe");
+  hasher.add(static_cast<uint64_t>(std::filesystem::file_size(executable, ec)));
+  const auto modified = std::filesystem::last_write_time(executable, ec);
+  hasher.add(static_cast<uint64_t>(modified.time_since_epoch().count()));
+  // --mcpu=native builds for the host CPU.
+  hasher.add(llvm::sys::getProcessTriple());
+  hasher.add(llvm::sys::getHostCPUName().str());
+}
+
+void put(std::string& buffer, uint64_t value) {
+  buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void put(std::string& buffer, const std::string& value) {
+  put(buffer, static_cast<uint64_t>(value.size()));
+  buffer.append(value);
+}
+
+bool get(std::string_view& buffer, uint64_t& value) {
+  if (buffer.size() < sizeof(value)) {
+    return false;
+  }
+  std::memcpy(&value, buffer.data(), sizeof(value));
+  buffer.remove_prefix(sizeof(value));
+  return true;
+}
+
+bool get(std::string_view& buffer, std::string& value) {
+  uint64_t size = 0;
+  if (!get(buffer, size) || buffer.size() < size) {
+    return false;
+  }
+  value.assign(buffer.data(), size);
+  buffer.remove_prefix(size);
+  return true;
+}
+
+std::string serialize(const CacheEntry& entry) {
+  std::string buffer(entry_magic);
+  put(buffer, entry_version);
+  put(buffer, static_cast<uint64_t>(static_cast<uint32_t>(entry.exit_code_)));
+  put(buffer, entry.out_);
+  put(buffer, entry.err_);
+  put(buffer, entry.module_);
+  put(buffer, entry.artifact_);
+  return buffer;
+}
+
+std::optional<CacheEntry> deserialize(std::string_view buffer) {
+  if (buffer.substr(0, entry_magic.size()) != entry_magic) {
+    return std::nullopt;
+  }
+  buffer.remove_prefix(entry_magic.size());
+
+  uint64_t version = 0;
+  uint64_t exit_code = 0;
+  CacheEntry entry;
+  if (!get(buffer, version) || version != entry_version ||
+      !get(buffer, exit_code) || !get(buffer, entry.out_) ||
+      !get(buffer, entry.err_) || !get(buffer, entry.module_) ||
+      !get(buffer, entry.artifact_) || !buffer.empty()) {
+    return std::nullopt;
+  }
+  entry.exit_code_ = static_cast<int>(static_cast<uint32_t>(exit_code));
+  return entry;
+}
+
+std::optional<std::string> read_file(const std::filesystem::path& path) {
+  std::ifstream input(path, std::ios::binary);
+  if (!input) {
+    return std::nullopt;
+  }
+  return std::string(
+      std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+}
+
+}  // namespace
+
+Cache::Cache(std::filesystem::path directory)
+    : directory_(std::move(directory)) {
+  // The cache is an optimization: if the directory is unusable, lookups
+  // miss and stores are dropped.
+  std::error_code ignored;
+  std::filesystem::create_directories(directory_, ignored);
+}
+
+std::string Cache::key(std::string_view source, const Options& options) {
+  Hasher hasher;
+  add_compiler_identity(hasher);
+  hasher.add(static_cast<uint64_t>(options.dump_tokens_));
+  hasher.add(static_cast<uint64_t>(options.dump_ast_));
+  hasher.add(static_cast<uint64_t>(options.output_kind_));
+  hasher.add(static_cast<uint64_t>(options.run_));
+  hasher.add(static_cast<uint64_t>(options.dfa_lexer_));
+  hasher.add(static_cast<uint64_t>(options.descent_parser_));
+  hasher.add(static_cast<uint64_t>(options.flat_ast_));
+  hasher.add(static_cast<uint64_t>(options.opt_level_));
+  hasher.add(options.passes_);
+  hasher.add(options.cpu_);
+  hasher.add(source);
+  return hasher.hex();
+}
+
+std::optional<CacheEntry> Cache::lookup(const std::string& key) {
+  const auto path = entry_path(key);
+  std::optional<CacheEntry> entry;
+  if (const auto buffer = read_file(path)) {
+    entry = deserialize(*buffer);
+    if (!entry) {
+      std::error_code ignored;
+      std::filesystem::remove(path, ignored);
+    }
+  }
+  count(entry.has_value());
+  return entry;
+}
+
+void Cache::store(const std::string& key, const CacheEntry& entry) {
+  const auto path = entry_path(key);
+  std::error_code ec;
+  std::filesystem::create_directories(path.parent_path(), ec);
+
+  int fd = -1;
+  llvm::SmallString<128> temporary;
+  if (llvm::sys::fs::createUniqueFile(
+          path.string() + ".%%%%%%%%.tmp", fd, temporary)) {
+    return;
+  }
+  {
+    llvm::raw_fd_ostream output(fd, /*shouldClose=*/true);
+    output << serialize(entry);
+  }
+  std::filesystem::rename(temporary.str().str(), path, ec);
+  if (ec) {
+    std::filesystem::remove(temporary.str().str(), ec);
+  }
+}
+
+CacheStats Cache::stats() const {
+  CacheStats stats;
+  if (const auto counters = read_file(directory_ / stats_file)) {
+    std::istringstream(*counters) >> stats.hits_ >> stats.misses_;
+  }
+
+  std::error_code ec;
+  for (const auto& file :
+       std::filesystem::recursive_directory_iterator(directory_, ec)) {
+    if (file.is_regular_file(ec) &&
+        file.path().extension() == entry_extension) {
+      ++stats.entries_;
+      stats.bytes_ += file.file_size(ec);
+    }
+  }
+  return stats;
+}
+
+std::filesystem::path Cache::entry_path(const std::string& key) const {
+  // Two-level layout keeps directories small with many entries.
+  return directory_ / key.substr(0, 2) / (key.substr(2) + entry_extension);
+}
+
+void Cache::count(bool hit) {
+  const auto path = directory_ / stats_file;
+  const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return;
+  }
+  // The lock serializes updates from other threads and processes; it is
+  // released when the descriptor is closed.
+  if (::flock(fd, LOCK_EX) == 0) {
+    std::array<char, 64> buffer{};
+    const auto size = ::pread(fd, buffer.data(), buffer.size() - 1, 0);
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    if (size > 0) {
+      std::istringstream(buffer.data()) >> hits >> misses;
+    }
+    ++(hit ? hits : misses);
+    const auto counters = std::to_string(hits) + " " + std::to_string(misses);
+    if (::ftruncate(fd, 0) == 0) {
+      [[maybe_unused]] const auto written =
+          ::pwrite(fd, counters.data(), counters.size(), 0);
+    }
+  }
+  ::close(fd);
+}
+
+}  // namespace pascal::driver
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <pascal-compiler/driver.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace pascal::driver {
+
+// Everything needed to answer a compile request without running a phase.
+struct CacheEntry {
+  int exit_code_ = 0;
+  // What the front end printed: dumps, diagnostics.
+  std::string out_;
+  std::string err_;
+  // Optimized module as LLVM bitcode; empty when no module was produced.
+  std::string module_;
+  // Backend output: the executable, LLVM IR text, bitcode or object file.
+  std::string artifact_;
+};
+
+struct CacheStats {
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+  uint64_t entries_ = 0;
+  uint64_t bytes_ = 0;
+};
+
+// Content-addressed store of compile results in a directory. Entries are
+// written to a temporary file and renamed into place, so concurrent
+// compilers (-j, the server, several processes) may share one directory.
+class Cache {
+ public:
+  explicit Cache(std::filesystem::path directory);
+
+  // Hash of the compiler build, the host, the options that affect the
+  // result and the source bytes.
+  static std::string key(std::string_view source, const Options& options);
+
+  // Counts a hit or a miss in the directory's statistics.
+  std::optional<CacheEntry> lookup(const std::string& key);
+  void store(const std::string& key, const CacheEntry& entry);
+
+  CacheStats stats() const;
+
+ private:
+  std::filesystem::path entry_path(const std::string& key) const;
+  void count(bool hit);
+
+  std::filesystem::path directory_;
+};
+
+}  // namespace pascal::driver
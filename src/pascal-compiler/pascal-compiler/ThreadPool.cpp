@@ -0,0 +1,87 @@
+#include <pascal-compiler/ThreadPool.hpp>
+
+#include <algorithm>
+
+namespace pascal::driver {
+
+ThreadPool::ThreadPool(size_t threads) {
+  threads = std::max<size_t>(threads, 1);
+  queues_.reserve(threads);
+  for (size_t i = 0; i < threads; ++i) {
+    queues_.push_back(std::make_unique<Queue>());
+  }
+  threads_.reserve(threads);
+  for (size_t i = 0; i < threads; ++i) {
+    threads_.emplace_back([this, i] { work(i); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    const std::lock_guard lock(mutex_);
+    stop_ = true;
+  }
+  wakeup_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void ThreadPool::push(Task task) {
+  // The counter goes up before the task is visible so that a worker which
+  // takes it right away never sees pending_ drop below zero.
+  {
+    const std::lock_guard lock(mutex_);
+    ++pending_;
+  }
+  auto& queue = *queues_[next_queue_++ % queues_.size()];
+  {
+    const std::lock_guard lock(queue.mutex_);
+    queue.tasks_.push_back(std::move(task));
+  }
+  wakeup_.notify_one();
+}
+
+bool ThreadPool::pop(size_t index, Task& task) {
+  {
+    auto& own = *queues_[index];
+    const std::lock_guard lock(own.mutex_);
+    if (!own.tasks_.empty()) {
+      task = std::move(own.tasks_.back());
+      own.tasks_.pop_back();
+      return true;
+    }
+  }
+  for (size_t i = 1; i < queues_.size(); ++i) {
+    auto& victim = *queues_[(index + i) % queues_.size()];
+    const std::lock_guard lock(victim.mutex_);
+    if (!victim.tasks_.empty()) {
+      task = std::move(victim.tasks_.front());
+      victim.tasks_.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::work(size_t index) {
+  while (true) {
+    Task task;
+    if (pop(index, task)) {
+      {
+        const std::lock_guard lock(mutex_);
+        --pending_;
+      }
+      task();
+      continue;
+    }
+
+    std::unique_lock lock(mutex_);
+    wakeup_.wait(lock, [this] { return stop_ || pending_ > 0; });
+    if (stop_ && pending_ == 0) {
+      return;
+    }
+  }
+}
+
+}  // namespace pascal::driver
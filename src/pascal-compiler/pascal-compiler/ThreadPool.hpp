@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace pascal::driver {
+
+// Fixed-size pool where every worker owns a deque: it takes its own work
+// from the back and steals from the front of the others when it runs dry.
+class ThreadPool {
+ public:
+  explicit ThreadPool(size_t threads);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  template <class F>
+  std::future<std::invoke_result_t<F>> submit(F function) {
+    using Result = std::invoke_result_t<F>;
+    auto task =
+        std::make_shared<std::packaged_task<Result()>>(std::move(function));
+    auto future = task->get_future();
+    push([task] { (*task)(); });
+    return future;
+  }
+
+ private:
+  using Task = std::function<void()>;
+
+  struct Queue {
+    std::mutex mutex_;
+    std::deque<Task> tasks_;
+  };
+
+  void push(Task task);
+  bool pop(size_t index, Task& task);
+  void work(size_t index);
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> threads_;
+  std::atomic<size_t> next_queue_{0};
+
+  std::mutex mutex_;
+  std::condition_variable wakeup_;
+  size_t pending_ = 0;
+  bool stop_ = false;
+};
+
+}  // namespace pascal::driver
@@ -0,0 +1,118 @@
+#include <pascal-compiler/TimeReport.hpp>
+
+#include <libpas/allocations.hpp>
+
+#include <time.h>
+
+#include <iomanip>
+#include <ostream>
+
+namespace pascal::driver {
+
+namespace {
+
+using Milliseconds = std::chrono::duration<double, std::milli>;
+
+std::chrono::nanoseconds thread_cpu_time() {
+  timespec time{};
+  ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+  return std::chrono::seconds(time.tv_sec) +
+      std::chrono::nanoseconds(time.tv_nsec);
+}
+
+std::string escape_json(std::string_view text) {
+  std::string escaped;
+  escaped.reserve(text.size());
+  for (const auto ch : text) {
+    switch (ch) {
+      case '"':
+        escaped += "\\\"";
+        break;
+      case '\\':
+        escaped += "\\\\";
+        break;
+      case '\n':
+        escaped += "\\n";
+        break;
+      default:
+        escaped += ch;
+        break;
+    }
+  }
+  return escaped;
+}
+
+}  // namespace
+
+TimeReport::Phase::Phase(TimeReport* report, std::string_view name)
+    : report_(report),
+      name_(name),
+      wall_start_(std::chrono::steady_clock::now()),
+      cpu_start_(thread_cpu_time()),
+      allocations_start_(allocation_count()) {}
+
+TimeReport::Phase::~Phase() {
+  if (report_ == nullptr) {
+    return;
+  }
+  report_->records_.push_back(Record{
+      std::string(name_),
+      std::chrono::steady_clock::now() - wall_start_,
+      thread_cpu_time() - cpu_start_,
+      allocation_count() - allocations_start_});
+}
+
+void TimeReport::dump(
+    std::ostream& out,
+    TimeReportFormat format,
+    std::string_view file_path) const {
+  switch (format) {
+    case TimeReportFormat::Table:
+      dump_table(out, file_path);
+      break;
+    case TimeReportFormat::Json:
+      dump_json(out, file_path);
+      break;
+    case TimeReportFormat::None:
+      break;
+  }
+}
+
+void TimeReport::dump_table(std::ostream& out, std::string_view file_path)
+    const {
+  Record total{"total", {}, {}, 0};
+  out << "Time report for " << file_path << "\n"
+      << std::left << std::setw(12) << "Phase" << std::right << std::setw(12)
+      << "Wall (ms)" << std::setw(12) << "CPU (ms)" << std::setw(14)
+      << "Allocations" << "\n";
+  const auto print = [&out](const Record& record) {
+    out << std::left << std::setw(12) << record.name_ << std::right
+        << std::fixed << std::setprecision(3) << std::setw(12)
+        << Milliseconds(record.wall_).count() << std::setw(12)
+        << Milliseconds(record.cpu_).count() << std::setw(14)
+        << record.allocations_ << "\n";
+  };
+  for (const auto& record : records_) {
+    print(record);
+    total.wall_ += record.wall_;
+    total.cpu_ += record.cpu_;
+    total.allocations_ += record.allocations_;
+  }
+  print(total);
+}
+
+void TimeReport::dump_json(std::ostream& out, std::string_view file_path)
+    const {
+  out << std::fixed << std::setprecision(3) << "{\"file\": \""
+      << escape_json(file_path) << "\", \"phases\": [";
+  for (size_t i = 0; i < records_.size(); ++i) {
+    const auto& record = records_[i];
+    out << (i == 0 ? "" : ", ") << "{\"name\": \"" << record.name_
+        << "\", \"wall_ms\": " << Milliseconds(record.wall_).count()
+        << ", \"cpu_ms\": " << Milliseconds(record.cpu_).count()
+        << ", \"allocations\": " << record.allocations_ << "}";
+  }
+  out << "]}\n";
+}
+
+}  // namespace pascal::driver
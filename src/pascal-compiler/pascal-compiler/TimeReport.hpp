@@ -0,0 +1,54 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pascal::driver {
+
+enum class TimeReportFormat { None, Table, Json };
+
+// Wall time, CPU time of the calling thread and operator new calls for each
+// phase of one compilation.
+class TimeReport {
+ public:
+  // Measures its own lifetime as one phase; does nothing for a null report.
+  class Phase {
+   public:
+    Phase(TimeReport* report, std::string_view name);
+    ~Phase();
+
+    Phase(const Phase&) = delete;
+    Phase& operator=(const Phase&) = delete;
+
+   private:
+    TimeReport* report_;
+    std::string_view name_;
+    std::chrono::steady_clock::time_point wall_start_;
+    std::chrono::nanoseconds cpu_start_;
+    uint64_t allocations_start_;
+  };
+
+  void dump(
+      std::ostream& out,
+      TimeReportFormat format,
+      std::string_view file_path) const;
+
+ private:
+  struct Record {
+    std::string name_;
+    std::chrono::nanoseconds wall_;
+    std::chrono::nanoseconds cpu_;
+    uint64_t allocations_;
+  };
+
+  void dump_table(std::ostream& out, std::string_view file_path) const;
+  void dump_json(std::ostream& out, std::string_view file_path) const;
+
+  std::vector<Record> records_;
+};
+
+}  // namespace pascal::driver
@@ -0,0 +1,311 @@
+#include <pascal-compiler/Cache.hpp>
+#include <pascal-compiler/command_line.hpp>
+
+#include <cxxopts.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <ostream>
+#include <thread>
+
+namespace pascal::driver {
+
+namespace {
+
+const char* const file_path_opt = "file-path";
+const char* const dump_tokens_opt = "dump-tokens";
+const char* const dump_ast_opt = "dump-ast";
+const char* const dump_asm_opt = "dump-asm";
+const char* const dfa_lexer_opt = "dfa-lexer";
+const char* const descent_parser_opt = "descent-parser";
+const char* const profile_parser_opt = "profile-parser";
+const char* const flat_ast_opt = "flat-ast";
+const char* const emit_opt = "emit";
+const char* const output_opt = "output";
+const char* const opt_level_opt = "O";
+const char* const passes_opt = "passes";
+const char* const cpu_opt = "mcpu";
+const char* const run_opt = "run";
+const char* const jobs_opt = "jobs";
+const char* const cache_dir_opt = "cache-dir";
+const char* const cache_stats_opt = "cache-stats";
+const char* const time_report_opt = "time-report";
+const char* const server_opt = "server";
+const char* const connect_opt = "connect";
+
+std::optional<backend::OptLevel> to_opt_level(unsigned level) {
+  switch (level) {
+    case 0:
+      return backend::OptLevel::O0;
+    case 1:
+      return backend::OptLevel::O1;
+    case 2:
+      return backend::OptLevel::O2;
+    case 3:
+      return backend::OptLevel::O3;
+    default: /* do nothing */
+      break;
+  }
+  return std::nullopt;
+}
+
+std::optional<OutputKind> to_output_kind(const std::string& kind) {
+  if (kind == "exe") {
+    return OutputKind::Executable;
+  }
+  if (kind == "llvm") {
+    return OutputKind::Assembly;
+  }
+  if (kind == "bc") {
+    return OutputKind::Bitcode;
+  }
+  if (kind == "obj") {
+    return OutputKind::Object;
+  }
+  if (kind == "ast") {
+    return OutputKind::Ast;
+  }
+  return std::nullopt;
+}
+
+std::optional<AstFormat> to_ast_format(const std::string& format) {
+  if (format == "xml") {
+    return AstFormat::Xml;
+  }
+  if (format == "binary") {
+    return AstFormat::Binary;
+  }
+  return std::nullopt;
+}
+
+std::optional<TimeReportFormat> to_time_report_format(
+    const std::string& format) {
+  if (format == "table") {
+    return TimeReportFormat::Table;
+  }
+  if (format == "json") {
+    return TimeReportFormat::Json;
+  }
+  return std::nullopt;
+}
+
+void dump_cache_stats(const std::string& cache_dir, std::ostream& out) {
+  const auto stats = Cache(cache_dir).stats();
+  out << "Cache directory: " << cache_dir << "\n"
+      << "Hits: " << stats.hits_ << "\n"
+      << "Misses: " << stats.misses_ << "\n"
+      << "Entries: " << stats.entries_ << "\n"
+      << "Size: " << stats.bytes_ << " bytes\n";
+}
+
+}  // namespace
+
+std::optional<std::string> take_option(
+    std::vector<std::string>& args,
+    const std::string& name) {
+  const auto flag = "--" + name;
+  for (auto it = args.begin(); it != args.end(); ++it) {
+    if (*it == flag && std::next(it) != args.end()) {
+      auto value = *std::next(it);
+      args.erase(it, std::next(it, 2));
+      return value;
+    }
+    if (it->rfind(flag + "=", 0) == 0) {
+      auto value = it->substr(flag.size() + 1);
+      args.erase(it);
+      return value;
+    }
+  }
+  return std::nullopt;
+}
+
+int run_command_line(
+    const std::vector<std::string>& args,
+    const Options& base,
+    std::ostream& out,
+    std::ostream& err) {
+  cxxopts::Options options("pascal-compiler", "ANTLR4 Pascal compiler");
+
+  options.positional_help("<file-path>... (- for stdin)");
+
+  try {
+    // clang-format off
+    options.add_options()
+        (file_path_opt, "", cxxopts::value<std::vector<std::string>>())
+        (dump_tokens_opt, "")
+        (dump_ast_opt, "Print the AST: --dump-ast or --dump-ast=binary",
+            cxxopts::value<std::string>()->implicit_value("xml"))
+        (dump_asm_opt, "")
+        (dfa_lexer_opt, "Use the hand-written DFA lexer instead of ANTLR's")
+        (descent_parser_opt,
+            "Use the hand-written recursive-descent parser instead of ANTLR's")
+        (profile_parser_opt,
+            "Print a table of ANTLR's parser decisions, the slowest first")
+        (flat_ast_opt,
+            "Run semantic analysis and codegen over the flat, array-based AST")
+        (emit_opt, "Output kind: exe (default), llvm, bc, obj or ast",
+            cxxopts::value<std::string>()->default_value("exe"))
+        ("o," + std::string(output_opt), "Output file, - for stdout",
+            cxxopts::value<std::string>())
+        (opt_level_opt, "Optimization level: -O0, -O1, -O2 or -O3",
+            cxxopts::value<unsigned>()->default_value("0"))
+        (passes_opt, "LLVM pass pipeline to run instead of the -O one",
+            cxxopts::value<std::string>())
+        (cpu_opt,
+            "CPU to generate code for: generic (default), native or an LLVM "
+            "CPU name",
+            cxxopts::value<std::string>()->default_value("generic"))
+        (run_opt, "JIT-compile the program and run it in-process")
+        ("j," + std::string(jobs_opt),
+            "Number of files compiled in parallel, 0 for one per core",
+            cxxopts::value<size_t>()->default_value("1"))
+        (cache_dir_opt, "Directory of the compile cache",
+            cxxopts::value<std::string>())
+        (cache_stats_opt, "Print compile cache statistics")
+        (time_report_opt,
+            "Print time and allocations per phase: --time-report or "
+            "--time-report=json",
+            cxxopts::value<std::string>()->implicit_value("table"))
+        (server_opt, "Serve compile requests on a Unix domain socket",
+            cxxopts::value<std::string>())
+        (connect_opt, "Send the command to a server started with --server",
+            cxxopts::value<std::string>())
+        ("h,help", "Print help");
+    // clang-format on
+  } catch (const cxxopts::OptionSpecException& e) {
+    err << e.what() << "\n";
+    return 1;
+  }
+
+  options.parse_positional({file_path_opt});
+
+  try {
+    std::vector<const char*> argv;
+    argv.reserve(args.size());
+    for (const auto& arg : args) {
+      argv.push_back(arg.c_str());
+    }
+    const auto result =
+        options.parse(static_cast<int>(argv.size()), argv.data());
+
+    // main() handles these before parsing; seeing them here means they were
+    // forwarded to a server.
+    if (result.count(server_opt) > 0 || result.count(connect_opt) > 0) {
+      err << "--server and --connect cannot be sent to a server\n";
+      return 1;
+    }
+    const auto cache_stats = result.count(cache_stats_opt) > 0;
+    if (cache_stats && result.count(cache_dir_opt) == 0) {
+      err << "--cache-stats requires --cache-dir\n";
+      return 1;
+    }
+    std::string cache_dir;
+    if (result.count(cache_dir_opt) > 0) {
+      // Relative to the directory the command was issued from, which for
+      // the server is the client's.
+      cache_dir = (std::filesystem::path(base.directory_) /
+                   result[cache_dir_opt].as<std::string>())
+                      .string();
+    }
+    if (cache_stats && result.count(file_path_opt) == 0) {
+      dump_cache_stats(cache_dir, out);
+      return 0;
+    }
+    if (result.count("help") > 0 || result.count(file_path_opt) == 0) {
+      out << options.help() << "\n";
+      return 0;
+    }
+    const auto opt_level = to_opt_level(result[opt_level_opt].as<unsigned>());
+    if (!opt_level) {
+      err << "Invalid optimization level\n";
+      return 1;
+    }
+    const auto file_paths =
+        result[file_path_opt].as<std::vector<std::string>>();
+    if (result.count(run_opt) > 0 && file_paths.size() != 1) {
+      err << "--run accepts a single file\n";
+      return 1;
+    }
+    if (std::count(file_paths.begin(), file_paths.end(), "-") > 1) {
+      err << "stdin can be read only once\n";
+      return 1;
+    }
+    if (result.count(profile_parser_opt) > 0 &&
+        result.count(descent_parser_opt) > 0) {
+      err << "--profile-parser profiles ANTLR's parser, not "
+             "--descent-parser\n";
+      return 1;
+    }
+    auto output_kind = to_output_kind(result[emit_opt].as<std::string>());
+    if (!output_kind) {
+      err << "Invalid output kind\n";
+      return 1;
+    }
+    if (result.count(dump_asm_opt) > 0) {
+      output_kind = OutputKind::Assembly;
+    }
+    std::string output_path;
+    if (result.count(output_opt) > 0) {
+      output_path = result[output_opt].as<std::string>();
+      if (file_paths.size() != 1) {
+        err << "-o accepts a single file\n";
+        return 1;
+      }
+      if (output_path == "-" && output_kind == OutputKind::Executable) {
+        err << "Executables cannot be written to stdout, use --emit\n";
+        return 1;
+      }
+    }
+
+    auto driver_options = base;
+    driver_options.dump_tokens_ = result.count(dump_tokens_opt) > 0;
+    driver_options.run_ = result.count(run_opt) > 0;
+    driver_options.dfa_lexer_ = result.count(dfa_lexer_opt) > 0;
+    driver_options.descent_parser_ = result.count(descent_parser_opt) > 0;
+    driver_options.profile_parser_ = result.count(profile_parser_opt) > 0;
+    driver_options.flat_ast_ = result.count(flat_ast_opt) > 0;
+    driver_options.output_kind_ = *output_kind;
+    driver_options.output_path_ = output_path;
+    driver_options.opt_level_ = *opt_level;
+    if (result.count(passes_opt) > 0) {
+      driver_options.passes_ = result[passes_opt].as<std::string>();
+    }
+    driver_options.cpu_ = result[cpu_opt].as<std::string>();
+    driver_options.cache_dir_ = cache_dir;
+    if (result.count(dump_ast_opt) > 0) {
+      const auto format =
+          to_ast_format(result[dump_ast_opt].as<std::string>());
+      if (!format) {
+        err << "Invalid AST format\n";
+        return 1;
+      }
+      driver_options.dump_ast_ = *format;
+    }
+    if (result.count(time_report_opt) > 0) {
+      const auto format =
+          to_time_report_format(result[time_report_opt].as<std::string>());
+      if (!format) {
+        err << "Invalid time report format\n";
+        return 1;
+      }
+      driver_options.time_report_ = *format;
+    }
+
+    auto jobs = result[jobs_opt].as<size_t>();
+    if (jobs == 0) {
+      jobs = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+
+    const auto exit_code =
+        compile_files(file_paths, driver_options, jobs, out, err);
+    if (cache_stats) {
+      dump_cache_stats(driver_options.cache_dir_, out);
+    }
+    return exit_code;
+  } catch (const cxxopts::OptionException& e) {
+    err << e.what() << "\n";
+    return 1;
+  }
+}
+
+}  // namespace pascal::driver
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <pascal-compiler/driver.hpp>
+
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace pascal::driver {
+
+// Removes `--name value` or `--name=value` from the arguments and returns
+// the value.
+std::optional<std::string> take_option(
+    std::vector<std::string>& args,
+    const std::string& name);
+
+// Parses `pascal-compiler` arguments (args[0] is the program name) and runs
+// them. `base` supplies the settings that do not come from the command line,
+// such as the working directory of a remote client.
+int run_command_line(
+    const std::vector<std::string>& args,
+    const Options& base,
+    std::ostream& out,
+    std::ostream& err);
+
+}  // namespace pascal::driver
@@ -0,0 +1,657 @@
+#include <pascal-compiler/Cache.hpp>
+#include <pascal-compiler/ThreadPool.hpp>
+#include <pascal-compiler/driver.hpp>
+
+#include <libpas/compiler.hpp>
+#include <libpas/descent_parser.hpp>
+#include <libpas/dfa_lexer.hpp>
+#include <libpas/dump_tokens.hpp>
+#include <libpas/input_stream.hpp>
+#include <libpas/token_arena.hpp>
+
+#include <PascalLexer.h>
+#include <antlr4-runtime.h>
+
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string_view>
+#include <system_error>
+
+namespace pascal::driver {
+
+namespace {
+
+void dump_run_report(
+    std::chrono::nanoseconds compile_time,
+    const backend::RunResult& result,
+    std::ostream& out) {
+  using Milliseconds = std::chrono::duration<double, std::milli>;
+  out << std::fixed << std::setprecision(3) << "{\"compile_ms\": "
+      << Milliseconds(compile_time).count()
+      << ", \"run_ms\": " << Milliseconds(result.run_time).count()
+      << ", \"exit_code\": " << result.exit_code << "}\n";
+}
+
+std::string resolve(const std::string& directory, const std::string& path) {
+  if (directory.empty() || std::filesystem::path(path).is_absolute()) {
+    return path;
+  }
+  return (std::filesystem::path(directory) / path).string();
+}
+
+// "-" names the command's stdin as a source and its stdout as an output.
+bool is_standard_stream(const std::string& path) {
+  return path == "-";
+}
+
+// Without -o the output is named after the source file, e.g. gcd.pas or
+// gcd.ast gives gcd, gcd.ll, gcd.bc, gcd.o or gcd.ast; stdin gives a, a.ll,
+// a.bc, a.o or a.ast.
+std::string output_path(const std::string& file_path, const Options& options) {
+  if (is_standard_stream(options.output_path_)) {
+    return options.output_path_;
+  }
+  if (!options.output_path_.empty()) {
+    return resolve(options.directory_, options.output_path_);
+  }
+  std::filesystem::path path = is_standard_stream(file_path)
+      ? resolve(options.directory_, "a")
+      : resolve(options.directory_, file_path);
+  if (path.extension() == ".pas" || path.extension() == ".ast") {
+    path.replace_extension();
+  }
+  switch (options.output_kind_) {
+    case OutputKind::Assembly:
+      path += ".ll";
+      break;
+    case OutputKind::Bitcode:
+      path += ".bc";
+      break;
+    case OutputKind::Object:
+      path += ".o";
+      break;
+    case OutputKind::Ast:
+      path += ".ast";
+      break;
+    case OutputKind::Executable:
+      break;
+  }
+  return path.string();
+}
+
+int input_fd(const Options& options) {
+  return options.input_fd_ >= 0 ? options.input_fd_ : STDIN_FILENO;
+}
+
+// An output file, or `out` for "-".
+class Output {
+ public:
+  Output(const std::string& path, std::ostream& out) : stream_(&out) {
+    if (!is_standard_stream(path)) {
+      file_.open(path, std::ios::binary);
+      stream_ = &file_;
+    }
+  }
+
+  std::ostream& stream() { return *stream_; }
+
+ private:
+  std::ofstream file_;
+  std::ostream* stream_;
+};
+
+std::optional<std::string> read_file(const std::string& path) {
+  std::ifstream input(path, std::ios::binary);
+  if (!input.good()) {
+    return std::nullopt;
+  }
+  return std::string(
+      std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+}
+
+template <class F>
+auto timed(TimeReport* report, std::string_view phase_name, F function) {
+  const TimeReport::Phase phase(report, phase_name);
+  return function();
+}
+
+// DescentParser lexes the whole source before it parses.
+ParseResult parse_descent(std::string_view source, TimeReport* report) {
+  auto parser = timed(report, "lex", [&] { return DescentParser(source); });
+  return timed(report, "parse", [&] { return parse(parser); });
+}
+
+// Profiles the parser when `profile` is not null.
+ParseResult parse_antlr(
+    ByteStream& stream,
+    const Options& options,
+    TimeReport* report,
+    ParserProfile* profile) {
+  const auto parse_tokens = [&](antlr4::TokenStream& tokens) {
+    return timed(report, "parse", [&] {
+      return profile != nullptr ? parse(tokens, *profile) : parse(tokens);
+    });
+  };
+  if (options.dfa_lexer_) {
+    std::optional<ArenaTokenStream> tokens;
+    timed(report, "lex", [&] {
+      tokens.emplace(stream);
+      return 0;
+    });
+    return parse_tokens(*tokens);
+  }
+  PascalLexer lexer(&stream);
+  antlr4::CommonTokenStream tokens(&lexer);
+  timed(report, "lex", [&] {
+    tokens.fill();
+    return 0;
+  });
+  return parse_tokens(tokens);
+}
+
+// Runs every phase up to and including the optimizer. Returns the module,
+// or null when the command ends earlier (a dump, --emit=ast or an error);
+// `exit_code` is set in every case. --emit=ast leaves the analysed program
+// in `binary_ast`.
+std::unique_ptr<llvm::Module> run_phases(
+    std::string_view source,
+    const std::string& source_name,
+    const Options& options,
+    llvm::LLVMContext& context,
+    TimeReport* report,
+    std::ostream& out,
+    std::ostream& err,
+    std::string& binary_ast,
+    int& exit_code) {
+  exit_code = 0;
+  // A binary AST is loaded instead of lexed and parsed. It is analysed
+  // again even if it was written after semantic analysis: the file may have
+  // been changed since, and codegen trusts the types it is given.
+  const auto from_binary_ast = ast::BinaryAst::is_binary_ast(source);
+  ByteStream stream(source, source_name);
+
+  if (options.dump_tokens_) {
+    if (from_binary_ast) {
+      err << "Error: " << source_name << " is a binary AST\n";
+      exit_code = 1;
+      return nullptr;
+    }
+    timed(report, "lex", [&] {
+      if (options.dfa_lexer_) {
+        DfaLexer lexer(source);
+        dump_tokens(lexer, out);
+      } else {
+        dump_tokens(stream, out);
+      }
+      return 0;
+    });
+    return nullptr;
+  }
+
+  ast::Program program;
+  std::optional<ast::SymbolTable> loaded_symbol_table;
+  if (from_binary_ast) {
+    const auto loaded = timed(report, "load", [&] {
+      return load_binary_ast(source, program, loaded_symbol_table, err);
+    });
+    if (!loaded) {
+      exit_code = 1;
+      return nullptr;
+    }
+  } else {
+    ParserProfile profile;
+    auto parser_result = options.descent_parser_
+        ? parse_descent(source, report)
+        : parse_antlr(
+              stream,
+              options,
+              report,
+              options.profile_parser_ ? &profile : nullptr);
+    if (options.profile_parser_) {
+      dump_parser_profile(profile, err);
+    }
+    if (!parser_result.errors_.empty()) {
+      dump_errors(parser_result.errors_, err);
+      exit_code = 1;
+      return nullptr;
+    }
+    program = std::move(parser_result.program_);
+  }
+  if (options.dump_ast_ != AstFormat::None) {
+    const auto dumped = timed(report, "dump", [&] {
+      if (options.dump_ast_ == AstFormat::Xml) {
+        dump_ast(program, out);
+        return true;
+      }
+      return dump_binary_ast(
+          program,
+          loaded_symbol_table ? &*loaded_symbol_table : nullptr,
+          out,
+          err);
+    });
+    exit_code = dumped ? 0 : 1;
+    return nullptr;
+  }
+
+  std::optional<ast::FlatAst> flat_ast;
+  if (options.flat_ast_) {
+    timed(report, "flatten", [&] {
+      flat_ast = ast::FlatAst::flatten(program);
+      return 0;
+    });
+  }
+
+  ast::SymbolTable symbol_table;
+  const auto analysed = timed(report, "semantic", [&] {
+    return flat_ast ? semantic_analyse(*flat_ast, symbol_table, err)
+                    : semantic_analyse(program, symbol_table, err);
+  });
+  if (!analysed) {
+    exit_code = 1;
+    return nullptr;
+  }
+
+  if (options.output_kind_ == OutputKind::Ast && !options.run_) {
+    const auto serialized = timed(report, "serialize", [&] {
+      std::ostringstream bytes;
+      const auto written = flat_ast
+          ? dump_binary_ast(*flat_ast, &symbol_table, bytes, err)
+          : dump_binary_ast(program, &symbol_table, bytes, err);
+      binary_ast = written ? bytes.str() : std::string();
+      return written;
+    });
+    exit_code = serialized ? 0 : 1;
+    return nullptr;
+  }
+
+  auto module = timed(report, "codegen", [&] {
+    return flat_ast ? code_generate(*flat_ast, symbol_table, context)
+                    : code_generate(program, symbol_table, context);
+  });
+  const auto optimized = timed(report, "optimize", [&] {
+    return optimize(
+        *module, options.opt_level_, options.passes_, err, options.cpu_);
+  });
+  if (!optimized) {
+    exit_code = 1;
+    return nullptr;
+  }
+  return module;
+}
+
+int run_program(
+    std::unique_ptr<llvm::Module> module,
+    std::unique_ptr<llvm::LLVMContext> context,
+    backend::OptLevel level,
+    std::chrono::nanoseconds frontend_time,
+    std::ostream& err) {
+  const auto run_result =
+      run(std::move(module), std::move(context), err, level);
+  if (!run_result) {
+    return 1;
+  }
+  dump_run_report(frontend_time + run_result->compile_time, *run_result, err);
+  return run_result->exit_code;
+}
+
+// Runs the program, or hands it to Options::deferred_run_ when it is set.
+int run_module(
+    std::unique_ptr<llvm::Module> module,
+    std::unique_ptr<llvm::LLVMContext> context,
+    const Options& options,
+    std::chrono::steady_clock::time_point compile_start,
+    std::ostream& err) {
+  const auto frontend_time = std::chrono::steady_clock::now() - compile_start;
+  if (options.deferred_run_ != nullptr) {
+    auto& deferred_run = *options.deferred_run_;
+    llvm::raw_string_ostream bitcode(deferred_run.bitcode_);
+    llvm::WriteBitcodeToFile(*module, bitcode);
+    bitcode.flush();
+    deferred_run.opt_level_ = options.opt_level_;
+    deferred_run.frontend_time_ = frontend_time;
+    return 0;
+  }
+  return run_program(
+      std::move(module),
+      std::move(context),
+      options.opt_level_,
+      frontend_time,
+      err);
+}
+
+bool write_executable(const std::string& path, const std::string& contents) {
+  // The old file may be running, so it is unlinked rather than overwritten.
+  std::error_code ec;
+  std::filesystem::remove(path, ec);
+  {
+    std::ofstream output(path, std::ios::binary);
+    if (!(output << contents)) {
+      return false;
+    }
+  }
+  using std::filesystem::perms;
+  std::filesystem::permissions(
+      path,
+      perms::owner_all | perms::group_read | perms::group_exec |
+          perms::others_read | perms::others_exec,
+      ec);
+  return !ec;
+}
+
+// Writes the module in the requested non-executable form.
+bool emit(
+    llvm::Module& module,
+    const Options& options,
+    std::ostream& out,
+    std::ostream& err) {
+  switch (options.output_kind_) {
+    case OutputKind::Assembly:
+      dump_asm(module, out);
+      return true;
+    case OutputKind::Bitcode:
+      dump_bitcode(module, out);
+      return true;
+    case OutputKind::Object:
+      return dump_object(module, out, err, options.opt_level_, options.cpu_);
+    case OutputKind::Ast:
+    case OutputKind::Executable:
+      break;
+  }
+  return false;
+}
+
+// Answers a request from a cache entry without running any phase.
+int replay(
+    const CacheEntry& entry,
+    const std::string& filename,
+    const std::string& output,
+    const Options& options,
+    std::chrono::steady_clock::time_point compile_start,
+    std::ostream& out,
+    std::ostream& err) {
+  out << entry.out_;
+  err << entry.err_;
+  if (entry.module_.empty() && entry.artifact_.empty()) {
+    return entry.exit_code_;
+  }
+
+  if (options.run_) {
+    auto context = std::make_unique<llvm::LLVMContext>();
+    auto module = llvm::parseBitcodeFile(
+        llvm::MemoryBufferRef(entry.module_, filename), *context);
+    if (!module) {
+      err << "Error: " << llvm::toString(module.takeError()) << "\n";
+      return 1;
+    }
+    return run_module(
+        std::move(*module), std::move(context), options, compile_start, err);
+  }
+  const auto written = options.output_kind_ == OutputKind::Executable
+      ? write_executable(output, entry.artifact_)
+      : static_cast<bool>(Output(output, out).stream() << entry.artifact_);
+  if (!written) {
+    err << "Error: Unable to write " << output << "\n";
+    return 1;
+  }
+  return entry.exit_code_;
+}
+
+struct FileOutput {
+  std::string out_;
+  std::string err_;
+  int exit_code_ = 0;
+};
+
+// Prints the tokens of stdin as it arrives instead of reading it first.
+int stream_tokens(
+    const Options& options,
+    TimeReport* report,
+    std::ostream& out) {
+  return timed(report, "lex", [&] {
+    FdStream stream(input_fd(options), "<stdin>");
+    PascalLexer lexer(&stream);
+    // The stream keeps only the current token's text.
+    antlr4::CommonTokenFactory token_factory(/*copyText=*/true);
+    lexer.setTokenFactory(&token_factory);
+    dump_tokens(lexer, out);
+    return 0;
+  });
+}
+
+int compile(
+    const std::string& file_path,
+    const Options& options,
+    TimeReport* report,
+    std::ostream& out,
+    std::ostream& err) {
+  const auto from_stdin = is_standard_stream(file_path);
+  if (from_stdin && options.dump_tokens_ && !options.dfa_lexer_ &&
+      options.cache_dir_.empty()) {
+    try {
+      return stream_tokens(options, report, out);
+    } catch (const std::system_error&) {
+      err << "Unable to read stream\n";
+      return 1;
+    }
+  }
+
+  const auto path = from_stdin ? std::string("<stdin>")
+                               : resolve(options.directory_, file_path);
+  const auto source_file = timed(
+      report, "read", [&]() -> std::optional<SourceFile> {
+        try {
+          return from_stdin ? SourceFile(input_fd(options), path)
+                            : SourceFile(path);
+        } catch (const std::system_error&) {
+          return std::nullopt;
+        }
+      });
+
+  if (!source_file) {
+    err << "Unable to read stream\n";
+    return 1;
+  }
+  const auto source = source_file->text();
+
+  const auto compile_start = std::chrono::steady_clock::now();
+  const auto output = output_path(file_path, options);
+
+  std::optional<Cache> cache;
+  std::string key;
+  // A parser profile measures this run, so replaying a stored one would
+  // report timings of a run that did not happen.
+  if (!options.cache_dir_.empty() && !options.profile_parser_) {
+    cache.emplace(options.cache_dir_);
+    const auto entry = timed(report, "cache", [&] {
+      key = Cache::key(source, options);
+      return cache->lookup(key);
+    });
+    if (entry) {
+      return timed(report, "replay", [&] {
+        return replay(
+            *entry, path, output, options, compile_start, out, err);
+      });
+    }
+  }
+
+  // With a cache, the front end's output is captured so it can be stored.
+  CacheEntry entry;
+  std::ostringstream captured_out;
+  std::ostringstream captured_err;
+  auto& phase_out = cache ? static_cast<std::ostream&>(captured_out) : out;
+  auto& phase_err = cache ? static_cast<std::ostream&>(captured_err) : err;
+  const auto store = [&](const llvm::Module* module) {
+    if (!cache) {
+      return;
+    }
+    timed(report, "cache-store", [&] {
+      if (module != nullptr) {
+        llvm::raw_string_ostream bitcode(entry.module_);
+        llvm::WriteBitcodeToFile(*module, bitcode);
+      }
+      cache->store(key, entry);
+      return 0;
+    });
+  };
+
+  auto context = std::make_unique<llvm::LLVMContext>();
+  std::string binary_ast;
+  auto module = run_phases(
+      source,
+      path,
+      options,
+      *context,
+      report,
+      phase_out,
+      phase_err,
+      binary_ast,
+      entry.exit_code_);
+  if (cache) {
+    entry.out_ = captured_out.str();
+    entry.err_ = captured_err.str();
+    out << entry.out_;
+    err << entry.err_;
+  }
+
+  if (!binary_ast.empty()) {
+    Output file(output, out);
+    if (!(file.stream() << binary_ast)) {
+      err << "Error: Unable to write " << output << "\n";
+      return 1;
+    }
+    entry.artifact_ = std::move(binary_ast);
+  }
+  if (!module) {
+    store(nullptr);
+    return entry.exit_code_;
+  }
+
+  if (options.run_) {
+    // Only the module is stored: the program runs again on every hit.
+    store(module.get());
+    return timed(report, "run", [&] {
+      return run_module(
+          std::move(module), std::move(context), options, compile_start, err);
+    });
+  }
+  const auto generated = timed(report, "backend", [&] {
+    if (options.output_kind_ == OutputKind::Executable) {
+      return exec_generate(
+          *module, output, err, options.opt_level_, options.cpu_);
+    }
+    Output file(output, out);
+    auto emitted = false;
+    if (!cache) {
+      // Written straight to the destination, which may be a pipe.
+      emitted = file.stream() && emit(*module, options, file.stream(), err);
+    } else {
+      std::ostringstream artifact;
+      emitted = emit(*module, options, artifact, err);
+      entry.artifact_ = artifact.str();
+      file.stream() << entry.artifact_;
+    }
+    if (!file.stream()) {
+      err << "Error: Unable to write " << output << "\n";
+      return false;
+    }
+    return emitted;
+  });
+  if (!generated) {
+    // Backend failures (e.g. no linker, an unwritable output) depend on the
+    // environment, not on the source, so they are not cached.
+    return 1;
+  }
+  if (cache && options.output_kind_ == OutputKind::Executable) {
+    entry.artifact_ = read_file(output).value_or(std::string{});
+  }
+  store(module.get());
+  return 0;
+}
+
+}  // namespace
+
+int run_deferred(const DeferredRun& deferred_run, std::ostream& err) {
+  auto context = std::make_unique<llvm::LLVMContext>();
+  auto module = llvm::parseBitcodeFile(
+      llvm::MemoryBufferRef(deferred_run.bitcode_, "<deferred>"), *context);
+  if (!module) {
+    err << "Error: " << llvm::toString(module.takeError()) << "\n";
+    return 1;
+  }
+  return run_program(
+      std::move(*module),
+      std::move(context),
+      deferred_run.opt_level_,
+      deferred_run.frontend_time_,
+      err);
+}
+
+int compile_file(
+    const std::string& file_path,
+    const Options& options,
+    std::ostream& out,
+    std::ostream& err) {
+  if (options.time_report_ == TimeReportFormat::None) {
+    return compile(file_path, options, nullptr, out, err);
+  }
+  TimeReport report;
+  const auto exit_code = compile(file_path, options, &report, out, err);
+  report.dump(err, options.time_report_, file_path);
+  return exit_code;
+}
+
+int compile_files(
+    const std::vector<std::string>& file_paths,
+    const Options& options,
+    size_t jobs,
+    std::ostream& out,
+    std::ostream& err) {
+  if (file_paths.size() == 1) {
+    return compile_file(file_paths.front(), options, out, err);
+  }
+
+  ThreadPool pool(std::min(jobs, file_paths.size()));
+  std::vector<std::future<FileOutput>> outputs;
+  outputs.reserve(file_paths.size());
+  for (const auto& file_path : file_paths) {
+    outputs.push_back(pool.submit([&file_path, &options] {
+      std::ostringstream file_out;
+      std::ostringstream file_err;
+      FileOutput output;
+      output.exit_code_ = compile_file(file_path, options, file_out, file_err);
+      output.out_ = file_out.str();
+      output.err_ = file_err.str();
+      return output;
+    }));
+  }
+
+  int exit_code = 0;
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    const auto output = outputs[i].get();
+    out << output.out_;
+    out.flush();
+    if (!output.err_.empty()) {
+      err << file_paths[i] << ":\n" << output.err_;
+    }
+    exit_code = std::max(exit_code, output.exit_code_);
+  }
+  return exit_code;
+}
+
+}  // namespace pascal::driver
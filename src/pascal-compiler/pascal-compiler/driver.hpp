@@ -0,0 +1,89 @@
+#pragma once
+
+#include <pascal-compiler/TimeReport.hpp>
+
+#include <libpas/backend.hpp>
+
+#include <chrono>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace pascal::driver {
+
+// What the backend writes: a linked executable (the default), textual
+// LLVM IR (--dump-asm), LLVM bitcode or a native object file. Ast stops
+// after semantic analysis and writes the program as an ast::BinaryAst.
+enum class OutputKind { Executable, Assembly, Bitcode, Object, Ast };
+
+// What --dump-ast prints after parsing.
+enum class AstFormat { None, Xml, Binary };
+
+// A program compiled for --run that is run by another process, e.g. a
+// compile server's client.
+struct DeferredRun {
+  // Empty unless the program was compiled without errors.
+  std::string bitcode_;
+  backend::OptLevel opt_level_ = backend::OptLevel::O0;
+  std::chrono::nanoseconds frontend_time_{};
+};
+
+struct Options {
+  bool dump_tokens_ = false;
+  AstFormat dump_ast_ = AstFormat::None;
+  bool run_ = false;
+  // Lex with DfaLexer instead of the ANTLR-generated PascalLexer.
+  bool dfa_lexer_ = false;
+  // Parse with DescentParser (on DfaLexer tokens) instead of PascalParser.
+  bool descent_parser_ = false;
+  // Print the prediction statistics of PascalParser's decisions to stderr.
+  bool profile_parser_ = false;
+  // Run semantic analysis and codegen over ast::FlatAst.
+  bool flat_ast_ = false;
+  OutputKind output_kind_ = OutputKind::Executable;
+  // "-" is stdout; when empty, the name is derived from the source file.
+  std::string output_path_;
+  backend::OptLevel opt_level_ = backend::OptLevel::O0;
+  std::string passes_;
+  // The CPU executables and objects are built for; --run always uses the
+  // host's.
+  std::string cpu_ = std::string(backend::generic_cpu);
+  // Compile results are looked up in and stored to this directory when it
+  // is set.
+  std::string cache_dir_;
+  TimeReportFormat time_report_ = TimeReportFormat::None;
+  // Relative file paths are resolved against this directory when it is set.
+  std::string directory_;
+  // The source file "-" is read from this descriptor instead of the
+  // process's stdin when it is not negative.
+  int input_fd_ = -1;
+  // With --run, the program is stored here instead of being run in this
+  // process when it is not null.
+  DeferredRun* deferred_run_ = nullptr;
+};
+
+// Runs the whole pipeline for one source file the way the command line
+// does. Returns the process exit code: 0 on success, 1 if any phase reported
+// an error, or the program's own exit code for --run.
+int compile_file(
+    const std::string& file_path,
+    const Options& options,
+    std::ostream& out,
+    std::ostream& err);
+
+// JIT-compiles and runs a program stored in a DeferredRun, printing the same
+// report as --run. Returns the program's exit code, or 1 on an error.
+int run_deferred(const DeferredRun& deferred_run, std::ostream& err);
+
+// Compiles the files on `jobs` threads. Each file writes into its own
+// buffers, which are flushed in command line order as soon as every earlier
+// file is done, so the output does not depend on scheduling. Returns the
+// largest exit code of all files.
+int compile_files(
+    const std::vector<std::string>& file_paths,
+    const Options& options,
+    size_t jobs,
+    std::ostream& out,
+    std::ostream& err);
+
+}  // namespace pascal::driver
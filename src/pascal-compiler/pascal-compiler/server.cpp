@@ -0,0 +1,405 @@
+#include <pascal-compiler/ThreadPool.hpp>
+#include <pascal-compiler/command_line.hpp>
+#include <pascal-compiler/server.hpp>
+
+#include <libpas/backend.hpp>
+#include <libpas/compiler.hpp>
+#include <libpas/input_stream.hpp>
+
+#include <PascalLexer.h>
+#include <WarmupCorpus.hpp>
+#include <antlr4-runtime.h>
+
+#include <llvm/Support/raw_ostream.h>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <system_error>
+#include <thread>
+
+namespace pascal::driver {
+
+namespace {
+
+// Messages are a 32-bit length followed by the payload. A request carries
+// the client's working directory and argv; the header of a request also
+// carries the client's stdin as SCM_RIGHTS, for the source file "-". A
+// response carries the exit code, everything the command wrote to stdout and
+// stderr and, for --run, the DeferredRun the client runs the program from.
+// Programs never run in the server, so one that crashes or hangs affects
+// only its own client.
+constexpr uint32_t max_message_size = 1U << 30U;
+constexpr size_t passed_fds = 1;
+
+class UniqueFd {
+ public:
+  explicit UniqueFd(int fd = -1) : fd_(fd) {}
+  ~UniqueFd() { reset(); }
+
+  UniqueFd(const UniqueFd&) = delete;
+  UniqueFd& operator=(const UniqueFd&) = delete;
+
+  int get() const { return fd_; }
+  void reset(int fd = -1) {
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+    fd_ = fd;
+  }
+
+ private:
+  int fd_;
+};
+
+std::system_error socket_error(const std::string& what) {
+  return std::system_error(errno, std::generic_category(), what);
+}
+
+void write_all(int fd, const char* data, size_t size) {
+  while (size > 0) {
+    const auto written = ::send(fd, data, size, MSG_NOSIGNAL);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw socket_error("send");
+    }
+    data += written;
+    size -= static_cast<size_t>(written);
+  }
+}
+
+void read_all(int fd, char* data, size_t size) {
+  while (size > 0) {
+    const auto received = ::recv(fd, data, size, 0);
+    if (received < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw socket_error("recv");
+    }
+    if (received == 0) {
+      throw std::runtime_error("Connection closed");
+    }
+    data += received;
+    size -= static_cast<size_t>(received);
+  }
+}
+
+class Writer {
+ public:
+  void put(uint32_t value) {
+    buffer_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+  void put(uint64_t value) {
+    buffer_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+  void put(const std::string& value) {
+    put(static_cast<uint32_t>(value.size()));
+    buffer_.append(value);
+  }
+  const std::string& buffer() const { return buffer_; }
+
+ private:
+  std::string buffer_;
+};
+
+class Reader {
+ public:
+  explicit Reader(std::string buffer) : buffer_(std::move(buffer)) {}
+  uint32_t get_u32() {
+    uint32_t value = 0;
+    take(reinterpret_cast<char*>(&value), sizeof(value));
+    return value;
+  }
+  uint64_t get_u64() {
+    uint64_t value = 0;
+    take(reinterpret_cast<char*>(&value), sizeof(value));
+    return value;
+  }
+  std::string get_string() {
+    std::string value(get_u32(), '\0');
+    take(value.data(), value.size());
+    return value;
+  }
+
+ private:
+  void take(char* data, size_t size) {
+    if (buffer_.size() - offset_ < size) {
+      throw std::runtime_error("Malformed message");
+    }
+    std::memcpy(data, buffer_.data() + offset_, size);
+    offset_ += size;
+  }
+
+  std::string buffer_;
+  size_t offset_ = 0;
+};
+
+void send_message(int fd, const std::string& payload) {
+  const auto size = static_cast<uint32_t>(payload.size());
+  write_all(fd, reinterpret_cast<const char*>(&size), sizeof(size));
+  write_all(fd, payload.data(), payload.size());
+}
+
+std::string receive_payload(int fd, uint32_t size) {
+  if (size > max_message_size) {
+    throw std::runtime_error("Message is too large");
+  }
+  std::string payload(size, '\0');
+  read_all(fd, payload.data(), payload.size());
+  return payload;
+}
+
+std::string receive_message(int fd) {
+  uint32_t size = 0;
+  read_all(fd, reinterpret_cast<char*>(&size), sizeof(size));
+  return receive_payload(fd, size);
+}
+
+// Sends the length header of a request together with the descriptors.
+void send_request(int fd, const std::string& payload) {
+  auto size = static_cast<uint32_t>(payload.size());
+  iovec data{&size, sizeof(size)};
+  const std::array<int, passed_fds> fds{STDIN_FILENO};
+  alignas(cmsghdr) std::array<char, CMSG_SPACE(sizeof(fds))> control{};
+
+  msghdr message{};
+  message.msg_iov = &data;
+  message.msg_iovlen = 1;
+  message.msg_control = control.data();
+  message.msg_controllen = control.size();
+  auto* header = CMSG_FIRSTHDR(&message);
+  header->cmsg_level = SOL_SOCKET;
+  header->cmsg_type = SCM_RIGHTS;
+  header->cmsg_len = CMSG_LEN(sizeof(fds));
+  std::memcpy(CMSG_DATA(header), fds.data(), sizeof(fds));
+
+  while (::sendmsg(fd, &message, MSG_NOSIGNAL) < 0) {
+    if (errno != EINTR) {
+      throw socket_error("sendmsg");
+    }
+  }
+  write_all(fd, payload.data(), payload.size());
+}
+
+struct Request {
+  std::array<UniqueFd, passed_fds> fds_;
+  std::string directory_;
+  std::vector<std::string> args_;
+};
+
+void receive_request(int fd, Request& request) {
+  uint32_t size = 0;
+  iovec data{&size, sizeof(size)};
+  alignas(cmsghdr) std::array<char, CMSG_SPACE(sizeof(int) * passed_fds)>
+      control{};
+
+  msghdr message{};
+  message.msg_iov = &data;
+  message.msg_iovlen = 1;
+  message.msg_control = control.data();
+  message.msg_controllen = control.size();
+  ssize_t received = 0;
+  while ((received = ::recvmsg(fd, &message, MSG_CMSG_CLOEXEC)) < 0) {
+    if (errno != EINTR) {
+      throw socket_error("recvmsg");
+    }
+  }
+
+  auto* header = CMSG_FIRSTHDR(&message);
+  if (header != nullptr && header->cmsg_level == SOL_SOCKET &&
+      header->cmsg_type == SCM_RIGHTS &&
+      header->cmsg_len == CMSG_LEN(sizeof(int) * passed_fds)) {
+    std::array<int, passed_fds> fds{};
+    std::memcpy(fds.data(), CMSG_DATA(header), sizeof(fds));
+    for (size_t i = 0; i < passed_fds; ++i) {
+      request.fds_[i].reset(fds[i]);
+    }
+  }
+  if (static_cast<size_t>(received) < sizeof(size)) {
+    read_all(
+        fd,
+        reinterpret_cast<char*>(&size) + received,
+        sizeof(size) - static_cast<size_t>(received));
+  }
+
+  Reader reader(receive_payload(fd, size));
+  request.directory_ = reader.get_string();
+  const auto count = reader.get_u32();
+  for (uint32_t i = 0; i < count; ++i) {
+    request.args_.push_back(reader.get_string());
+  }
+}
+
+void handle(int client) {
+  const UniqueFd connection(client);
+  try {
+    Request request;
+    receive_request(connection.get(), request);
+
+    DeferredRun deferred_run;
+    Options base;
+    base.directory_ = request.directory_;
+    base.input_fd_ = request.fds_[0].get();
+    base.deferred_run_ = &deferred_run;
+
+    std::ostringstream out;
+    std::ostringstream err;
+    int exit_code = 1;
+    try {
+      exit_code = run_command_line(request.args_, base, out, err);
+    } catch (const std::exception& e) {
+      err << "Error: " << e.what() << "\n";
+    }
+
+    Writer response;
+    response.put(static_cast<uint32_t>(exit_code));
+    response.put(out.str());
+    response.put(err.str());
+    response.put(deferred_run.bitcode_);
+    response.put(static_cast<uint32_t>(deferred_run.opt_level_));
+    response.put(static_cast<uint64_t>(deferred_run.frontend_time_.count()));
+    send_message(connection.get(), response.buffer());
+  } catch (const std::exception& e) {
+    std::cerr << "pascal-compiler server: " << e.what() << "\n";
+  }
+}
+
+// Fills the ANTLR DFA caches, then runs the first program of the warm-up
+// corpus through the remaining phases, so that the first client does not pay
+// for initializing the LLVM target either.
+void warm_up() {
+  preload_parser();
+  const auto& corpus = grammar::warmup_corpus();
+  if (corpus.empty()) {
+    return;
+  }
+  ByteStream stream(corpus.front().text_);
+  PascalLexer lexer(&stream);
+  auto result = parse(lexer);
+  ast::SymbolTable symbol_table;
+  std::ostringstream ignored;
+  if (!result.errors_.empty() ||
+      !semantic_analyse(result.program_, symbol_table, ignored)) {
+    return;
+  }
+  llvm::LLVMContext context;
+  auto module = code_generate(result.program_, symbol_table, context);
+  llvm::raw_null_ostream object;
+  try {
+    backend::emit_object(*module, object);
+  } catch (const backend::BackendError&) {
+    // The server still works, only the first compilation is slower.
+  }
+}
+
+sockaddr_un make_address(const std::string& socket_path) {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (socket_path.size() >= sizeof(address.sun_path)) {
+    throw std::runtime_error("Socket path is too long: " + socket_path);
+  }
+  std::memcpy(address.sun_path, socket_path.data(), socket_path.size());
+  return address;
+}
+
+}  // namespace
+
+int serve(const std::string& socket_path, std::ostream& err) {
+  try {
+    std::signal(SIGPIPE, SIG_IGN);
+
+    const auto address = make_address(socket_path);
+    const UniqueFd listener(::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0));
+    if (listener.get() < 0) {
+      throw socket_error("socket");
+    }
+    std::error_code ignored;
+    std::filesystem::remove(socket_path, ignored);
+    // NOLINTNEXTLINE
+    const auto* socket_address = reinterpret_cast<const sockaddr*>(&address);
+    if (::bind(listener.get(), socket_address, sizeof(address)) < 0) {
+      throw socket_error("bind " + socket_path);
+    }
+    if (::listen(listener.get(), SOMAXCONN) < 0) {
+      throw socket_error("listen");
+    }
+
+    warm_up();
+
+    ThreadPool pool(std::max(std::thread::hardware_concurrency(), 1U));
+    while (true) {
+      const auto client =
+          ::accept4(listener.get(), nullptr, nullptr, SOCK_CLOEXEC);
+      if (client < 0) {
+        if (errno == EINTR || errno == ECONNABORTED) {
+          continue;
+        }
+        throw socket_error("accept");
+      }
+      pool.submit([client] { handle(client); });
+    }
+  } catch (const std::exception& e) {
+    err << "Error: " << e.what() << "\n";
+  }
+  return 1;
+}
+
+int connect(
+    const std::string& socket_path,
+    const std::vector<std::string>& args) {
+  try {
+    const auto address = make_address(socket_path);
+    const UniqueFd connection(
+        ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0));
+    if (connection.get() < 0) {
+      throw socket_error("socket");
+    }
+    // NOLINTNEXTLINE
+    const auto* socket_address = reinterpret_cast<const sockaddr*>(&address);
+    if (::connect(connection.get(), socket_address, sizeof(address)) < 0) {
+      throw socket_error("connect " + socket_path);
+    }
+
+    Writer request;
+    request.put(std::filesystem::current_path().string());
+    request.put(static_cast<uint32_t>(args.size()));
+    for (const auto& arg : args) {
+      request.put(arg);
+    }
+    send_request(connection.get(), request.buffer());
+
+    Reader response(receive_message(connection.get()));
+    const auto exit_code = static_cast<int>(response.get_u32());
+    std::cout << response.get_string() << std::flush;
+    std::cerr << response.get_string() << std::flush;
+    DeferredRun deferred_run;
+    deferred_run.bitcode_ = response.get_string();
+    if (deferred_run.bitcode_.empty()) {
+      return exit_code;
+    }
+    deferred_run.opt_level_ =
+        static_cast<backend::OptLevel>(response.get_u32());
+    deferred_run.frontend_time_ =
+        std::chrono::nanoseconds(response.get_u64());
+    return run_deferred(deferred_run, std::cerr);
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << "\n";
+  }
+  return 1;
+}
+
+}  // namespace pascal::driver
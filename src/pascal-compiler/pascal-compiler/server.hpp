@@ -0,0 +1,23 @@
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace pascal::driver {
+
+// Listens on a Unix domain socket and runs every received command line with
+// run_command_line in this process, so the ANTLR DFA caches and the LLVM
+// target stay warm between compilations. Programs compiled with --run are
+// sent back to the client to run. Returns only on a socket error.
+int serve(const std::string& socket_path, std::ostream& err);
+
+// Sends the command line and the current directory to the server, passes
+// it this process's stdin for the source file "-", then reproduces the
+// server's output and exit code. With --run, the server only compiles the
+// program, and it runs in this process.
+int connect(
+    const std::string& socket_path,
+    const std::vector<std::string>& args);
+
+}  // namespace pascal::driver